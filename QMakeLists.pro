@@ -34,7 +34,8 @@ LIBS += \
     -lEvents \
     -lFilesystemAdapters \
     -lResources \
-    -lboost_filesystem
+    -lboost_filesystem \
+    -lsqlite3
 
 # Linux‐only OpenGL/X11 libs
 unix:!macx {
@@ -56,14 +57,34 @@ SOURCES += \
     main.cpp \
     src/game/Asteroids.cpp \
     src/game/AsteroidsConsumers.cpp \
+    src/game/BlobStore.cpp \
     src/game/Bullet.cpp \
+    src/game/CollisionKernel.cpp \
+    src/game/EntityHandle.cpp \
+    src/game/EntityStore.cpp \
+    src/game/FrameTimings.cpp \
+    src/game/InputRecording.cpp \
+    src/game/MeshRegistry.cpp \
+    src/game/ParallelFor.cpp \
+    src/game/ResourceSchema.cpp \
+    src/game/RestoreQueue.cpp \
     src/game/Rock.cpp \
+    src/game/SaveDatabase.cpp \
+    src/game/SaveJournal.cpp \
+    src/game/SaveWriter.cpp \
+    src/game/Scenario.cpp \
     src/game/Ship.cpp \
+    src/game/Simulation.cpp \
+    src/game/SnapshotPack.cpp \
+    src/game/SpatialGrid.cpp \
+    src/game/TaskScheduler.cpp \
     src/gl/GL.cpp \
     src/gl/GLBackend.cpp \
     src/gl/GLBackendEmitters.cpp \
     src/gl/GLEntity.cpp \
-    src/gl/GLEntityTask.cpp
+    src/gl/InstancedRenderer.cpp \
+    src/gl/Mat4Resource.cpp \
+    src/gl/StreamingBuffer.cpp
 
 HEADERS += \
     include/configuration/config.h \
@@ -72,12 +93,38 @@ HEADERS += \
     include/configuration/serialization.h \
     include/game/Asteroids.h \
     include/game/AsteroidsConsumers.h \
+    include/game/BlobStore.h \
     include/game/Bullet.h \
+    include/game/CollisionKernel.h \
+    include/game/CounterRng.h \
+    include/game/EntityHandle.h \
+    include/game/EntityStore.h \
+    include/game/FrameTimings.h \
+    include/game/InputRecording.h \
+    include/game/IRenderer.h \
+    include/game/MeshRegistry.h \
+    include/game/ParallelFor.h \
+    include/game/RenderSnapshot.h \
+    include/game/ResourceSchema.h \
+    include/game/RestoreQueue.h \
     include/game/Rock.h \
+    include/game/SaveDatabase.h \
+    include/game/SaveJournal.h \
+    include/game/SaveWriter.h \
+    include/game/Scenario.h \
     include/game/Ship.h \
+    include/game/Simulation.h \
+    include/game/SnapshotPack.h \
+    include/game/SpatialGrid.h \
+    include/game/TaskScheduler.h \
+    include/game/TripleBuffer.h \
     include/gl/GL.h \
     include/gl/GLBackend.h \
-    include/gl/GLBackendEmitters.h
+    include/gl/GLBackendEmitters.h \
+    include/gl/InstancedRenderer.h \
+    include/gl/Mat4.h \
+    include/gl/Mat4Resource.h \
+    include/gl/StreamingBuffer.h
 
 # Qt resource file (pulls in your QML under qml/)
 RESOURCES += \
@@ -0,0 +1,354 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include <benchmark/benchmark.h>
+
+#include "configuration/config.h"
+#include "game/Asteroids.h"
+#include "game/Bullet.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/Rock.h"
+#include "game/Scenario.h"
+#include "gl/GLEntity.h"
+
+using asteroids::Asteroids;
+using asteroids::Bullet;
+using asteroids::BulletRow;
+using asteroids::CounterRng;
+using asteroids::RockRow;
+using asteroids::Scenario;
+using asteroids::State;
+
+namespace
+{
+	const std::int64_t MIN_ENTITIES = 10;
+	const std::int64_t MAX_ENTITIES = 1000000;
+	const std::uint64_t BENCH_SEED = 1;
+
+	// every allocation of the process is counted, including those of the scheduler's workers
+	std::atomic<std::size_t> Allocations{0};
+
+	/**
+	 * @brief Report the allocations made since construction, outside of pauses, as a per-iteration average.
+	 */
+	class AllocationCounter
+	{
+	public:
+		explicit AllocationCounter(benchmark::State &state) : state_(state), start_(Allocations.load(std::memory_order_relaxed))
+		{
+		}
+
+		~AllocationCounter()
+		{
+			const std::size_t allocations = Allocations.load(std::memory_order_relaxed) - start_ - paused_;
+			state_.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+		}
+
+		void Pause()
+		{
+			state_.PauseTiming();
+			pauseStart_ = Allocations.load(std::memory_order_relaxed);
+		}
+
+		void Resume()
+		{
+			paused_ += Allocations.load(std::memory_order_relaxed) - pauseStart_;
+			state_.ResumeTiming();
+		}
+
+	private:
+		benchmark::State &state_;
+		std::size_t start_;
+		std::size_t pauseStart_{0};
+		std::size_t paused_{0};
+	};
+
+	/**
+	 * @brief A scenario of rocks of every size spread over the whole world.
+	 */
+	Scenario Spread(const size_t rocks)
+	{
+		Scenario scenario;
+		scenario.rocks = rocks;
+		scenario.sizeWeights = {1.0f, 1.0f, 1.0f};
+		scenario.radius = 0.0f;
+		scenario.clearance = 0.0f;
+		return scenario;
+	}
+}
+
+// kept out of line, so the compiler pairs its callers' deletes with it rather than with the malloc inside;
+// the default sized delete forwards to the unsized one below
+[[gnu::noinline]] void *operator new(std::size_t size)
+{
+	Allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void *memory = std::malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+// matrices are over-aligned, so entities holding them take the aligned path
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	Allocations.fetch_add(1, std::memory_order_relaxed);
+	const std::size_t bytes = static_cast<std::size_t>(alignment);
+	if (void *memory = std::aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace asteroids
+{
+	/**
+	 * @brief Drives the stages of a tick of a game one at a time.
+	 */
+	class AsteroidsBench
+	{
+	public:
+		/**
+		 * @brief Reset a game to a scenario and add bullets spread over its world.
+		 *
+		 * Bullets are at rest, so they never leave the world.
+		 */
+		static void Populate(Asteroids &game, const Scenario &scenario, const size_t bullets)
+		{
+			game.SetSeed(BENCH_SEED);
+			game.SetScenario(scenario);
+			game.ResetGame();
+
+			CounterRng rng(BENCH_SEED, scenario.rocks, bullets);
+			for (size_t bullet = 0; bullet < bullets; ++bullet)
+				AddBullet(game, rng, true);
+		}
+
+		/**
+		 * @brief Top a game up to a number of bullets spread over its world.
+		 *
+		 * The bullets are launched along the ship's heading by its next update, and the last one is fired
+		 * by the ship so that it updates its bullets at all.
+		 */
+		static void Reload(Asteroids &game, const size_t bullets, CounterRng &rng)
+		{
+			while (BulletCount(game) + 1 < bullets)
+				AddBullet(game, rng, false);
+			game.Fire();
+		}
+
+		static void UpdateRocks(Asteroids &game)
+		{
+			game.UpdateRocks();
+		}
+
+		static void UpdateShip(Asteroids &game)
+		{
+			game.UpdateShip();
+		}
+
+		static void FindCollisions(Asteroids &game)
+		{
+			game.FindCollisions();
+		}
+
+		/**
+		 * @brief Break the first rock and destroy the two rocks it broke into.
+		 */
+		static void BreakRock(Asteroids &game)
+		{
+			game.BreakRock(0);
+			game.DestroyRock(game.store_.Rocks().Size() - 1);
+			game.DestroyRock(game.store_.Rocks().Size() - 1);
+		}
+
+		static RockRow MakeRock(Asteroids &game, const size_t rock, CounterRng &rng)
+		{
+			return game.MakeRock(State::MEDIUM, game.store_.Rocks().Get(rock), true, true, rng);
+		}
+
+		static size_t RockCount(Asteroids &game)
+		{
+			return game.store_.Rocks().Size();
+		}
+
+		static size_t BulletCount(Asteroids &game)
+		{
+			return game.store_.Bullets().Size();
+		}
+
+		static void ClearBullets(Asteroids &game)
+		{
+			game.ClearBullets();
+		}
+
+	private:
+		static void AddBullet(Asteroids &game, CounterRng &rng, const bool atRest)
+		{
+			auto Coordinate = [&rng](const GLfloat extent)
+			{ return (static_cast<GLfloat>(rng.Unit()) * 2.0f - 1.0f) * extent; };
+
+			BulletRow row = Bullet::NewRow(Coordinate(game.bounds_.right), Coordinate(game.bounds_.top));
+			row.initialized = atRest;
+			game.CreateBullet(row);
+		}
+	};
+} // end namespace asteroids
+
+using asteroids::AsteroidsBench;
+
+namespace
+{
+	void BM_UpdateRocks(benchmark::State &state)
+	{
+		const size_t rocks = static_cast<size_t>(state.range(0));
+		Asteroids game;
+		AsteroidsBench::Populate(game, Spread(rocks), 0);
+
+		AllocationCounter counter(state);
+		for (auto _ : state)
+		{
+			AsteroidsBench::UpdateRocks(game);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	void BM_UpdateShip(benchmark::State &state)
+	{
+		// bullets fly off through the ship's own update and expire, so they are topped up once half are gone
+		const size_t bullets = static_cast<size_t>(state.range(0));
+		Scenario scenario = Spread(0);
+		scenario.maxBullets = bullets;
+		Asteroids game;
+		AsteroidsBench::Populate(game, scenario, 0);
+		CounterRng rng(BENCH_SEED, 0, bullets);
+		AsteroidsBench::Reload(game, bullets, rng);
+
+		AllocationCounter counter(state);
+		std::int64_t updated = 0;
+		for (auto _ : state)
+		{
+			if (AsteroidsBench::BulletCount(game) * 2 < bullets)
+			{
+				counter.Pause();
+				AsteroidsBench::Reload(game, bullets, rng);
+				counter.Resume();
+			}
+			updated += static_cast<std::int64_t>(AsteroidsBench::BulletCount(game));
+			AsteroidsBench::UpdateShip(game);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(updated);
+	}
+
+	void BM_FindCollisions(benchmark::State &state)
+	{
+		// as many bullets as rocks, so both the grid build and the queries scale
+		const size_t entities = static_cast<size_t>(state.range(0));
+		Asteroids game;
+		AsteroidsBench::Populate(game, Spread(entities), entities);
+
+		AllocationCounter counter(state);
+		for (auto _ : state)
+		{
+			AsteroidsBench::FindCollisions(game);
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+	}
+
+	void BM_BreakRock(benchmark::State &state)
+	{
+		// the first rock must be large to break into two
+		Scenario scenario = Spread(static_cast<size_t>(state.range(0)));
+		scenario.sizeWeights = {1.0f, 0.0f, 0.0f};
+		Asteroids game;
+		AsteroidsBench::Populate(game, scenario, 0);
+
+		AllocationCounter counter(state);
+		for (auto _ : state)
+			AsteroidsBench::BreakRock(game);
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_MakeRock(benchmark::State &state)
+	{
+		// rocks are made from each rock of the world in turn, so larger worlds miss the cache
+		Asteroids game;
+		AsteroidsBench::Populate(game, Spread(static_cast<size_t>(state.range(0))), 0);
+		const size_t rocks = AsteroidsBench::RockCount(game);
+		CounterRng rng(BENCH_SEED, 0, 0);
+
+		AllocationCounter counter(state);
+		size_t rock = 0;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(AsteroidsBench::MakeRock(game, rock, rng));
+			rock = rock + 1 < rocks ? rock + 1 : 0;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_Fire(benchmark::State &state)
+	{
+		// the ship holds at most the scenario's bullets, so it fires until full and starts over
+		Scenario scenario = Spread(0);
+		scenario.maxBullets = static_cast<size_t>(state.range(0));
+		Asteroids game;
+		AsteroidsBench::Populate(game, scenario, 0);
+
+		AllocationCounter counter(state);
+		for (auto _ : state)
+		{
+			game.Fire();
+			if (AsteroidsBench::BulletCount(game) >= scenario.maxBullets)
+				AsteroidsBench::ClearBullets(game);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_ResetGame(benchmark::State &state)
+	{
+		// a reset clears the world it replaces and generates the scenario's rocks in its place
+		const Scenario scenario = Spread(static_cast<size_t>(state.range(0)));
+		Asteroids game;
+
+		AllocationCounter counter(state);
+		for (auto _ : state)
+		{
+			counter.Pause();
+			AsteroidsBench::Populate(game, scenario, scenario.rocks);
+			counter.Resume();
+			game.ResetGame();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+	}
+}
+
+BENCHMARK(BM_UpdateRocks)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES)->UseRealTime();
+BENCHMARK(BM_UpdateShip)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES)->UseRealTime();
+BENCHMARK(BM_FindCollisions)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES)->UseRealTime();
+BENCHMARK(BM_BreakRock)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES);
+BENCHMARK(BM_MakeRock)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES);
+BENCHMARK(BM_Fire)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES);
+BENCHMARK(BM_ResetGame)->RangeMultiplier(10)->Range(MIN_ENTITIES, MAX_ENTITIES);
+
+BENCHMARK_MAIN();
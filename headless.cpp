@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "configuration/config.h"
+#include "game/Asteroids.h"
+#include "game/FrameTimings.h"
+#include "game/Scenario.h"
+
+using asteroids::Asteroids;
+using asteroids::FrameTimings;
+using asteroids::Scenario;
+using asteroids::StageTiming;
+using asteroids::TimedStage;
+
+namespace
+{
+	const std::string FRAMES_ARG = "--frames";
+	const std::string DT_ARG = "--dt";
+	const std::string SCENARIO_ARG = "--scenario";
+	const long DEFAULT_FRAMES = 3000;
+
+	void PrintUsage(const char *program)
+	{
+		std::cerr << "usage: " << program << " [" << FRAMES_ARG << " N] [" << DT_ARG << " SECONDS] [" << SCENARIO_ARG << " SPEC]" << std::endl;
+	}
+}
+
+int main(int _argc, char *_argv[])
+{
+	long frames = DEFAULT_FRAMES;
+	GLfloat dt = Asteroids::TickSeconds();
+	std::optional<Scenario> scenario = Scenario();
+
+	for (int i = 1; i < _argc; ++i)
+	{
+		const std::string arg = _argv[i];
+		if (arg == FRAMES_ARG && i + 1 < _argc)
+			frames = std::strtol(_argv[++i], nullptr, 10);
+		else if (arg == DT_ARG && i + 1 < _argc)
+			dt = std::strtof(_argv[++i], nullptr);
+		else if (arg == SCENARIO_ARG && i + 1 < _argc)
+			scenario = Scenario::Parse(_argv[++i]);
+		else
+		{
+			PrintUsage(_argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (frames <= 0 || dt <= 0.0f || !scenario)
+	{
+		PrintUsage(_argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// no GL context exists in this process; the game only ever advances through Step
+	auto game = std::make_shared<Asteroids>();
+	game->SetScenario(*scenario);
+	game->ResetGame();
+
+	long ticks = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (long frame = 0; frame < frames; ++frame)
+		ticks += game->Step(dt);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "frames: " << frames << std::endl;
+	std::cout << "ticks: " << ticks << std::endl;
+	std::cout << "seconds: " << elapsed.count() << std::endl;
+	std::cout << "ticks/s: " << (elapsed.count() > 0.0 ? ticks / elapsed.count() : 0.0) << std::endl;
+	std::cout << "score: " << game->GetScore() << std::endl;
+
+	// percentiles of the most recent ticks of each stage which ran
+	for (size_t stage = 0; stage < static_cast<size_t>(TimedStage::COUNT); ++stage)
+	{
+		const StageTiming timing = FrameTimings::GetInstance()->Summarize(static_cast<TimedStage>(stage));
+		if (timing.samples == 0)
+			continue;
+		const std::string_view name = FrameTimings::Name(static_cast<TimedStage>(stage));
+		std::cout << name << " ms: p50 " << timing.p50 << " p95 " << timing.p95 << " p99 " << timing.p99 << " max " << timing.max << std::endl;
+	}
+
+	return EXIT_SUCCESS;
+}
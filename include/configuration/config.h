@@ -23,10 +23,14 @@
 #define USERS_PATH "/users"
 
 #define SAVE_TO_DB
+// save to a single binary pack instead of JSON files or the database
+// #define SAVE_TO_PACK
 
 #define WIN_WIDTH (600)
 #define WIN_HEIGHT (480)
 #define INIT_WIN_X (100)
 #define INIT_WIN_Y (100)
 
+#define FRAME_MS (20)
+
 #endif // end config_h
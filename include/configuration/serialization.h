@@ -9,12 +9,14 @@ namespace
 {
 	const std::string DB_NAME = "asteroids.sqlite";
 	const std::string JSON_NAME = "asteroids.json";
+	const std::string PACK_NAME = "asteroids.pack";
 #ifdef _WIN32
 	const Path ROOT_PATH = Path(std::getenv("USERPROFILE")) / "downloads";
 #else
 	const Path ROOT_PATH = Path(std::getenv("HOME")) / "Downloads";
 #endif
 	const Path SERIALIZATION_PATH = ROOT_PATH / JSON_NAME;
+	const Path PACK_PATH = ROOT_PATH / PACK_NAME;
 
 	std::string FormatKey(const std::string &key)
 	{
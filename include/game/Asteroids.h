@@ -6,20 +6,29 @@
 #ifndef asteroids_asteroids_h
 #define asteroids_asteroids_h
 
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <boost/property_tree/ptree.hpp>
 
 #include "Events/EventConsumer.h"
 #include "configuration/config.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/RenderSnapshot.h"
 #include "game/Rock.h"
+#include "game/SaveWriter.h"
+#include "game/Scenario.h"
 #include "game/Ship.h"
+#include "game/SpatialGrid.h"
+#include "game/TaskScheduler.h"
 #include "gl/GLEntity.h"
 
 namespace database_adapters
@@ -84,10 +93,50 @@ namespace asteroids
         void Load(boost::property_tree::ptree &tree, database_adapters::Sqlite &database) override;
 
         /**
-         * @brief Render the game entities.
+         * @brief Does nothing. The game is advanced by Step and drawn from its snapshots by a renderer.
          */
         void Draw() override;
 
+        /**
+         * @brief Advance the simulation on the CPU without touching the graphics library.
+         *
+         * Elapsed time is accumulated and consumed in fixed ticks of TickSeconds(), so
+         * any remainder carries over into the next call.
+         * @param dt The elapsed time in seconds.
+         * @return The number of ticks advanced.
+         */
+        GLint Step(const GLfloat dt);
+
+        /**
+         * @brief Get the duration of one fixed simulation tick.
+         * @return The tick duration in seconds.
+         */
+        static GLfloat TickSeconds();
+
+        /**
+         * @brief Get the current score.
+         * @return The score.
+         */
+        GLint GetScore() const;
+
+        /**
+         * @brief Set the world bounds the entities move and wrap around in.
+         * @param bounds The world bounds.
+         */
+        void SetBounds(const WorldBounds &bounds);
+
+        /**
+         * @brief Copy the drawable state of the game into a snapshot.
+         * @param snapshot The snapshot to fill. Its buffers are reused.
+         */
+        void Snapshot(RenderSnapshot &snapshot) const;
+
+        /**
+         * @brief Draw a snapshot of the game.
+         * @param snapshot The snapshot to draw.
+         */
+        static void DrawSnapshot(const RenderSnapshot &snapshot);
+
         /**
          * @brief Fire a bullet from the ship.
          */
@@ -113,13 +162,25 @@ namespace asteroids
          */
         void ResetGame();
 
+        /**
+         * @brief Seed the random numbers of the game. Sessions with the same seed and input play out the same.
+         * @param seed The seed, taking effect from the next draw.
+         */
+        void SetSeed(const std::uint64_t seed);
+
+        /**
+         * @brief Set the scenario the game is reset to and runs under.
+         * @param scenario The scenario, taking effect from the next reset.
+         */
+        void SetScenario(const Scenario &scenario);
+
         /**
          * @brief Start the game loop.
          */
         void Run();
 
         /**
-         * @brief Serialize the game state.
+         * @brief Request a save of the game state. The state is captured now and written on the save writer thread.
          */
         void Serialize();
 
@@ -129,11 +190,8 @@ namespace asteroids
         void Deserialize();
 
     private:
-        /**
-         * @brief Generate a UUID.
-         * @return A UUID.
-         */
-        std::string GenerateUUID() const;
+        // the benchmarks drive the stages of a tick one at a time
+        friend class AsteroidsBench;
 
         /**
          * @brief Get the aggregated ship entity.
@@ -155,51 +213,95 @@ namespace asteroids
         std::vector<Key> GetRockKeys() const;
 
         /**
-         * @brief Add out of scope bullet keys to the entity removal list.
+         * @brief Clear or reset the game.
          */
-        void AddOutOfScopeBulletsToRemovalKeys();
+        void ClearGame();
 
         /**
-         * @brief Clear unused serialization keys.
+         * @brief Clear the rock entities.
          */
-        void ClearUnusedSerializationKeys();
+        void ClearRocks();
 
         /**
-         * @brief Clear unused loading keys.
+         * @brief Clear the bullet entities.
          */
-        void ClearUnusedPersistenceKeys();
+        void ClearBullets();
 
         /**
-         * @brief Clear or reset the game.
+         * @brief Clear the ship entities.
          */
-        void ClearGame();
+        void ClearShip();
 
         /**
-         * @brief Clear the rock entities.
+         * @brief Derive the keys of the persisted entities destroyed since the last call, forget them in the save journal and tombstone them.
          */
-        void ClearRocks();
+        void ForgetRemovedEntities();
 
         /**
-         * @brief Clear the bullet entities.
+         * @brief Record the live rocks and bullets as persisted, after they were saved or loaded.
          */
-        void ClearBullets();
+        void MarkSaved();
 
         /**
-         * @brief Clear the ship entities.
+         * @brief Move the loaded rocks and bullets into the entity store and drop the aggregated entities.
          */
-        void ClearShip();
+        void AdoptLoadedEntities();
+
+        /**
+         * @brief Decode the matrices of the loaded entities and adopt them, or reset the game if any matrix is missing.
+         */
+        void FinishLoad();
+
+        /**
+         * @brief Replace the game state with the snapshot pack, if a valid one exists.
+         */
+        void LoadPack();
+
+        /**
+         * @brief Capture the game state and hand it to the save writer, or keep the request if a save is still being written.
+         */
+        void SubmitSave();
+
+        /**
+         * @brief Apply the bookkeeping of the last save handed to the writer, once the writer reports it was written.
+         *
+         * A save which failed leaves its swept keys to be removed and the compaction due.
+         */
+        void FinishSave();
+
+        /**
+         * @brief Finish the save being written and any request kept behind it.
+         */
+        void FlushSave();
+
+        /**
+         * @brief Add a Rock to the game.
+         * @param rock The rock state, with its velocity initialized.
+         */
+        void CreateRock(const RockRow &rock);
 
         /**
-         * @brief Destroy or remove the Rock entity from the game.
-         * @param rock The Rock entity.
+         * @brief Add a Bullet to the game under a new handle.
+         * @param bullet The bullet state.
          */
-        void DestroyRock(std::shared_ptr<Rock> rock);
+        void CreateBullet(const BulletRow &bullet);
 
         /**
-         * @brief Destroy or remove the Bullet entity from the game.
-         * @param rock The Bullet entity.
+         * @brief Destroy or remove the Rock from the game.
+         * @param row The row of the Rock in the entity store.
          */
-        void DestroyBullet(std::shared_ptr<Bullet> bullet);
+        void DestroyRock(const size_t row);
+
+        /**
+         * @brief Destroy or remove the Bullet from the game.
+         * @param row The row of the Bullet in the entity store.
+         */
+        void DestroyBullet(const size_t row);
+
+        /**
+         * @brief Destroy the bullets which left the world bounds during the last time step.
+         */
+        void ExpireBullets();
 
         /**
          * @brief Get the list of keys to serialize on game save.
@@ -215,87 +317,94 @@ namespace asteroids
 
         /**
          * @brief Split a rock into more smaller rocks.
-         * @param rock The Rock entity to split.
+         * @param row The row of the Rock to split.
          */
-        void BreakRock(std::shared_ptr<Rock> rock);
+        void BreakRock(const size_t row);
 
         /**
          * @brief Verify if the game has rocks.
          * @return true if the game has Rock entities; false otherwise.
          */
-        bool HasRocks();
+        bool HasRocks() const;
 
         /**
-         * @brief Verify if the game has a Rock entity with the given key.
-         * @param key Of the Rock entity.
-         * @return true if the game has a Rock with the given key; false otherwise.
-         */
-        bool HasRock(const std::string_view key) const;
-
-        /**
-         * @brief Make a Rock entity.
-         * @param rockSize The size of the Rock entity.
-         * @param rock The Rock entity.
+         * @brief Make a Rock.
+         * @param rockSize The size of the Rock.
+         * @param rock The Rock being split.
          * @param halfMass The mass of the Rock.
          * @param clockwise true if clockwise spinning; false if counter clockwise.
-         * @return smart pointer to a Rock entity.
+         * @param rng The stream of the Rock being split.
+         * @return The state of the new Rock.
          */
-        std::shared_ptr<Rock> MakeRock(const State rockSize, std::shared_ptr<Rock> rock, const bool halfMass, const bool clockwise);
+        RockRow MakeRock(const State rockSize, const RockRow &rock, const bool halfMass, const bool clockwise, CounterRng &rng);
 
         /**
          * @brief Set the Rock's physics based on a collision with a Bullet.
-         * @param ithBullet The ith bullet in the collision.
-         * @param rock The Rock entity.
+         * @param bullet The row of the Bullet in the collision.
+         * @param rock The row of the Rock in the collision.
          */
-        void CalculateConservationOfMomentum(std::shared_ptr<Bullet> _ithBullet, std::shared_ptr<Rock> rock);
+        void CalculateConservationOfMomentum(const size_t bullet, const size_t rock);
 
         /**
-         * @brief Check for collisions between bullets and rocks, and between rocks and the ship.
+         * @brief Find the Rocks hit by Bullets in the current time step.
          */
-        void DetermineCollisions();
+        void FindCollisions();
 
         /**
-         * @brief Get the Rock which collided with the Ship.
-         * @return A Rock if there's a collision; nullptr otherwise.
+         * @brief Resolve the found collisions and reset the game if the Ship collided or no Rocks are left.
          */
-        std::shared_ptr<Rock> ShipCollision();
+        void ApplyCollisions();
+
+        /**
+         * @brief Verify if a Rock collided with the Ship.
+         * @return true if there's a collision; false otherwise.
+         */
+        bool ShipCollision() const;
 
         /**
          * @brief Get the Rock which collided with the given Bullet.
-         * @param bullet The Bullet entity.
-         * @return A Rock if there's a collision; nullptr otherwise.
+         * @param bullet The row of the Bullet.
+         * @return The row of a Rock if there's a collision; std::nullopt otherwise.
+         */
+        std::optional<size_t> Collision(const size_t bullet) const;
+
+        /**
+         * @brief Break or destroy the collided Rocks and destroy the Bullets which hit them.
+         * @param collisions Pairs of collided Rock and Bullet rows.
          */
-        std::shared_ptr<Rock> Collision(std::shared_ptr<Bullet> bullet);
+        void ResolveCollisions(std::vector<std::pair<size_t, size_t>> &collisions);
 
         /**
-         * @brief Process the collision by breaking or destroying the Rock and Bullet.
-         * @param bullet The Bullet entity.
-         * @param rockKey The key of the Rock entity.
+         * @brief Process the collision by breaking or destroying the Rock.
+         * @param bullet The row of the Bullet.
+         * @param rock The row of the Rock.
          */
-        void ProcessCollision(std::shared_ptr<Bullet> bullet, const std::string_view rockKey);
+        void ProcessCollision(const size_t bullet, const size_t rock);
 
         /**
-         * @brief Update the Rock per time step.
-         * @param sharedRock The Rock entity.
+         * @brief Add the stages of a time step to the tick graph: update, then collide, then resolve.
          */
-        void UpdateRockTask(std::shared_ptr<GLEntity> sharedRock);
+        void BuildTickGraph();
 
         /**
-         * @brief Update the Ship per time step.
-         * @param sharedShip The Ship entity.
-         * @param futures The datastructure tracking the futures used in parallel computing of bullet, rock, and ship collisions.
+         * @brief Spin and move the rocks per time step.
          */
-        void UpdateShipTask(std::shared_ptr<GLEntity> sharedShip, std::vector<std::future<std::shared_ptr<GLEntity>>> &futures);
+        void UpdateRocks();
 
         /**
-         * @brief Draw the game entities.
+         * @brief Expire bullets, then move the ship and its bullets per time step.
          */
-        void DrawGLEntities();
+        void UpdateShip();
 
         /**
-         * @brief Draw the game information in the UI.
+         * @brief Spawn the rock waves and fire the bullets the scenario calls for in the current time step.
          */
-        void DrawGameInfo();
+        void RunScenario();
+
+        /**
+         * @brief Advance the simulation by one fixed time step.
+         */
+        void Tick();
 
         /**
          * @brief Reset the thrust and rotation variables after user input or game reset.
@@ -304,14 +413,37 @@ namespace asteroids
 
         std::set<std::string, std::less<>> keysToRemove_;
         std::set<std::string, std::less<>> keysSerialized_;
+        std::unordered_set<std::uint64_t> savedRocks_;   /**< Handles of the persisted rocks which are still live. */
+        std::unordered_set<std::uint64_t> savedBullets_; /**< Handles of the persisted bullets which are still live. */
+        std::vector<EntityHandle> removedRocks_;         /**< Persisted rocks destroyed since their keys were last derived. */
+        std::vector<EntityHandle> removedBullets_;       /**< Persisted bullets destroyed since their keys were last derived. */
+        std::set<std::string, std::less<>> keysSaving_;   /**< Keys of the entities in the save being written. */
+        std::set<std::string, std::less<>> keysSweeping_; /**< Removed keys swept by the save being written. */
+        bool compacting_{false};         /**< Set if the save being written is a compaction. */
+        size_t savesSinceCompaction_{0}; /**< Saves since removed entities were last swept. */
+        bool saveRequested_{false};      /**< Set while a save request waits for the writer. */
 
         GLint score_{0};
         GLint rockCount_{0};
         GLfloat orientationAngle_{0.0f};
         GLfloat thrust_{0.0f};
-
-        boost::asio::thread_pool threadPool_;
-        std::mutex rockCollisionMutex_;
+        GLfloat stepAccumulator_{0.0f};
+        std::uint64_t tickCount_{0};
+        std::uint64_t seed_{CounterRng::DEFAULT_SEED}; /**< Seed every random number of the game is drawn from. */
+        std::uint64_t resetTick_{0};                   /**< Tick the game was last reset on. */
+        GLfloat fireAccumulator_{0.0f};                /**< Bullets the scenario is owed since the last one it fired. */
+        Scenario scenario_;                            /**< Scenario the game is reset to and runs under. */
+
+        WorldBounds bounds_;
+        EntityStore store_;
+        SpatialGrid rockGrid_;
+        std::vector<std::optional<size_t>> bulletHits_;           /**< Rock hit by each bullet row in the current time step. */
+        std::vector<std::pair<size_t, size_t>> collisions_;       /**< Rock and bullet rows which collided in the current time step. */
+
+        TaskGraph tickGraph_;
+        TaskScheduler scheduler_;
+
+        SaveWriter saveWriter_; /**< Writes saves off the simulation thread. */
     };
 
 } // end namespace asteroids
@@ -10,9 +10,11 @@
 #include <memory>
 
 #include "Entities/Entity.h"
+#include "Events/EventChannel.h"
 #include "Events/EventConsumer.h"
 #include "configuration/config.h"
-#include "game/Asteroids.h"
+#include "game/Simulation.h"
+#include "gl/GLBackendEmitters.h"
 
 namespace asteroids
 {
@@ -22,16 +24,16 @@ namespace asteroids
      * @brief A class that manages event consumers for various actions in the Asteroids game.
      *
      * This class provides mechanisms to handle events triggered by user input and other actions,
-     * allowing the game instance to respond accordingly.
+     * queuing them as commands for the simulation thread and drawing its latest snapshot.
      */
     class ASTEROIDS_DLL_EXPORT AsteroidsConsumers : public entity::Entity
     {
     public:
         /**
-         * @brief Constructs a AsteroidsConsumers object with a given Asteroids instance.
-         * @param asteroids A shared pointer to the Asteroids instance.
+         * @brief Constructs a AsteroidsConsumers object with a given Simulation instance.
+         * @param simulation A shared pointer to the Simulation running the game.
          */
-        AsteroidsConsumers(std::shared_ptr<Asteroids> asteroids);
+        AsteroidsConsumers(std::shared_ptr<Simulation> simulation);
 
         /**
          * @brief Destructor for AsteroidsConsumers.
@@ -109,6 +111,17 @@ namespace asteroids
         std::shared_ptr<events::EventConsumer<void()>> drawConsumer_;
     };
 
+    /**
+     * @brief Connect every input emitter to the consumer of its action.
+     *
+     * The front end and the replay of a recorded session connect the same way, so replayed input takes
+     * the path live input does.
+     * @param frontend The consumers.
+     * @param emitters The emitters.
+     * @param channel The channel connecting them.
+     */
+    ASTEROIDS_DLL_EXPORT void RegisterEvents(AsteroidsConsumers &frontend, GLBackendEmitters &emitters, events::EventChannel &channel);
+
 } // end namespace asteroids
 
 #endif // asteroids_asteroids_consumers_h
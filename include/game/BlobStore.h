@@ -0,0 +1,226 @@
+/**
+ * @file BlobStore.h
+ * @brief Declaration of the BlobStore which saves immutable resources once per unique payload.
+ */
+
+#ifndef asteroids_blob_store_h
+#define asteroids_blob_store_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "DatabaseAdapters/IPersistableResource.h"
+#include "DatabaseAdapters/ResourceLoader.h"
+#include "DatabaseAdapters/ResourcePersister.h"
+#include "FilesystemAdapters/ISerializableResource.h"
+#include "FilesystemAdapters/ResourceDeserializer.h"
+#include "FilesystemAdapters/ResourceSerializer.h"
+#include "test_filesystem_adapters/ContainerResource.h"
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+#include "configuration/config.h"
+#include "gl/Mat4Resource.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class BlobStore
+     * @brief A content-addressed store for resources which many entities share, such as meshes.
+     *
+     * A resource is keyed by the FNV-1a digest of its shape and payload. Each unique blob is written once, to a
+     * shared folder or under its own database key, and entities store the blob key in place of a copy.
+     * Loaded blobs are decoded once and shared by every entity which references them.
+     */
+    class ASTEROIDS_DLL_EXPORT BlobStore
+    {
+    public:
+        using Digest = uint64_t;
+
+        /**
+         * @brief Get the store.
+         * @return The store.
+         */
+        static BlobStore *GetInstance();
+
+        /**
+         * @brief Hash bytes with 64-bit FNV-1a.
+         * @param data The bytes.
+         * @param bytes The number of bytes.
+         * @param digest The digest to continue from.
+         * @return The digest.
+         */
+        static Digest Hash(const void *data, const size_t bytes, Digest digest = FNV_OFFSET_BASIS);
+
+        /**
+         * @brief Hash the shape and payload of a resource.
+         * @param resource The resource.
+         * @return The digest.
+         */
+        template <typename T>
+        static Digest Hash(const ContainerResource<T> &resource);
+
+        /**
+         * @brief Hash the shape and payload of a 2D resource.
+         * @param resource The resource.
+         * @return The digest.
+         */
+        template <typename T>
+        static Digest Hash(const ContainerResource2D<T> &resource);
+
+        /**
+         * @brief Hash the matrix of a matrix resource.
+         * @param resource The resource.
+         * @return The digest.
+         */
+        static Digest Hash(const Mat4Resource &resource);
+
+        /**
+         * @brief Derive the key a blob is stored under from its digest.
+         * @param digest The digest.
+         * @return The blob key.
+         */
+        static std::string BlobKey(const Digest digest);
+
+        /**
+         * @brief Get the folder the serialized blobs are written to.
+         * @return The folder.
+         */
+        static std::string BlobPath();
+
+        /**
+         * @brief Create the blob folder if a save is about to write to it.
+         */
+        void BeginSave();
+
+        /**
+         * @brief Forget which blobs were written, so the next save writes each of its blobs again.
+         */
+        void Reset();
+
+        /**
+         * @brief Drop the blobs decoded by an earlier load.
+         */
+        void BeginLoad();
+
+        /**
+         * @brief Serialize a resource to the blob folder unless it was already written.
+         * @param resource The resource.
+         * @return The blob key to store with the entity.
+         */
+        template <typename Resource>
+        std::string Serialize(const Resource &resource);
+
+        /**
+         * @brief Persist a resource to the open database unless it was already written.
+         * @param resource The resource.
+         * @return The blob key to store with the entity.
+         */
+        template <typename Resource>
+        std::string Persist(const Resource &resource);
+
+        /**
+         * @brief Deserialize a blob from the blob folder, or reuse it if it was already decoded.
+         * @param blobKey The blob key stored with the entity.
+         * @return The resource.
+         */
+        template <typename T, typename Resource>
+        const Resource &Deserialize(const std::string &blobKey);
+
+        /**
+         * @brief Load a blob from the open database, or reuse it if it was already decoded.
+         * @param blobKey The blob key stored with the entity.
+         * @return The resource.
+         */
+        template <typename T, typename Resource>
+        const Resource &Load(const std::string &blobKey);
+
+    private:
+        static constexpr Digest FNV_OFFSET_BASIS = 14695981039346656037ull;
+        static constexpr Digest FNV_PRIME = 1099511628211ull;
+
+        BlobStore() = default;
+
+        /**
+         * @brief Record that a blob is written.
+         * @param blobKey The blob key.
+         * @return true if the blob was not written yet; false otherwise.
+         */
+        bool MarkWritten(const std::string &blobKey);
+
+        std::set<std::string, std::less<>> written_;                                                           /**< Blobs written since the last reset. */
+        std::map<std::string, std::unique_ptr<filesystem_adapters::ISerializableResource>, std::less<>> deserialized_; /**< Blobs decoded from files. */
+        std::map<std::string, std::unique_ptr<database_adapters::IPersistableResource>, std::less<>> loaded_;          /**< Blobs decoded from the database. */
+    };
+
+    template <typename T>
+    BlobStore::Digest BlobStore::Hash(const ContainerResource<T> &resource)
+    {
+        const size_t columns = resource.GetColumnSize();
+        return Hash(resource.Data(), columns * sizeof(T), Hash(&columns, sizeof(columns)));
+    }
+
+    template <typename T>
+    BlobStore::Digest BlobStore::Hash(const ContainerResource2D<T> &resource)
+    {
+        const size_t shape[] = {resource.GetRowSize(), resource.GetColumnSize()};
+        return Hash(resource.Data(), shape[0] * shape[1] * sizeof(T), Hash(shape, sizeof(shape)));
+    }
+
+    template <typename Resource>
+    std::string BlobStore::Serialize(const Resource &resource)
+    {
+        std::string blobKey = BlobKey(Hash(resource));
+        if (MarkWritten(blobKey))
+            filesystem_adapters::ResourceSerializer::GetInstance()->Serialize(resource.Lock(), blobKey, BlobPath());
+        return blobKey;
+    }
+
+    template <typename Resource>
+    std::string BlobStore::Persist(const Resource &resource)
+    {
+        std::string blobKey = BlobKey(Hash(resource));
+        if (MarkWritten(blobKey))
+            database_adapters::ResourcePersister::GetInstance()->Persist(resource, blobKey);
+        return blobKey;
+    }
+
+    template <typename T, typename Resource>
+    const Resource &BlobStore::Deserialize(const std::string &blobKey)
+    {
+        auto iter = deserialized_.find(blobKey);
+        if (iter == deserialized_.end())
+        {
+            filesystem_adapters::ResourceDeserializer *const deserializer = filesystem_adapters::ResourceDeserializer::GetInstance();
+            if (!deserializer->HasSerializationKey(blobKey))
+                deserializer->RegisterResource<T>(blobKey, []() -> std::unique_ptr<filesystem_adapters::ISerializableResource>
+                                                  { return std::make_unique<Resource>(); });
+            iter = deserialized_.emplace(blobKey, deserializer->Deserialize(blobKey, BlobPath())).first;
+        }
+        return *static_cast<const Resource *>(iter->second.get());
+    }
+
+    template <typename T, typename Resource>
+    const Resource &BlobStore::Load(const std::string &blobKey)
+    {
+        auto iter = loaded_.find(blobKey);
+        if (iter == loaded_.end())
+        {
+            database_adapters::ResourceLoader *const loader = database_adapters::ResourceLoader::GetInstance();
+            if (!loader->HasPersistenceKey(blobKey))
+                loader->RegisterResource<T>(blobKey, []() -> std::unique_ptr<database_adapters::IPersistableResource>
+                                            { return std::make_unique<Resource>(); });
+            iter = loaded_.emplace(blobKey, loader->Load(blobKey)).first;
+        }
+        return *static_cast<const Resource *>(iter->second.get());
+    }
+
+} // end namespace asteroids
+
+#endif // asteroids_blob_store_h
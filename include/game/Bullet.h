@@ -16,6 +16,8 @@
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/config.h"
+#include "game/EntityStore.h"
+#include "game/RenderSnapshot.h"
 #include "gl/GLEntity.h"
 
 namespace database_adapters
@@ -51,6 +53,13 @@ namespace asteroids
          */
         Bullet(const GLfloat _x, const GLfloat _y);
 
+        /**
+         * @brief Constructor materializing a bullet from its row in the entity store.
+         * @param row The bullet state.
+         * @param bounds The world bounds the bullet is tested against.
+         */
+        Bullet(const BulletRow &row, const WorldBounds &bounds);
+
         /**
          * @brief Destructor for the Bullet class.
          */
@@ -83,28 +92,35 @@ namespace asteroids
         Bullet &operator=(Bullet &&other) noexcept;
 
         /**
-         * @brief Register serialization resources for the bullet.
-         * @param key The serialization key.
-         */
-        static void RegisterSerializationResources(const std::string_view key);
-
-        /**
-         * @brief Register loading resources for the bullet.
-         * @param key The loading key.
+         * @brief Make the row of a newly fired bullet.
+         * @param _x Initial x-coordinate.
+         * @param _y Initial y-coordinate.
+         * @return The bullet state.
          */
-        static void RegisterPersistenceResources(const std::string_view key);
+        static BulletRow NewRow(const GLfloat _x, const GLfloat _y);
 
         /**
-         * @brief Update the bullet's position based on velocity and speed.
-         * @param _velocityAngle The angle of movement.
-         * @param _speed The speed of the bullet.
+         * @brief Move a range of bullets and flag those which left the world bounds.
+         * @param bullets The bullet columns.
+         * @param begin The first row to update.
+         * @param end One past the last row to update.
+         * @param _velocityAngle The angle of movement given to bullets which have not started moving yet.
+         * @param _speed The speed added to bullets which have not started moving yet.
+         * @param bounds The world bounds outside of which bullets expire.
          */
-        void Update(const GLfloat _velocityAngle, const GLfloat _speed);
+        static void UpdateBullets(
+            BulletArchetype &bullets,
+            const size_t begin,
+            const size_t end,
+            const GLfloat _velocityAngle,
+            const GLfloat _speed,
+            const WorldBounds &bounds);
 
         /**
-         * @brief Draw the bullet.
+         * @brief Draw the bullets of a snapshot.
+         * @param snapshot The snapshot to draw.
          */
-        void Draw() override;
+        static void DrawBullets(const RenderSnapshot &snapshot);
 
         /**
          * @brief Check if the bullet is out of bounds.
@@ -112,6 +128,12 @@ namespace asteroids
          */
         bool IsOutOfBounds() const;
 
+        /**
+         * @brief Gather the state of this bullet into a row for the entity store.
+         * @return The bullet state. The handle is parsed from the key and is null for keys which were not derived from one.
+         */
+        BulletRow ToRow();
+
         /**
          * @brief Save the entity data to a property tree.
          * @param tree The property tree to save data into.
@@ -146,34 +168,17 @@ namespace asteroids
          */
         static std::string BulletPrefix();
 
-    private:
-        /**
-         * @brief Initialize the bullet with velocity and speed.
-         * @param _velocityAngle The angle of movement.
-         * @param _speed The speed of the bullet.
-         */
-        void InitializeBullet(const GLfloat _velocityAngle, const GLfloat _speed);
-
         /**
-         * @brief Set the scale transformation matrix for the bullet.
+         * @brief Derive the persistence key of a bullet from its handle.
+         * @param handle The handle of the bullet.
+         * @return The bullet key.
          */
-        void SetSMatrix();
-
-        /**
-         * @brief Set the translation transformation matrix for the bullet.
-         */
-        void SetTMatrix();
-
-        /**
-         * @brief Mark the bullet as out of bounds.
-         */
-        void SetBulletOutOfBounds();
+        static std::string BulletKey(const EntityHandle handle);
 
+    private:
         bool bulletInitialized_ = false; /**< Indicates whether the bullet has been initialized. */
         bool outOfBounds_ = false;       /**< Flag indicating if the bullet is out of bounds. */
 
-        Resource2DGLfloat bulletVertices_;   /**< Vertex data for the bullet. */
-        ResourceGLubyte bulletIndices_;      /**< Index data for the bullet rendering. */
         Resource2DGLfloat projectionMatrix_; /**< Projection matrix for the bullet rendering. */
     };
 
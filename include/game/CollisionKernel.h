@@ -0,0 +1,94 @@
+/**
+ * @file CollisionKernel.h
+ * @brief Declaration of the batched circle tests used by the collision narrowphase.
+ */
+
+#ifndef asteroids_collision_kernel_h
+#define asteroids_collision_kernel_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "configuration/config.h"
+#include "game/EntityStore.h"
+
+namespace asteroids
+{
+
+    /**
+     * @brief Squared collision radii indexed by the State of a rock.
+     */
+    using SquaredRadii = std::array<GLfloat, 3>;
+
+    /**
+     * @brief Square a table of collision radii indexed by State.
+     * @param radii The collision radii.
+     * @return The squared collision radii.
+     */
+    constexpr SquaredRadii SquareRadii(const std::array<GLfloat, 3> &radii)
+    {
+        return {radii[0] * radii[0], radii[1] * radii[1], radii[2] * radii[2]};
+    }
+
+    /**
+     * @class CollisionKernel
+     * @brief Tests one point against packed blocks of rock centers.
+     *
+     * A rock is hit when the squared distance from its center is below the squared radius of its size.
+     * Blocks are tested with std::experimental::simd where the standard library provides it and with a
+     * scalar loop otherwise, or when ASTEROIDS_SCALAR_COLLISION is defined.
+     */
+    class ASTEROIDS_DLL_EXPORT CollisionKernel
+    {
+    public:
+        /**
+         * @brief The largest number of rocks tested by a single HitMask call.
+         */
+        static constexpr size_t BLOCK_SIZE = 64;
+
+        /**
+         * @brief Test a point against a block of rocks.
+         * @param x The x-coordinate of the point.
+         * @param y The y-coordinate of the point.
+         * @param rockX The x-coordinates of the rock centers.
+         * @param rockY The y-coordinates of the rock centers.
+         * @param states The sizes of the rocks.
+         * @param count The number of rocks, no more than BLOCK_SIZE.
+         * @param radii The squared collision radii.
+         * @return A mask with bit i set if rock i is hit.
+         */
+        static std::uint64_t HitMask(
+            const GLfloat x,
+            const GLfloat y,
+            const GLfloat *rockX,
+            const GLfloat *rockY,
+            const State *states,
+            const size_t count,
+            const SquaredRadii &radii);
+
+        /**
+         * @brief Find the first rock of a packed run which is hit by a point.
+         * @param x The x-coordinate of the point.
+         * @param y The y-coordinate of the point.
+         * @param rockX The x-coordinates of the rock centers.
+         * @param rockY The y-coordinates of the rock centers.
+         * @param states The sizes of the rocks.
+         * @param count The number of rocks.
+         * @param radii The squared collision radii.
+         * @return The offset of the first hit rock in the run; std::nullopt if none is hit.
+         */
+        static std::optional<size_t> FirstHit(
+            const GLfloat x,
+            const GLfloat y,
+            const GLfloat *rockX,
+            const GLfloat *rockY,
+            const State *states,
+            const size_t count,
+            const SquaredRadii &radii);
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_collision_kernel_h
@@ -0,0 +1,100 @@
+/**
+ * @file CounterRng.h
+ * @brief Declaration of the counter based random numbers drawn by the simulation.
+ */
+
+#ifndef asteroids_counter_rng_h
+#define asteroids_counter_rng_h
+
+#include <cstdint>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class CounterRng
+     * @brief A stateless SplitMix64 stream keyed by a seed, a stream and a frame.
+     *
+     * The n-th number of a stream is a pure function of its key and n, so every draw is reproducible from
+     * the seed alone and independent of the order tasks run in. Streams are cheap values: each draw site
+     * keys its own, typically by the handle of the entity drawing and the tick it draws on, instead of
+     * sharing a generator between threads.
+     */
+    class ASTEROIDS_DLL_EXPORT CounterRng
+    {
+    public:
+        static constexpr std::uint64_t DEFAULT_SEED = 0x2545F4914F6CDD1DULL; /**< Seed of a game which sets none. */
+
+        /**
+         * @brief Constructor.
+         * @param seed The seed of the game.
+         * @param stream The stream, unique per draw site and frame.
+         * @param frame The tick the numbers are drawn on.
+         */
+        constexpr CounterRng(const std::uint64_t seed, const std::uint64_t stream, const std::uint64_t frame)
+            : key_(Mix(Mix(seed ^ Mix(stream)) ^ frame))
+        {
+        }
+
+        /**
+         * @brief Draw the next number of the stream.
+         * @return A uniformly distributed 64 bit number.
+         */
+        constexpr std::uint64_t Next()
+        {
+            return Mix(key_ + GAMMA * ++counter_);
+        }
+
+        /**
+         * @brief Draw the next number of the stream below a bound.
+         * @param bound The exclusive bound, at least one.
+         * @return A number in [0, bound).
+         */
+        constexpr std::uint32_t Below(const std::uint32_t bound)
+        {
+            // the high half scaled by the bound; its bias is far below anything the game can observe
+            return static_cast<std::uint32_t>(((Next() >> 32) * bound) >> 32);
+        }
+
+        /**
+         * @brief Draw the next number of the stream as a fraction.
+         * @return A number in [0, 1).
+         */
+        constexpr double Unit()
+        {
+            return static_cast<double>(Next() >> 11) * 0x1.0p-53;
+        }
+
+        /**
+         * @brief Draw a random sign.
+         * @return 1 or -1 with equal chance.
+         */
+        constexpr std::int32_t Sign()
+        {
+            return (Next() >> 63) ? -1 : 1;
+        }
+
+        /**
+         * @brief The SplitMix64 finalizer.
+         * @param x The number to mix.
+         * @return The mixed number.
+         */
+        static constexpr std::uint64_t Mix(std::uint64_t x)
+        {
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+
+    private:
+        static constexpr std::uint64_t GAMMA = 0x9E3779B97F4A7C15ULL; /**< Step between the counters of a stream. */
+
+        std::uint64_t key_;         /**< The mixed seed, stream and frame. */
+        std::uint64_t counter_{0}; /**< Numbers drawn so far. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_counter_rng_h
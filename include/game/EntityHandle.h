@@ -0,0 +1,139 @@
+/**
+ * @file EntityHandle.h
+ * @brief Declaration of generational entity handles and the slot map resolving them to store rows.
+ */
+
+#ifndef asteroids_entity_handle_h
+#define asteroids_entity_handle_h
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct EntityHandle
+     * @brief A slot and generation pair identifying an entity in the store.
+     *
+     * A slot is reused once its entity is destroyed, but with the next generation, so handles to
+     * the destroyed entity no longer resolve.
+     */
+    struct ASTEROIDS_DLL_EXPORT EntityHandle
+    {
+        static constexpr std::uint32_t NULL_SLOT = std::numeric_limits<std::uint32_t>::max(); /**< Slot of the null handle. */
+
+        std::uint32_t slot{NULL_SLOT}; /**< Slot in the handle table. */
+        std::uint32_t generation{0};   /**< Generation of the slot. */
+
+        /**
+         * @brief Check if this is the null handle.
+         * @return true if the handle refers to no slot; false otherwise.
+         */
+        bool IsNull() const;
+
+        /**
+         * @brief Derive the persistence key of the entity.
+         * @param prefix The entity type prefix.
+         * @return The key, formatted as prefix + slot + "g" + generation.
+         */
+        std::string ToKey(const std::string_view prefix) const;
+
+        /**
+         * @brief Parse a persistence key derived by ToKey.
+         * @param key The persistence key.
+         * @param prefix The entity type prefix.
+         * @return The handle; std::nullopt if the key was not derived from a handle.
+         */
+        static std::optional<EntityHandle> FromKey(const std::string_view key, const std::string_view prefix);
+
+        friend bool operator==(const EntityHandle &, const EntityHandle &) = default;
+    };
+
+    /**
+     * @class HandleTable
+     * @brief A slot map resolving entity handles to the rows of an archetype.
+     */
+    class ASTEROIDS_DLL_EXPORT HandleTable
+    {
+    public:
+        /**
+         * @brief Allocate a handle for a row.
+         * @param row The row of the entity.
+         * @return The new handle.
+         */
+        EntityHandle Create(const size_t row);
+
+        /**
+         * @brief Allocate exactly the given handle for a row, as when restoring a saved game.
+         * @param handle The handle to allocate.
+         * @param row The row of the entity.
+         * @return true if the handle was allocated; false if its slot is in use.
+         */
+        bool Claim(const EntityHandle handle, const size_t row);
+
+        /**
+         * @brief Check if a handle refers to a live entity.
+         * @param handle The handle.
+         * @return true if the handle resolves; false otherwise.
+         */
+        bool Contains(const EntityHandle handle) const;
+
+        /**
+         * @brief Get the row of a live entity.
+         * @param handle The handle.
+         * @return The row of the entity.
+         */
+        size_t Row(const EntityHandle handle) const;
+
+        /**
+         * @brief Point a live handle at a new row.
+         * @param handle The handle.
+         * @param row The new row of the entity.
+         */
+        void Relocate(const EntityHandle handle, const size_t row);
+
+        /**
+         * @brief Release a handle. Its slot is reused with the next generation.
+         * @param handle The handle.
+         */
+        void Destroy(const EntityHandle handle);
+
+        /**
+         * @brief Release every handle.
+         */
+        void Clear();
+
+    private:
+        /**
+         * @struct Slot
+         * @brief A slot of the table.
+         */
+        struct Slot
+        {
+            std::uint32_t generation{0}; /**< Current generation. */
+            size_t row{0};               /**< Row of the entity while live. */
+            size_t freeIndex{0};         /**< Position in the free list while released. */
+            bool live{false};            /**< Whether an entity holds the slot. */
+        };
+
+        /**
+         * @brief Add a released slot to the free list.
+         * @param slot The slot.
+         */
+        void Release(const std::uint32_t slot);
+
+        std::vector<Slot> slots_;          /**< Slots indexed by EntityHandle::slot. */
+        std::vector<std::uint32_t> free_;  /**< Released slots. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_entity_handle_h
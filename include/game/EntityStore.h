@@ -0,0 +1,305 @@
+/**
+ * @file EntityStore.h
+ * @brief Declaration of the EntityStore which keeps rock and bullet state in packed per-archetype arrays.
+ */
+
+#ifndef asteroids_entity_store_h
+#define asteroids_entity_store_h
+
+#include <cstddef>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/EntityHandle.h"
+
+namespace asteroids
+{
+
+    /**
+     * @enum State
+     * @brief Enumeration for the size of the rock.
+     */
+    enum class State
+    {
+        LARGE,
+        MEDIUM,
+        SMALL
+    };
+
+    /**
+     * @struct RockRow
+     * @brief The state of a single rock, used to move rocks in and out of the store.
+     */
+    struct RockRow
+    {
+        EntityHandle handle;          /**< Handle of the rock. */
+        State state{State::LARGE};    /**< Size of the rock. */
+        GLfloat x{0.0f};              /**< Position x-coordinate. */
+        GLfloat y{0.0f};              /**< Position y-coordinate. */
+        GLfloat ux{1.0f};             /**< Unit velocity x-component. */
+        GLfloat uy{0.0f};             /**< Unit velocity y-component. */
+        GLfloat speed{0.0f};          /**< Speed of the rock. */
+        GLfloat velocityAngle{0.0f};  /**< Velocity angle. */
+        GLfloat mass{1.0f};           /**< Mass of the rock. */
+        GLfloat spin{0.0f};           /**< Rock spin value. */
+        GLfloat spinEpsilon{0.01f};   /**< Increment value for spin calculations. */
+        GLint spinDirection{1};       /**< Direction of the rock spin. */
+        bool initialized{false};      /**< Indicates whether the rock velocity has been initialized. */
+    };
+
+    /**
+     * @struct BulletRow
+     * @brief The state of a single bullet, used to move bullets in and out of the store.
+     */
+    struct BulletRow
+    {
+        EntityHandle handle;         /**< Handle of the bullet. */
+        GLfloat x{0.0f};             /**< Position x-coordinate. */
+        GLfloat y{0.0f};             /**< Position y-coordinate. */
+        GLfloat ux{1.0f};            /**< Unit velocity x-component. */
+        GLfloat uy{0.0f};            /**< Unit velocity y-component. */
+        GLfloat speed{0.0f};         /**< Speed of the bullet. */
+        GLfloat velocityAngle{0.0f}; /**< Velocity angle. */
+        GLfloat mass{1.0f};          /**< Mass of the bullet. */
+        bool initialized{false};     /**< Indicates whether the bullet velocity has been initialized. */
+        bool outOfBounds{false};     /**< Flag indicating if the bullet is out of bounds. */
+    };
+
+    /**
+     * @struct Kinematics
+     * @brief Packed motion columns shared by every archetype.
+     *
+     * Row i of every column belongs to the same entity.
+     */
+    struct ASTEROIDS_DLL_EXPORT Kinematics
+    {
+        std::vector<GLfloat> x;             /**< Position x-coordinates. */
+        std::vector<GLfloat> y;             /**< Position y-coordinates. */
+        std::vector<GLfloat> ux;            /**< Unit velocity x-components. */
+        std::vector<GLfloat> uy;            /**< Unit velocity y-components. */
+        std::vector<GLfloat> speed;         /**< Speeds. */
+        std::vector<GLfloat> velocityAngle; /**< Velocity angles. */
+        std::vector<GLfloat> mass;          /**< Masses. */
+
+    protected:
+        /**
+         * @brief Append a row to the motion columns.
+         */
+        void PushKinematics(GLfloat _x, GLfloat _y, GLfloat _ux, GLfloat _uy, GLfloat _speed, GLfloat _velocityAngle, GLfloat _mass);
+
+        /**
+         * @brief Remove a row by moving the last row into its place.
+         * @param row The row to remove.
+         */
+        void SwapRemoveKinematics(const size_t row);
+
+        /**
+         * @brief Remove all rows from the motion columns.
+         */
+        void ClearKinematics();
+
+        /**
+         * @brief Reserve capacity in the motion columns.
+         * @param capacity The number of rows to reserve.
+         */
+        void ReserveKinematics(const size_t capacity);
+    };
+
+    /**
+     * @class RockArchetype
+     * @brief Packed columns of every rock in the game.
+     */
+    class ASTEROIDS_DLL_EXPORT RockArchetype : public Kinematics
+    {
+    public:
+        /**
+         * @brief Get the number of rocks.
+         * @return The number of rows.
+         */
+        size_t Size() const;
+
+        /**
+         * @brief Append a rock under a new handle.
+         * @param rock The rock state. Its handle is ignored.
+         * @return The handle of the new rock.
+         */
+        EntityHandle Add(const RockRow &rock);
+
+        /**
+         * @brief Append a rock under the handle it was saved with.
+         * @param rock The rock state.
+         * @return true if the rock was added; false if its handle is null or in use.
+         */
+        bool Restore(const RockRow &rock);
+
+        /**
+         * @brief Check if a handle refers to a live rock.
+         * @param handle The handle.
+         * @return true if the rock exists; false otherwise.
+         */
+        bool Contains(const EntityHandle handle) const;
+
+        /**
+         * @brief Get the row of a live rock.
+         * @param handle The handle of the rock.
+         * @return The row of the rock.
+         */
+        size_t RowOf(const EntityHandle handle) const;
+
+        /**
+         * @brief Gather the columns of a rock.
+         * @param row The row of the rock.
+         * @return The rock state.
+         */
+        RockRow Get(const size_t row) const;
+
+        /**
+         * @brief Remove a rock. The last rock moves into the vacated row.
+         * @param row The row of the rock.
+         */
+        void Remove(const size_t row);
+
+        /**
+         * @brief Remove all rocks.
+         */
+        void Clear();
+
+        /**
+         * @brief Reserve capacity for rocks.
+         * @param capacity The number of rows to reserve.
+         */
+        void Reserve(const size_t capacity);
+
+        std::vector<GLfloat> spin;          /**< Spin values. */
+        std::vector<GLfloat> spinEpsilon;   /**< Spin increments. */
+        std::vector<GLint> spinDirection;   /**< Spin directions. */
+        std::vector<State> state;           /**< Rock sizes. */
+        std::vector<EntityHandle> handles;  /**< Handles. */
+
+    private:
+        /**
+         * @brief Append the columns of a rock.
+         * @param rock The rock state.
+         * @param handle The handle of the rock.
+         */
+        void Append(const RockRow &rock, const EntityHandle handle);
+
+        HandleTable table_; /**< Resolves handles to rows. */
+    };
+
+    /**
+     * @class BulletArchetype
+     * @brief Packed columns of every bullet in the game.
+     */
+    class ASTEROIDS_DLL_EXPORT BulletArchetype : public Kinematics
+    {
+    public:
+        /**
+         * @brief Get the number of bullets.
+         * @return The number of rows.
+         */
+        size_t Size() const;
+
+        /**
+         * @brief Append a bullet under a new handle.
+         * @param bullet The bullet state. Its handle is ignored.
+         * @return The handle of the new bullet.
+         */
+        EntityHandle Add(const BulletRow &bullet);
+
+        /**
+         * @brief Append a bullet under the handle it was saved with.
+         * @param bullet The bullet state.
+         * @return true if the bullet was added; false if its handle is null or in use.
+         */
+        bool Restore(const BulletRow &bullet);
+
+        /**
+         * @brief Check if a handle refers to a live bullet.
+         * @param handle The handle.
+         * @return true if the bullet exists; false otherwise.
+         */
+        bool Contains(const EntityHandle handle) const;
+
+        /**
+         * @brief Get the row of a live bullet.
+         * @param handle The handle of the bullet.
+         * @return The row of the bullet.
+         */
+        size_t RowOf(const EntityHandle handle) const;
+
+        /**
+         * @brief Gather the columns of a bullet.
+         * @param row The row of the bullet.
+         * @return The bullet state.
+         */
+        BulletRow Get(const size_t row) const;
+
+        /**
+         * @brief Remove a bullet. The last bullet moves into the vacated row.
+         * @param row The row of the bullet.
+         */
+        void Remove(const size_t row);
+
+        /**
+         * @brief Remove all bullets.
+         */
+        void Clear();
+
+        std::vector<unsigned char> initialized; /**< Velocity initialization flags. */
+        std::vector<unsigned char> outOfBounds; /**< Out of bounds flags. */
+        std::vector<EntityHandle> handles;      /**< Handles. */
+
+    private:
+        /**
+         * @brief Append the columns of a bullet.
+         * @param bullet The bullet state.
+         * @param handle The handle of the bullet.
+         */
+        void Append(const BulletRow &bullet, const EntityHandle handle);
+
+        HandleTable table_; /**< Resolves handles to rows. */
+    };
+
+    /**
+     * @class EntityStore
+     * @brief Data oriented storage for the game's rocks and bullets.
+     *
+     * Per frame systems iterate the packed columns directly. Rock and Bullet entities are only
+     * materialized from the rows when the game is saved, and folded back into rows when it is loaded.
+     */
+    class ASTEROIDS_DLL_EXPORT EntityStore
+    {
+    public:
+        /**
+         * @brief Get the rock archetype.
+         * @return The rock columns.
+         */
+        RockArchetype &Rocks();
+
+        /**
+         * @brief Get the rock archetype.
+         * @return The rock columns.
+         */
+        const RockArchetype &Rocks() const;
+
+        /**
+         * @brief Get the bullet archetype.
+         * @return The bullet columns.
+         */
+        BulletArchetype &Bullets();
+
+        /**
+         * @brief Get the bullet archetype.
+         * @return The bullet columns.
+         */
+        const BulletArchetype &Bullets() const;
+
+    private:
+        RockArchetype rocks_;     /**< Rock columns. */
+        BulletArchetype bullets_; /**< Bullet columns. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_entity_store_h
@@ -0,0 +1,187 @@
+/**
+ * @file FrameTimings.h
+ * @brief Declaration of the FrameTimings which keep rolling percentiles of the duration of each stage of a frame.
+ */
+
+#ifndef asteroids_frame_timings_h
+#define asteroids_frame_timings_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @enum TimedStage
+     * @brief The stages of a frame which are timed.
+     */
+    enum class TimedStage
+    {
+        TICK,         /**< A whole time step of the simulation. */
+        UPDATE_ROCKS, /**< Moving the rocks. */
+        UPDATE_SHIP,  /**< Moving the ship and its bullets. */
+        COLLISIONS,   /**< Finding the rocks hit by bullets and the ship. */
+        RESOLVE,      /**< Breaking and destroying the hit rocks. */
+        SAVE,         /**< Capturing the state of a save on the simulation thread. */
+        WRITE,        /**< Writing a save on the save writer thread. */
+        LOAD,         /**< Loading a save. */
+        SNAPSHOT,     /**< Copying the state into the snapshot handed to the GUI thread. */
+        DRAW,         /**< Submitting a snapshot to the graphics library. */
+        FRAME,        /**< A whole frame of the GUI thread, input included. */
+        COUNT
+    };
+
+    /**
+     * @struct StageTiming
+     * @brief Percentiles of the recent durations of a stage, in milliseconds.
+     */
+    struct ASTEROIDS_DLL_EXPORT StageTiming
+    {
+        double p50{0.0};          /**< Median duration. */
+        double p95{0.0};          /**< 95th percentile duration. */
+        double p99{0.0};          /**< 99th percentile duration. */
+        double max{0.0};          /**< Longest duration. */
+        std::uint64_t samples{0}; /**< Durations the percentiles are taken over. */
+    };
+
+    /**
+     * @class RollingHistogram
+     * @brief A lock-free histogram of the most recent durations recorded into it.
+     *
+     * Durations fall into log-linear buckets, eight per power of two, so a percentile is exact to within
+     * 1/16 of its value. The histogram is split into slices of SLICE_SAMPLES durations which are recycled
+     * in turn, so percentiles cover the last (SLICES - 1) * SLICE_SAMPLES to SLICES * SLICE_SAMPLES
+     * durations. Recording takes a handful of relaxed atomic operations; a summary read while durations
+     * are recorded may miss the ones in flight.
+     */
+    class ASTEROIDS_DLL_EXPORT RollingHistogram
+    {
+    public:
+        static constexpr size_t SLICES = 4;         /**< Slices recycled in turn. */
+        static constexpr size_t SLICE_SAMPLES = 64; /**< Durations recorded into a slice before the next is recycled. */
+
+        /**
+         * @brief Record a duration.
+         * @param duration The duration.
+         */
+        void Record(const std::chrono::nanoseconds duration);
+
+        /**
+         * @brief Summarize the recent durations.
+         * @return Their percentiles.
+         */
+        StageTiming Summarize() const;
+
+    private:
+        static constexpr size_t SUB_BUCKET_BITS = 3;                                /**< Buckets per power of two, as a power of two. */
+        static constexpr size_t BUCKETS = (65 - SUB_BUCKET_BITS) << SUB_BUCKET_BITS; /**< Buckets covering every duration. */
+
+        /**
+         * @struct Slice
+         * @brief The counts of one slice of durations.
+         */
+        struct Slice
+        {
+            std::array<std::atomic<std::uint32_t>, BUCKETS> counts{}; /**< Durations per bucket. */
+            std::atomic<std::uint64_t> max{0};                        /**< Longest duration in nanoseconds. */
+        };
+
+        /**
+         * @brief Get the bucket of a duration.
+         * @param nanoseconds The duration in nanoseconds.
+         * @return The bucket.
+         */
+        static size_t BucketOf(const std::uint64_t nanoseconds);
+
+        /**
+         * @brief Get the duration a bucket stands for.
+         * @param bucket The bucket.
+         * @return The middle of the durations in the bucket, in nanoseconds.
+         */
+        static double ValueOf(const size_t bucket);
+
+        std::array<Slice, SLICES> slices_;      /**< Slices of recent durations. */
+        std::atomic<std::uint64_t> samples_{0}; /**< Durations recorded so far. */
+    };
+
+    /**
+     * @class FrameTimings
+     * @brief Keeps a rolling histogram of the duration of each stage of a frame.
+     *
+     * Stages are recorded from the threads running them, typically through a ScopedTimer, and summarized
+     * from any thread, such as the GUI thread drawing the timing overlay.
+     */
+    class ASTEROIDS_DLL_EXPORT FrameTimings
+    {
+    public:
+        /**
+         * @brief Get the timings.
+         * @return The timings.
+         */
+        static FrameTimings *GetInstance();
+
+        /**
+         * @brief Record a duration of a stage.
+         * @param stage The stage.
+         * @param duration The duration.
+         */
+        void Record(const TimedStage stage, const std::chrono::nanoseconds duration);
+
+        /**
+         * @brief Summarize the recent durations of a stage.
+         * @param stage The stage.
+         * @return Their percentiles.
+         */
+        StageTiming Summarize(const TimedStage stage) const;
+
+        /**
+         * @brief Get the name of a stage.
+         * @param stage The stage.
+         * @return The name.
+         */
+        static std::string_view Name(const TimedStage stage);
+
+    private:
+        FrameTimings() = default;
+
+        std::array<RollingHistogram, static_cast<size_t>(TimedStage::COUNT)> histograms_; /**< Histogram of each stage. */
+    };
+
+    /**
+     * @class ScopedTimer
+     * @brief Records the time from its construction to its destruction as a duration of a stage.
+     */
+    class ASTEROIDS_DLL_EXPORT ScopedTimer
+    {
+    public:
+        /**
+         * @brief Constructor. Starts timing.
+         * @param stage The stage being timed.
+         */
+        explicit ScopedTimer(const TimedStage stage);
+
+        /**
+         * @brief Destructor. Records the duration.
+         */
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer(ScopedTimer &&) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(ScopedTimer &&) = delete;
+
+    private:
+        TimedStage stage_;                            /**< The stage being timed. */
+        std::chrono::steady_clock::time_point start_; /**< When timing started. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_frame_timings_h
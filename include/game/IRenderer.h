@@ -0,0 +1,43 @@
+/**
+ * @file IRenderer.h
+ * @brief Declaration of the IRenderer interface which draws render snapshots.
+ */
+
+#ifndef asteroids_irenderer_h
+#define asteroids_irenderer_h
+
+#include "configuration/config.h"
+#include "game/RenderSnapshot.h"
+#include "gl/GLEntity.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class IRenderer
+     * @brief Draws snapshots on the thread which owns the graphics context.
+     */
+    class ASTEROIDS_DLL_EXPORT IRenderer
+    {
+    public:
+        /**
+         * @brief Destructor.
+         */
+        virtual ~IRenderer() noexcept = default;
+
+        /**
+         * @brief Get the bounds of the world the renderer currently shows.
+         * @return The world bounds.
+         */
+        virtual WorldBounds GetBounds() const = 0;
+
+        /**
+         * @brief Draw a snapshot.
+         * @param snapshot The snapshot to draw.
+         */
+        virtual void Draw(const RenderSnapshot &snapshot) = 0;
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_irenderer_h
@@ -0,0 +1,165 @@
+/**
+ * @file InputRecording.h
+ * @brief Declaration of the InputRecorder and InputReplay which capture and play back the input of a session.
+ */
+
+#ifndef asteroids_input_recording_h
+#define asteroids_input_recording_h
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/RenderSnapshot.h"
+#include "game/Simulation.h"
+#include "gl/GLEntity.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct InputEvent
+     * @brief An input applied by the simulation before one of its frames.
+     */
+    struct InputEvent
+    {
+        std::uint64_t frame{0};          /**< Frame the input was applied before. */
+        bool resize{false};              /**< Set if the input resized the world rather than issued a command. */
+        Command command{Command::FIRE};  /**< The command, unless the input is a resize. */
+        WorldBounds bounds{0.0f, 0.0f};  /**< The new bounds, if the input is a resize. */
+    };
+
+    /**
+     * @class InputRecorder
+     * @brief Writes the input of a session, frame by frame, to a compact binary recording.
+     *
+     * A recording is a header holding the seed and the scenario of the session, followed by one record
+     * per input: the
+     * number of frames since the previous record as a variable length integer and a command byte, the
+     * bounds following a resize. An end record carries the number of frames the session ran. Recording
+     * happens on the simulation thread, in the order inputs are applied. Saves and loads are neither
+     * applied nor recorded, so a session depends on nothing but its recording.
+     */
+    class ASTEROIDS_DLL_EXPORT InputRecorder
+    {
+    public:
+        static constexpr std::uint32_t VERSION = 2; /**< Version of the layout written by the recorder. */
+
+        /**
+         * @brief Destructor. Closes the recording at the last recorded frame.
+         */
+        ~InputRecorder() noexcept;
+
+        /**
+         * @brief Start a recording, replacing any file at the path.
+         * @param path The path of the recording.
+         * @param seed The seed of the recorded session.
+         * @param scenario The scenario of the recorded session, in its command line form.
+         * @return true if the recording was started; false otherwise.
+         */
+        bool Open(const std::filesystem::path &path, const std::uint64_t seed, const std::string_view scenario);
+
+        /**
+         * @brief Record a command.
+         * @param frame The frame the command is applied before, no earlier than the last recorded frame.
+         * @param command The command.
+         */
+        void Record(const std::uint64_t frame, const Command command);
+
+        /**
+         * @brief Record a resize of the world.
+         * @param frame The frame the bounds are applied before, no earlier than the last recorded frame.
+         * @param bounds The new bounds.
+         */
+        void Resize(const std::uint64_t frame, const WorldBounds &bounds);
+
+        /**
+         * @brief End the recording.
+         * @param frames The number of frames the session ran.
+         * @return true if the whole recording was written; false otherwise.
+         */
+        bool Close(const std::uint64_t frames);
+
+        /**
+         * @brief Get the seed of the recorded session.
+         * @return The seed.
+         */
+        std::uint64_t GetSeed() const;
+
+    private:
+        /**
+         * @brief Write the frame delta and code of a record.
+         * @param frame The frame of the record.
+         * @param code The code of the record.
+         */
+        void Begin(const std::uint64_t frame, const std::uint8_t code);
+
+        std::ofstream stream_;       /**< The recording. */
+        std::uint64_t seed_{0};      /**< Seed of the recorded session. */
+        std::uint64_t lastFrame_{0}; /**< Frame of the last record. */
+    };
+
+    /**
+     * @class InputReplay
+     * @brief A recording read back for replay.
+     *
+     * A session replays by resetting a new game to the recorded scenario under the recorded seed, then
+     * applying each frame's inputs before stepping the simulation through that frame.
+     */
+    class ASTEROIDS_DLL_EXPORT InputReplay
+    {
+    public:
+        /**
+         * @brief Read and validate a recording.
+         * @param path The path of the recording.
+         * @return true if the recording is complete and valid; false otherwise.
+         */
+        bool Open(const std::filesystem::path &path);
+
+        /**
+         * @brief Get the seed of the recorded session.
+         * @return The seed.
+         */
+        std::uint64_t GetSeed() const;
+
+        /**
+         * @brief Get the scenario of the recorded session.
+         * @return The scenario in its command line form; empty for the classic game.
+         */
+        const std::string &GetScenario() const;
+
+        /**
+         * @brief Get the number of frames the recorded session ran.
+         * @return The number of frames.
+         */
+        std::uint64_t GetFrameCount() const;
+
+        /**
+         * @brief Get the recorded inputs.
+         * @return The inputs, in the order they were applied.
+         */
+        const std::vector<InputEvent> &GetEvents() const;
+
+        /**
+         * @brief Hash the state of a frame.
+         *
+         * Two runs of a session behave the same only if the hashes of all their frames match.
+         * @param snapshot The snapshot published after the frame.
+         * @return The 64-bit FNV-1a hash of the snapshot.
+         */
+        static std::uint64_t Hash(const RenderSnapshot &snapshot);
+
+    private:
+        std::uint64_t seed_{0};          /**< Seed of the recorded session. */
+        std::string scenario_;           /**< Scenario of the recorded session. */
+        std::uint64_t frames_{0};        /**< Frames the recorded session ran. */
+        std::vector<InputEvent> events_; /**< The recorded inputs. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_input_recording_h
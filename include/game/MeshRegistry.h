@@ -0,0 +1,135 @@
+/**
+ * @file MeshRegistry.h
+ * @brief Declaration of the MeshRegistry which holds the geometry shared by every rock, ship and bullet.
+ */
+
+#ifndef asteroids_mesh_registry_h
+#define asteroids_mesh_registry_h
+
+#include <array>
+#include <cstddef>
+
+#include "test_filesystem_adapters/ContainerResource.h"
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+#include "configuration/config.h"
+#include "game/EntityStore.h"
+
+namespace asteroids
+{
+
+    using ResourceGLubyte = ContainerResource<GLubyte>;
+    using Resource2DGLfloat = ContainerResource2D<GLfloat>;
+
+    /**
+     * @enum MeshId
+     * @brief The meshes of the registry.
+     */
+    enum class MeshId
+    {
+        ROCK_LARGE,
+        ROCK_MEDIUM,
+        ROCK_SMALL,
+        SHIP,
+        BULLET
+    };
+
+    /**
+     * @struct MeshGeometry
+     * @brief The vertices and indices of a mesh.
+     */
+    struct MeshGeometry
+    {
+        static constexpr size_t VERTEX_COUNT = 8; /**< Number of vertices of every entity mesh. */
+        static constexpr size_t INDEX_COUNT = 24; /**< Number of indices of every entity mesh. */
+
+        std::array<GLfloat, VERTEX_COUNT * 3> vertices; /**< Vertex positions, three per vertex. */
+        std::array<GLubyte, INDEX_COUNT> indices;       /**< Element indices. */
+        GLenum mode;                                    /**< Primitive type the indices describe. */
+    };
+
+    /**
+     * @class MeshRegistry
+     * @brief A compile-time table of the entity meshes, referenced by ID.
+     *
+     * Entities hold no geometry of their own; the renderers and the persistence code look their mesh up here.
+     */
+    class ASTEROIDS_DLL_EXPORT MeshRegistry
+    {
+    public:
+        /**
+         * @brief The number of meshes.
+         */
+        static constexpr size_t MESH_COUNT = 5;
+
+        MeshRegistry() = delete;
+
+        /**
+         * @brief Get a mesh.
+         * @param id The mesh.
+         * @return The geometry of the mesh.
+         */
+        static constexpr const MeshGeometry &Get(const MeshId id)
+        {
+            return MESHES[static_cast<size_t>(id)];
+        }
+
+        /**
+         * @brief Get the mesh of a rock.
+         * @param state The size of the rock.
+         * @return The mesh.
+         */
+        static constexpr MeshId RockMesh(const State state)
+        {
+            if (state == State::LARGE)
+                return MeshId::ROCK_LARGE;
+            else if (state == State::MEDIUM)
+                return MeshId::ROCK_MEDIUM;
+            return MeshId::ROCK_SMALL;
+        }
+
+        /**
+         * @brief Get the vertices of a mesh as a resource, as they are saved alongside entities.
+         * @param id The mesh.
+         * @return The vertices, one row per vertex.
+         */
+        static const Resource2DGLfloat &VerticesResource(const MeshId id);
+
+        /**
+         * @brief Get the indices of a mesh as a resource, as they are saved alongside entities.
+         * @param id The mesh.
+         * @return The indices.
+         */
+        static const ResourceGLubyte &IndicesResource(const MeshId id);
+
+    private:
+        static constexpr std::array<GLubyte, MeshGeometry::INDEX_COUNT> INDICES = {
+            0, 3, 2, 1, 2, 3, 7, 6, 0, 4, 7, 3, 1, 2, 6, 5, 4, 5, 6, 7, 0, 1, 5, 4};
+
+        static constexpr std::array<MeshGeometry, MESH_COUNT> MESHES = {{
+            {{-1.5f, -1.5f, 0.5f, 1.5f, -1.5f, 0.5f, 1.5f, 1.5f, 0.5f, -1.5f, 1.5f, 0.5f,
+              -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f, -1.0f, 1.0f, 1.0f},
+             INDICES,
+             GL_LINE_LOOP},
+            {{-1.0f, -1.0f, 0.5f, 1.0f, -1.0f, 0.5f, 1.0f, 1.0f, 0.5f, -1.0f, 1.0f, 0.5f,
+              -0.75f, -0.75f, 1.0f, 0.75f, -0.75f, 1.0f, 0.75f, 0.75f, 1.0f, -0.75f, 0.75f, 1.0f},
+             INDICES,
+             GL_LINE_LOOP},
+            {{-0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f,
+              -0.25f, -0.25f, 1.0f, 0.25f, -0.25f, 1.0f, 0.25f, 0.25f, 1.0f, -0.25f, 0.25f, 1.0f},
+             INDICES,
+             GL_LINE_LOOP},
+            {{-0.5f, -0.5f, 0.5f, 0.5f, -0.0f, 0.5f, 0.5f, 0.0f, 0.5f, -0.5f, 0.5f, 0.5f,
+              -0.5f, -0.5f, 1.0f, 0.1f, -0.0f, 1.0f, 0.1f, 0.0f, 1.0f, -0.5f, 0.5f, 1.0f},
+             INDICES,
+             GL_LINE_LOOP},
+            {{-0.2f, -0.1f, 0.5f, 0.2f, -0.0f, 0.5f, 0.2f, 0.0f, 0.5f, -0.2f, 0.1f, 0.5f,
+              -0.2f, -0.1f, 1.0f, 0.2f, -0.0f, 1.0f, 0.2f, 0.0f, 1.0f, -0.2f, 0.1f, 1.0f},
+             INDICES,
+             GL_QUADS},
+        }};
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_mesh_registry_h
@@ -0,0 +1,90 @@
+/**
+ * @file ParallelFor.h
+ * @brief Declaration of the chunked parallel loops the per frame systems run on the task scheduler.
+ */
+
+#ifndef asteroids_parallel_for_h
+#define asteroids_parallel_for_h
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+
+#include "configuration/config.h"
+#include "game/TaskScheduler.h"
+
+namespace asteroids
+{
+
+    /**
+     * @brief Get the number of chunks a range is split into.
+     *
+     * Every chunk holds at least grain items, and there is no more than one chunk per hardware thread.
+     * @param count The number of items in the range.
+     * @param grain The smallest number of items worth handing to another thread.
+     * @return The number of chunks, at least one.
+     */
+    ASTEROIDS_DLL_EXPORT size_t ChunkCount(const size_t count, const size_t grain);
+
+    /**
+     * @brief Run a body over a range split into a given number of contiguous chunks.
+     *
+     * The calling thread works on the first chunk and then helps with the others until every chunk
+     * is done, so it may itself be a scheduler task. A single chunk runs inline without touching the
+     * scheduler. If a chunk throws, the first exception is rethrown once every chunk is done.
+     * @param scheduler The scheduler to run on.
+     * @param count The number of items in the range.
+     * @param chunks The number of chunks, at least one.
+     * @param body Called as body(chunk, begin, end) once per chunk.
+     */
+    template <typename Body>
+    void ParallelForChunks(TaskScheduler &scheduler, const size_t count, const size_t chunks, Body &&body)
+    {
+        const size_t chunkSize = (count + chunks - 1) / chunks;
+        if (chunks <= 1)
+        {
+            body(size_t{0}, size_t{0}, count);
+            return;
+        }
+
+        TaskGroup group;
+        for (size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            const size_t begin = std::min(chunk * chunkSize, count);
+            const size_t end = std::min(begin + chunkSize, count);
+            scheduler.Submit(group, [&body, chunk, begin, end]()
+                             { body(chunk, begin, end); });
+        }
+
+        // the submitted chunks refer to the body and the group, so they have to finish even when this one throws
+        std::exception_ptr error;
+        try
+        {
+            body(size_t{0}, size_t{0}, std::min(chunkSize, count));
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        scheduler.Wait(group);
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /**
+     * @brief Run a body over a range split into chunks of at least grain items.
+     * @param scheduler The scheduler to run on.
+     * @param count The number of items in the range.
+     * @param grain The smallest number of items worth handing to another thread.
+     * @param body Called as body(begin, end) once per chunk.
+     */
+    template <typename Body>
+    void ParallelFor(TaskScheduler &scheduler, const size_t count, const size_t grain, Body &&body)
+    {
+        ParallelForChunks(scheduler, count, ChunkCount(count, grain), [&body](const size_t, const size_t begin, const size_t end)
+                          { body(begin, end); });
+    }
+
+} // end namespace asteroids
+
+#endif // asteroids_parallel_for_h
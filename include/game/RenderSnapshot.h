@@ -0,0 +1,48 @@
+/**
+ * @file RenderSnapshot.h
+ * @brief Declaration of the RenderSnapshot which carries everything needed to draw one simulated time step.
+ */
+
+#ifndef asteroids_render_snapshot_h
+#define asteroids_render_snapshot_h
+
+#include <cstdint>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/EntityStore.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct RenderSnapshot
+     * @brief The transforms and sizes of the drawable entities after a time step.
+     *
+     * The snapshot owns copies of the values, so it can be drawn on another thread while the
+     * simulation moves on. Colors are fixed per kind of entity and not carried.
+     */
+    struct ASTEROIDS_DLL_EXPORT RenderSnapshot
+    {
+        std::vector<GLfloat> rockX;       /**< Rock center x-coordinates. */
+        std::vector<GLfloat> rockY;       /**< Rock center y-coordinates. */
+        std::vector<GLfloat> rockSpin;    /**< Rock spins. */
+        std::vector<State> rockState;     /**< Rock sizes. */
+
+        std::vector<GLfloat> bulletX;     /**< Bullet x-coordinates. */
+        std::vector<GLfloat> bulletY;     /**< Bullet y-coordinates. */
+        std::vector<GLfloat> bulletAngle; /**< Bullet velocity angles. */
+
+        bool hasShip{false};              /**< Whether a ship is drawn. */
+        GLfloat shipX{0.0f};              /**< Ship x-coordinate. */
+        GLfloat shipY{0.0f};              /**< Ship y-coordinate. */
+        GLfloat shipZ{0.0f};              /**< Ship z-coordinate. */
+        GLfloat shipOrientation{0.0f};    /**< Ship orientation angle. */
+
+        GLint score{0};                   /**< Score after the time step. */
+        std::uint64_t tick{0};            /**< Number of the time step. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_render_snapshot_h
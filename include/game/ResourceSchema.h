@@ -0,0 +1,70 @@
+/**
+ * @file ResourceSchema.h
+ * @brief Declaration of the ResourceSchema which lists the resources each entity class saves.
+ */
+
+#ifndef asteroids_resource_schema_h
+#define asteroids_resource_schema_h
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @enum EntityKind
+     * @brief The entity classes which save resources of their own.
+     */
+    enum class EntityKind
+    {
+        NONE,
+        SHIP,
+        ROCK,
+        BULLET
+    };
+
+    /**
+     * @class ResourceSchema
+     * @brief The resources of every entity class, computed once per class.
+     *
+     * Every entity resource is a row major 4x4 matrix and is serialized under the same key by every entity
+     * of a class, so the deserializer learns each key once rather than once per created entity. Persisted
+     * resources are keyed per entity; they are only read from saves which predate the save database, so
+     * their keys are registered lazily when such a save is loaded.
+     */
+    class ASTEROIDS_DLL_EXPORT ResourceSchema
+    {
+    public:
+        /**
+         * @brief Get the class of an entity from its key.
+         * @param entityKey The entity key.
+         * @return The class, or EntityKind::NONE if the key names no rock, bullet or ship.
+         */
+        static EntityKind KindOf(const std::string_view entityKey);
+
+        /**
+         * @brief Get the keys of the resources an entity class saves.
+         * @param kind The class.
+         * @return The resource keys, empty for EntityKind::NONE.
+         */
+        static const std::vector<std::string> &Resources(const EntityKind kind);
+
+        /**
+         * @brief Register the resources of every entity class with the resource deserializer, once.
+         */
+        static void RegisterSerialization();
+
+        /**
+         * @brief Register a persisted resource with the resource loader unless it is already registered.
+         * @param key The persisted resource key.
+         */
+        static void RegisterPersisted(const std::string &key);
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_resource_schema_h
@@ -0,0 +1,86 @@
+/**
+ * @file RestoreQueue.h
+ * @brief Declaration of the RestoreQueue which decodes the matrices of loaded entities in parallel.
+ */
+
+#ifndef asteroids_restore_queue_h
+#define asteroids_restore_queue_h
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/BlobStore.h"
+#include "game/TaskScheduler.h"
+#include "gl/Mat4Resource.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class RestoreQueue
+     * @brief Collects the matrices of entities while a save's hierarchy is read, then decodes them at once.
+     *
+     * Entities only read their scalar fields while the hierarchy loads and defer each matrix to the queue.
+     * Finish then decodes every deferred matrix concurrently on the task scheduler. Serialized matrices are
+     * read by the decoding threads; persisted matrices are read in one pass over the save database's
+     * connection first, and only those missing from it are looked up one at a time. The threads only hash
+     * the decoded matrices; their digests are recorded in the save journal afterwards on the calling
+     * thread. Every load of a save must be followed by Finish before its entities are used.
+     */
+    class ASTEROIDS_DLL_EXPORT RestoreQueue
+    {
+    public:
+        /**
+         * @brief Get the queue.
+         * @return The queue.
+         */
+        static RestoreQueue *GetInstance();
+
+        /**
+         * @brief Defer the decode of a matrix.
+         * @param resource The matrix to decode into. It must outlive the next call to Finish.
+         * @param entityKey The key of the entity owning the matrix.
+         * @param resourceKey The key of the matrix within the entity.
+         * @param path The folder of the serialized entity; unused when the save is persisted.
+         */
+        void Defer(Mat4Resource &resource, const std::string_view entityKey, const std::string_view resourceKey, const std::string_view path);
+
+        /**
+         * @brief Decode every deferred matrix and empty the queue.
+         * @param scheduler The scheduler to decode on.
+         * @return true if every matrix was decoded; false if any is missing, in which case the loaded entities
+         * must be discarded and nothing is recorded in the save journal.
+         */
+        bool Finish(TaskScheduler &scheduler);
+
+    private:
+        /**
+         * @struct Decode
+         * @brief A deferred matrix.
+         */
+        struct Decode
+        {
+            Mat4Resource *resource;  /**< The matrix to decode into. */
+            std::string entityKey;   /**< The key of the entity owning the matrix. */
+            std::string resourceKey; /**< The key of the matrix within the entity. */
+            std::string path;        /**< The folder of the serialized entity. */
+        };
+
+        RestoreQueue() = default;
+
+        /**
+         * @brief Decode a deferred matrix.
+         * @param decode The deferred matrix.
+         * @return The digest to record in the save journal, or nothing if the matrix is missing.
+         */
+        static std::optional<BlobStore::Digest> Run(const Decode &decode);
+
+        std::vector<Decode> decodes_; /**< Matrices deferred since the last Finish. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_restore_queue_h
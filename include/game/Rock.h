@@ -17,6 +17,9 @@
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/config.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/RenderSnapshot.h"
 #include "gl/GLEntity.h"
 
 namespace database_adapters
@@ -30,17 +33,6 @@ namespace asteroids
     using ResourceGLubyte = ContainerResource<GLubyte>;
     using Resource2DGLfloat = ContainerResource2D<GLfloat>;
 
-    /**
-     * @enum State
-     * @brief Enumeration for the size of the rock.
-     */
-    enum class State
-    {
-        LARGE,
-        MEDIUM,
-        SMALL
-    };
-
     /**
      * @class Rock
      * @brief A class representing an asteroid in the Asteroids game.
@@ -63,6 +55,12 @@ namespace asteroids
          */
         Rock(const State _state, const GLfloat _x, const GLfloat _y);
 
+        /**
+         * @brief Constructor materializing a rock from its row in the entity store.
+         * @param row The rock state.
+         */
+        explicit Rock(const RockRow &row);
+
         /**
          * @brief Destructor for the Rock class.
          */
@@ -95,29 +93,44 @@ namespace asteroids
         Rock &operator=(Rock &&) noexcept;
 
         /**
-         * @brief Register serialization resources for the rock.
-         * @param key The serialization key.
+         * @brief Make the row of a newly spawned rock.
+         * @param _state The size of the rock (LARGE, MEDIUM, SMALL).
+         * @param _x The initial x-coordinate.
+         * @param _y The initial y-coordinate.
+         * @param rng The stream the spin direction is drawn from.
+         * @return The rock state.
+         */
+        static RockRow NewRow(const State _state, const GLfloat _x, const GLfloat _y, CounterRng &rng);
+
+        /**
+         * @brief Initialize the velocity and spin of a rock which has not started moving yet.
+         * @param rock The rock state.
+         * @param _velocityAngle The angle of the velocity vector.
+         * @param _speed The speed added to the velocity vector.
+         * @param _spin The spin velocity added to the rock.
          */
-        static void RegisterSerializationResources(const std::string_view key);
+        static void Initialize(RockRow &rock, const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin);
 
         /**
-         * @brief Register loading resources for the rock.
-         * @param key The loading key.
+         * @brief Spin, move and wrap around a range of rocks.
+         * @param rocks The rock columns.
+         * @param begin The first row to update.
+         * @param end One past the last row to update.
+         * @param bounds The world bounds the rocks wrap around in.
          */
-        static void RegisterPersistenceResources(const std::string_view key);
+        static void UpdateRocks(RockArchetype &rocks, const size_t begin, const size_t end, const WorldBounds &bounds);
 
         /**
-         * @brief Update the rock's position and spin.
-         * @param _velocityAngle The velocity angle.
-         * @param _speed The speed of the rock.
-         * @param _spin The spinning rate.
+         * @brief Draw the rocks of a snapshot.
+         * @param snapshot The snapshot to draw.
          */
-        void Update(const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin);
+        static void DrawRocks(const RenderSnapshot &snapshot);
 
         /**
-         * @brief Draw the rock.
+         * @brief Gather the state of this rock into a row for the entity store.
+         * @return The rock state. The handle is parsed from the key and is null for keys which were not derived from one.
          */
-        void Draw() override;
+        RockRow ToRow();
 
         /**
          * @brief Get the current spin of the rock.
@@ -195,40 +208,19 @@ namespace asteroids
          */
         static std::string RockPrefix();
 
-    private:
-        /**
-         * @brief Helper function to initialize this object.
-         * @param _velocityAngle The angle of the velocity vector.
-         * @param _speed The speed of the velocity vector.
-         * @param _spin The spin velocity of this object.
-         */
-        void InitializeRock(const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin);
-
-        /**
-         * @brief Update the spin per time step.
-         */
-        void UpdateSpin();
-
         /**
-         * @brief Move per time step.
+         * @brief Derive the persistence key of a rock from its handle.
+         * @param handle The handle of the rock.
+         * @return The rock key.
          */
-        void MoveRock();
+        static std::string RockKey(const EntityHandle handle);
 
-        /**
-         * @brief Teleport the rock to the other side of the screen if it moves out of bounds.
-         */
-        void WrapAroundMoveRock();
-
-        GLint index_;                 /**< Rock index in the game. */
-        GLfloat epsilon_;             /**< Small adjustment value for movement calculations. */
+    private:
         GLfloat spin_{0.0f};          /**< Rock spin value. */
         GLfloat spinEpsilon_{0.01f};  /**< Increment value for spin calculations. */
         GLint spinDirection_;         /**< Direction of the rock spin. */
         State state_;                 /**< Current state (size) of the rock. */
         bool rockInitialized_{false}; /**< Indicates whether the rock is initialized. */
-
-        Resource2DGLfloat rockVertices_; /**< Vertices of the rock shape. */
-        ResourceGLubyte rockIndices_;    /**< Indices for rendering the rock. */
     };
 
 } // end asteroids
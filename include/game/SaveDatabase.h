@@ -0,0 +1,166 @@
+/**
+ * @file SaveDatabase.h
+ * @brief Declaration of the SaveDatabase which persists entity matrices in one transaction per save.
+ */
+
+#ifndef asteroids_save_database_h
+#define asteroids_save_database_h
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "configuration/config.h"
+#include "gl/Mat4.h"
+#include "gl/Mat4Resource.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace asteroids
+{
+
+    /**
+     * @class SaveDatabase
+     * @brief A long-lived SQLite connection which holds the matrices of every saved entity.
+     *
+     * The connection is opened once and kept open in WAL mode. The writes of a save are batched between Begin
+     * and Commit, then applied in one transaction through statements prepared when the connection opened, so
+     * a save costs one commit rather than one per matrix. Batching also keeps the transaction clear of the
+     * writes the entity persister makes to the same file on its own connection. Matrices are stored under the
+     * same keys the resource persister used, and saves which predate the table, which then holds no matrix,
+     * are still loaded through the resource loader.
+     *
+     * The entity persister commits a save's hierarchy on its own connection, so the two cannot share a
+     * transaction. A save commits its matrices first and the hierarchy after them, then deletes the matrices
+     * of removed entities in a second batch. A matrix named by a hierarchy but absent from a table which
+     * holds matrices is reported missing, and the load it belongs to fails rather than proceed without it.
+     *
+     * Saves run on the save writer thread and loads on the simulation thread, never at the same time.
+     */
+    class ASTEROIDS_DLL_EXPORT SaveDatabase
+    {
+    public:
+        /**
+         * @brief Get the database.
+         * @return The database.
+         */
+        static SaveDatabase *GetInstance();
+
+        /**
+         * @brief Destructor. Closes the connection.
+         */
+        ~SaveDatabase() noexcept;
+
+        SaveDatabase(const SaveDatabase &) = delete;
+        SaveDatabase &operator=(const SaveDatabase &) = delete;
+
+        /**
+         * @brief Open the connection unless it is already open on the path.
+         * @param path The path of the database.
+         * @return true if the connection is open and its statements are prepared; false otherwise.
+         */
+        bool Open(const std::filesystem::path &path);
+
+        /**
+         * @brief Close the connection.
+         */
+        void Close();
+
+        /**
+         * @brief Check if the connection is open.
+         * @return true if the connection is open; false otherwise.
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief Begin the batch of a save.
+         */
+        void Begin();
+
+        /**
+         * @brief Apply the batch of a save in one transaction.
+         * @return true if every write of the save is committed; false if the save was rolled back.
+         */
+        bool Commit();
+
+        /**
+         * @brief Add the write of a matrix to the batch.
+         * @param key The resource key.
+         * @param resource The matrix.
+         */
+        void Persist(const std::string &key, const Mat4Resource &resource);
+
+        /**
+         * @brief Load a matrix, or its resource if the save predates the matrix table.
+         * @param key The resource key.
+         * @param resource The matrix to load into. It is left as it is if the matrix is missing.
+         * @return true if the matrix was loaded; false if it is missing.
+         */
+        bool Load(const std::string &key, Mat4Resource &resource);
+
+        /**
+         * @brief Read every matrix in one pass over the table.
+         * @return The matrices by resource key; empty if the connection is closed.
+         */
+        std::unordered_map<std::string, Mat4> LoadAll();
+
+        /**
+         * @brief Add the deletion of a matrix to the batch.
+         * @param key The resource key.
+         */
+        void Unpersist(const std::string &key);
+
+    private:
+        /**
+         * @struct Write
+         * @brief A batched write.
+         */
+        struct Write
+        {
+            std::string key; /**< The resource key. */
+            Mat4 matrix;     /**< The matrix to write. */
+            bool erase;      /**< Set to delete the matrix instead. */
+        };
+
+        SaveDatabase() = default;
+
+        /**
+         * @brief Run a batched write.
+         * @param write The write.
+         * @return true if the write ran; false otherwise.
+         */
+        bool Apply(const Write &write);
+
+        /**
+         * @brief Check if the matrix table holds any matrix, which saves predating it never wrote.
+         * @return true if a matrix was persisted; false otherwise.
+         */
+        bool HasMatrices();
+
+        /**
+         * @brief Run a statement which returns no rows.
+         * @param sql The statement.
+         * @return true if the statement ran; false otherwise.
+         */
+        bool Execute(const char *sql);
+
+        /**
+         * @brief Finalize the prepared statements.
+         */
+        void Finalize();
+
+        sqlite3 *connection_{nullptr};     /**< The connection. */
+        std::filesystem::path path_;       /**< Path the connection is open on. */
+        std::vector<Write> batch_;         /**< Writes of the current save. */
+        sqlite3_stmt *persist_{nullptr};   /**< Upserts a matrix. */
+        sqlite3_stmt *load_{nullptr};      /**< Selects a matrix. */
+        sqlite3_stmt *unpersist_{nullptr}; /**< Deletes a matrix. */
+        sqlite3_stmt *any_{nullptr};       /**< Selects whether any matrix exists. */
+        sqlite3_stmt *loadAll_{nullptr};   /**< Selects every matrix. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_save_database_h
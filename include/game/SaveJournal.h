@@ -0,0 +1,93 @@
+/**
+ * @file SaveJournal.h
+ * @brief Declaration of the SaveJournal which remembers what each save already wrote.
+ */
+
+#ifndef asteroids_save_journal_h
+#define asteroids_save_journal_h
+
+#include <functional>
+#include <map>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "configuration/config.h"
+#include "game/BlobStore.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class SaveJournal
+     * @brief Tracks the digest of every entity resource as last written or loaded.
+     *
+     * Entities ask the journal before writing a resource, and only resources whose digest changed since the last
+     * save are written again. Entities which are removed are forgotten, so an entity later created under the same
+     * key is written in full. The journal is shared by the simulation thread, which forgets removed entities,
+     * and the thread writing saves. An entity forgotten while a save is written may be recorded again by that
+     * save, so it is forgotten once more when the save ends.
+     */
+    class ASTEROIDS_DLL_EXPORT SaveJournal
+    {
+    public:
+        /**
+         * @brief Get the journal.
+         * @return The journal.
+         */
+        static SaveJournal *GetInstance();
+
+        /**
+         * @brief Record the digest of a resource about to be saved.
+         * @param entityKey The key of the entity owning the resource.
+         * @param resourceKey The key of the resource.
+         * @param digest The digest of the resource's payload.
+         * @return true if the resource changed since it was last saved or loaded; false otherwise.
+         */
+        bool Changed(const std::string_view entityKey, const std::string_view resourceKey, const BlobStore::Digest digest);
+
+        /**
+         * @brief Record the digest of a resource which was loaded.
+         * @param entityKey The key of the entity owning the resource.
+         * @param resourceKey The key of the resource.
+         * @param digest The digest of the resource's payload.
+         */
+        void Record(const std::string_view entityKey, const std::string_view resourceKey, const BlobStore::Digest digest);
+
+        /**
+         * @brief Forget the resources of an entity.
+         * @param entityKey The key of the entity.
+         */
+        void Forget(const std::string_view entityKey);
+
+        /**
+         * @brief Forget every resource, so the next save writes everything.
+         */
+        void Clear();
+
+        /**
+         * @brief Mark a save as being written. Called before the save is captured.
+         */
+        void BeginSave();
+
+        /**
+         * @brief Mark a save as written, forgetting again the entities forgotten while it was being written.
+         */
+        void EndSave();
+
+    private:
+        using Digests = std::map<std::string, BlobStore::Digest, std::less<>>;
+
+        SaveJournal() = default;
+
+        std::mutex mutex_;                                     /**< Guards the digests. */
+        std::map<std::string, Digests, std::less<>> entities_; /**< Resource digests by entity key. */
+        std::set<std::string, std::less<>> forgotten_;         /**< Entities forgotten while a save is written. */
+        size_t saving_{0};                                     /**< Saves being written. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_save_journal_h
@@ -0,0 +1,96 @@
+/**
+ * @file SaveWriter.h
+ * @brief Declaration of the SaveWriter which writes saves on a background thread.
+ */
+
+#ifndef asteroids_save_writer_h
+#define asteroids_save_writer_h
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class SaveWriter
+     * @brief Runs one save job at a time on a dedicated thread.
+     *
+     * A job holds everything it writes, captured by the simulation thread at a time step boundary, so
+     * the simulation carries on while the job runs. A job is only accepted while the writer is idle;
+     * the caller keeps a refused request and captures it again once the writer is done, so requests
+     * made faster than saves complete coalesce into one save of the latest state. A job reports whether
+     * it was written, and the caller takes that result once the job has finished.
+     */
+    class ASTEROIDS_DLL_EXPORT SaveWriter
+    {
+    public:
+        /**
+         * @brief A save which only touches the state it captured. It returns true if the save was written.
+         */
+        using Job = std::function<bool()>;
+
+        /**
+         * @brief Constructor. Starts the writer thread.
+         */
+        SaveWriter();
+
+        /**
+         * @brief Destructor. Finishes the accepted job, if any, and joins the writer thread.
+         */
+        ~SaveWriter();
+
+        SaveWriter(const SaveWriter &) = delete;
+        SaveWriter &operator=(const SaveWriter &) = delete;
+        SaveWriter(SaveWriter &&) = delete;
+        SaveWriter &operator=(SaveWriter &&) = delete;
+
+        /**
+         * @brief Hand a job to the writer thread if it is idle.
+         * @param job The job.
+         * @return true if the job was accepted; false if another job has not finished yet.
+         */
+        bool TrySubmit(Job job);
+
+        /**
+         * @brief Check if a job is being written.
+         *
+         * Only the thread submitting jobs makes the writer busy, so an idle writer accepts that thread's next job.
+         * @return true if a job has not finished yet; false if the writer is idle.
+         */
+        bool Busy();
+
+        /**
+         * @brief Block until the accepted job has finished.
+         */
+        void Wait();
+
+        /**
+         * @brief Take the result of the last job which finished.
+         * @return Whether the job was written; empty if no job finished since the result was last taken.
+         */
+        std::optional<bool> TakeResult();
+
+    private:
+        /**
+         * @brief The loop of the writer thread.
+         */
+        void Loop();
+
+        std::mutex mutex_;              /**< Guards the job and the stop flag. */
+        std::condition_variable ready_; /**< Signalled when a job is accepted or the writer stops. */
+        std::condition_variable idle_;  /**< Signalled when the job has finished. */
+        Job job_;                       /**< The accepted job, empty while the writer is idle. */
+        std::optional<bool> result_;    /**< Result of the last finished job, until it is taken. */
+        bool stopping_{false};          /**< Set to stop the writer thread. */
+        std::thread thread_;            /**< The writer thread. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_save_writer_h
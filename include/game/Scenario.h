@@ -0,0 +1,75 @@
+/**
+ * @file Scenario.h
+ * @brief Declaration of the Scenario which describes the world a game is reset to and the load it runs under.
+ */
+
+#ifndef asteroids_scenario_h
+#define asteroids_scenario_h
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "configuration/config.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "gl/GLEntity.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct Scenario
+     * @brief The rocks a game is reset to, the rocks spawned in waves after it and the bullets fired into it.
+     *
+     * The default scenario is the classic game: ten large rocks around the ship and six bullets in flight
+     * at most. Every random draw of a scenario comes from the game's counter based streams, so a scenario
+     * under a seed always generates the same world.
+     *
+     * A scenario is written on the command line as comma separated settings, for example
+     * "rocks=100000,sizes=1:2:4,speed=0.01:0.05,radius=0,wave=500/2,fire=30,bullets=256":
+     * - rocks=N: rocks spawned on reset, at least one since a game without rocks is reset.
+     * - sizes=L:M:S: relative chance of a rock being large, medium or small.
+     * - speed=MIN:MAX and spin=MIN:MAX: ranges the speed and spin of a rock are drawn from.
+     * - radius=R: rocks spawn within R of the center on both axes; 0 spawns them over the whole world.
+     * - clearance=C: rocks spawn no closer than C to the ship on either axis.
+     * - wave=N/SECONDS: rocks spawned every SECONDS after a reset.
+     * - fire=RATE: bullets fired per second without input.
+     * - bullets=N: most bullets in flight at once.
+     */
+    struct ASTEROIDS_DLL_EXPORT Scenario
+    {
+        size_t rocks{10};                                     /**< Rocks spawned on reset. */
+        std::array<GLfloat, 3> sizeWeights{1.0f, 0.0f, 0.0f}; /**< Relative chance of a large, medium and small rock. */
+        GLfloat minSpeed{0.0f};                               /**< Lowest rock speed. */
+        GLfloat maxSpeed{0.02f};                              /**< Highest rock speed. */
+        GLfloat minSpin{0.0f};                                /**< Lowest rock spin increment. */
+        GLfloat maxSpin{0.05f};                               /**< Highest rock spin increment. */
+        GLfloat radius{15.0f};                                /**< Rocks spawn within this distance of the center on both axes; 0 for the whole world. */
+        GLfloat clearance{3.0f};                              /**< Rocks spawn no closer than this to the ship on either axis. */
+        size_t waveRocks{0};                                  /**< Rocks spawned by each wave. */
+        GLfloat waveSeconds{0.0f};                            /**< Time between waves; 0 for no waves. */
+        GLfloat fireRate{0.0f};                               /**< Bullets fired per second without input. */
+        size_t maxBullets{6};                                 /**< Most bullets in flight at once. */
+
+        /**
+         * @brief Parse a scenario from its command line form.
+         * @param spec The comma separated settings. Settings which are left out keep their classic value.
+         * @return The scenario, or std::nullopt if a setting is unknown or out of range.
+         */
+        static std::optional<Scenario> Parse(const std::string_view spec);
+
+        /**
+         * @brief Generate a rock.
+         * @param rng The stream to draw from.
+         * @param bounds The bounds of the world the rock spawns in.
+         * @return The rock state, with its velocity initialized.
+         */
+        RockRow MakeRock(CounterRng &rng, const WorldBounds &bounds) const;
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_scenario_h
@@ -7,16 +7,14 @@
 #define asteroids_ship_h
 
 #include <array>
-#include <future>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <numbers>
-#include <set>
 #include <string>
 #include <string_view>
 #include <vector>
 
-#include <boost/asio/thread_pool.hpp>
 #include <boost/property_tree/ptree.hpp>
 
 #include "test_filesystem_adapters/ContainerResource.h"
@@ -24,6 +22,9 @@
 
 #include "configuration/config.h"
 #include "game/Bullet.h"
+#include "game/EntityStore.h"
+#include "game/RenderSnapshot.h"
+#include "game/TaskScheduler.h"
 #include "gl/GLEntity.h"
 
 namespace database_adapters
@@ -38,6 +39,25 @@ namespace asteroids
     using ResourceGLfloat = ContainerResource<GLfloat>;
     using Resource2DGLfloat = ContainerResource2D<GLfloat>;
 
+    /**
+     * @struct ShipRow
+     * @brief The state of the ship, used to move the ship in and out of a snapshot pack.
+     */
+    struct ShipRow
+    {
+        Mat4 frame;                     /**< Matrix representing the ship geometry. */
+        Mat4 unitVelocity;              /**< Unit velocity matrix. */
+        Mat4 S;                         /**< Scale transformation matrix. */
+        Mat4 T;                         /**< Translation transformation matrix. */
+        Mat4 R;                         /**< Rotation transformation matrix. */
+        Mat4 unitOrientation;           /**< Unit orientation matrix. */
+        GLfloat velocityAngle{0.0f};    /**< Velocity angle. */
+        GLfloat speed{0.0f};            /**< Speed of the ship. */
+        GLfloat mass{1.0f};             /**< Mass of the ship. */
+        GLfloat orientationAngle{0.0f}; /**< Orientation angle. */
+        bool bulletFired{false};        /**< Indicates whether a bullet was fired this time step. */
+    };
+
     /**
      * @class Ship
      * @brief A class representing the player's ship in the Asteroids game.
@@ -58,6 +78,12 @@ namespace asteroids
          */
         Ship(const std::string_view key);
 
+        /**
+         * @brief Constructor materializing the ship from its row in a snapshot pack.
+         * @param row The ship state.
+         */
+        explicit Ship(const ShipRow &row);
+
         /**
          * @brief Destructor for the Ship class.
          */
@@ -83,32 +109,20 @@ namespace asteroids
          */
         Ship &operator=(Ship &&) noexcept;
 
-        /**
-         * @brief Register serialization resources for the ship.
-         * @param key The serialization key.
-         */
-        static void RegisterSerializationResources(const std::string_view key);
-
-        /**
-         * @brief Register loading resources for the ship.
-         * @param key The loading key.
-         */
-        static void RegisterPersistenceResources(const std::string_view key);
-
         /**
          * @brief Update the ship's position, orientation, and bullets.
          * @param _orientationAngle The angle to rotate the ship.
          * @param _thrust The thrust to apply to the ship.
-         * @param serializedKeys Keys of serialized objects.
-         * @param threadPool Thread pool for concurrent processing.
-         * @param futures Vector of futures for parallel execution.
+         * @param bounds The world bounds the ship wraps around in.
+         * @param bullets The bullet columns of the entity store.
+         * @param scheduler The scheduler the bullets are updated on.
          */
         void Update(
             const GLfloat _orientationAngle,
             const GLfloat _thrust,
-            const std::set<std::string, std::less<>> &serializedKeys,
-            boost::asio::thread_pool &threadPool,
-            std::vector<std::future<std::shared_ptr<GLEntity>>> &futures);
+            const WorldBounds &bounds,
+            BulletArchetype &bullets,
+            TaskScheduler &scheduler);
 
         /**
          * @brief Draw the ship.
@@ -116,15 +130,23 @@ namespace asteroids
         void Draw() override;
 
         /**
-         * @brief Fire a bullet from the ship.
+         * @brief Draw the ship of a snapshot.
+         * @param snapshot The snapshot to draw.
          */
-        void Fire();
+        static void DrawShip(const RenderSnapshot &snapshot);
 
         /**
-         * @brief Get the current number of bullets.
-         * @return The number of bullets.
+         * @brief Copy the transform of the ship into a snapshot.
+         * @param snapshot The snapshot to fill.
          */
-        static GLint BulletNumber();
+        void Snapshot(RenderSnapshot &snapshot);
+
+        /**
+         * @brief Fire a bullet from the ship.
+         * @param bullets The bullet columns of the entity store.
+         * @param maxBullets The most bullets in flight at once; nothing is fired while that many are.
+         */
+        void Fire(BulletArchetype &bullets, const size_t maxBullets);
 
         /**
          * @brief Get a Bullet entity by key.
@@ -140,21 +162,10 @@ namespace asteroids
         std::vector<Key> GetBulletKeys() const;
 
         /**
-         * @brief Get all Bullet entity by keys which have gone out of scope.
-         * @return All Bullet entity keys which have gone out of scope.
+         * @brief Remove a Bullet by entity key.
+         * @param key The key by which the Bullet is aggregated.
          */
-        const std::set<Key, std::less<>> &GetOutOfScopeBulletKeys() const;
-
-        /**
-         * @brief Clear all Bullet entity by keys which have gone out of scope.
-         */
-        void ClearOutOfScopeBulletKeys();
-
-        /**
-         * @brief Remove a Bullet by entity key and clear serialized keys since the last save operation.
-         * @param serializedKeys The entity keys which have been serialized last.
-         */
-        void RemoveBullet(const std::string_view key, const std::set<std::string, std::less<>> &serializedKeys);
+        void RemoveBullet(const std::string_view key);
 
         /**
          * @brief Add a Bullet by entity.
@@ -190,6 +201,11 @@ namespace asteroids
          */
         void Load(boost::property_tree::ptree &tree, database_adapters::Sqlite &database) override;
 
+        /**
+         * @brief Add the changed matrices of the ship, including its orientation, to the batch of the save database.
+         */
+        void PersistMatrices() const override;
+
         /**
          * @brief Get the unique key for the ship.
          * @return The ship's key as a string.
@@ -200,27 +216,15 @@ namespace asteroids
          * @brief Return the orientation unit matrix.
          * @return The orientation matrix.
          */
-        const Resource2DGLfloat &GetUnitOrientation() const;
+        const Mat4Resource &GetUnitOrientation() const;
 
         /**
-         * @brief Return the ship vertices.
-         * @return The vertices matrix.
+         * @brief Gather the state of the ship into a row for a snapshot pack.
+         * @return The ship state.
          */
-        const Resource2DGLfloat &GetShipVertices() const;
-
-        /**
-         * @brief Return the ship indices.
-         * @return The indices array.
-         */
-        const ResourceGLubyte &GetShipIndices() const;
+        ShipRow ToRow();
 
     private:
-        /**
-         * @brief Generate a unique identifier for the ship.
-         * @return A unique identifier string.
-         */
-        std::string GenerateUUID() const;
-
         /**
          * @brief Recompute the ship velocity given the added thrust.
          * @param _thrust The added thrust to the ship.
@@ -239,35 +243,22 @@ namespace asteroids
 
         /**
          * @brief Teleport the ship if it moves out of bounds per time step.
+         * @param bounds The world bounds.
          */
-        void WrapAroundMoveShip();
+        void WrapAroundMoveShip(const WorldBounds &bounds);
 
         /**
          * @brief Update the bullets per time step.
-         * @param serializedKeys The set of bullet keys to serialize on save operation.
-         * @param threadPool The thread pool for parallel bullet calculations.
-         * @param futures The vector of calculation futures to be returned.
+         * @param bullets The bullet columns of the entity store.
+         * @param bounds The world bounds outside of which bullets expire.
+         * @param scheduler The scheduler the bullets are updated on.
          */
-        void UpdateBullets(
-            const std::set<std::string, std::less<>> &serializedKeys,
-            boost::asio::thread_pool &threadPool,
-            std::vector<std::future<std::shared_ptr<GLEntity>>> &futures);
-
-        /**
-         * @brief Update the bullets per time step.
-         * @param sharedBullet The entity to update.
-         */
-        void UpdateBulletTask(std::shared_ptr<Bullet> sharedBullet);
-
-        mutable std::set<std::string, std::less<>> outOfScopeBulletKeys_;
+        void UpdateBullets(BulletArchetype &bullets, const WorldBounds &bounds, TaskScheduler &scheduler);
 
         bool bulletFired_{false};
-        bool doRotate_{false};
         GLfloat orientationAngle_{static_cast<GLfloat>(std::numbers::pi) / 2};
 
-        Resource2DGLfloat unitOrientation_;
-        Resource2DGLfloat shipVertices_;
-        ResourceGLubyte shipIndices_;
+        Mat4Resource unitOrientation_;
     };
 
 } // end asteroids
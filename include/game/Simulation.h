@@ -0,0 +1,165 @@
+/**
+ * @file Simulation.h
+ * @brief Declaration of the Simulation class which runs the game on its own thread.
+ */
+
+#ifndef asteroids_simulation_h
+#define asteroids_simulation_h
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/Asteroids.h"
+#include "game/IRenderer.h"
+#include "game/RenderSnapshot.h"
+#include "game/TripleBuffer.h"
+#include "gl/GLEntity.h"
+
+namespace asteroids
+{
+
+    class InputRecorder;
+
+    /**
+     * @enum Command
+     * @brief Input handed from the GUI thread to the simulation thread.
+     */
+    enum class Command
+    {
+        ROTATE_LEFT,
+        ROTATE_RIGHT,
+        THRUST,
+        FIRE,
+        RESET,
+        SERIALIZE,
+        DESERIALIZE
+    };
+
+    /**
+     * @class Simulation
+     * @brief Runs the game at its fixed time step on a dedicated thread.
+     *
+     * Input is queued as commands which the simulation thread applies before its next time step.
+     * After every time step the thread writes a RenderSnapshot into a triple buffer, so the GUI
+     * thread draws the latest snapshot without locks and without waiting for the simulation.
+     *
+     * A simulation which is never started is advanced frame by frame by its driver instead, which is
+     * how recorded sessions are replayed at unbounded speed. Such a simulation, like a recorded one,
+     * ignores saves and loads, so it never touches the saved game.
+     */
+    class ASTEROIDS_DLL_EXPORT Simulation
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param game The game to simulate. It is only touched by the simulation thread once started.
+         * @param renderer The renderer which draws the snapshots on the GUI thread.
+         */
+        Simulation(std::shared_ptr<Asteroids> game, IRenderer &renderer);
+
+        /**
+         * @brief Destructor. Stops the simulation thread.
+         */
+        ~Simulation();
+
+        Simulation(const Simulation &) = delete;
+        Simulation(Simulation &&) = delete;
+        Simulation &operator=(const Simulation &) = delete;
+        Simulation &operator=(Simulation &&) = delete;
+
+        /**
+         * @brief Start the simulation thread. It loads the saved game before the first time step, unless
+         * the session is recorded or a new game was asked for.
+         */
+        void Start();
+
+        /**
+         * @brief Record the input of the session. Called before Start.
+         *
+         * A recorded session starts from a new game under a fresh seed rather than from the saved game,
+         * and neither saves nor loads.
+         * @param path The path of the recording.
+         * @param scenario The scenario the game is set to, in its command line form.
+         * @return true if the recording was started; false otherwise.
+         */
+        bool Record(const std::filesystem::path &path, const std::string_view scenario);
+
+        /**
+         * @brief Start from a new game rather than from the saved game. Called before Start.
+         */
+        void NewGame();
+
+        /**
+         * @brief Stop and join the simulation thread.
+         */
+        void Stop();
+
+        /**
+         * @brief Queue a command for the next time step.
+         * @param command The command.
+         */
+        void Post(const Command command);
+
+        /**
+         * @brief Queue new world bounds for the next time step.
+         * @param bounds The bounds.
+         */
+        void Resize(const WorldBounds &bounds);
+
+        /**
+         * @brief Run one frame: apply the queued input, step the game and publish its snapshot.
+         *
+         * Called by the simulation thread, or by a driver of a simulation which is never started.
+         */
+        void Advance();
+
+        /**
+         * @brief Draw the latest snapshot with the renderer. Called on the thread which owns the graphics context.
+         */
+        void Draw();
+
+    private:
+        /**
+         * @brief The loop of the simulation thread.
+         */
+        void Loop();
+
+        /**
+         * @brief Apply the queued commands and bounds to the game.
+         */
+        void ApplyCommands();
+
+        /**
+         * @brief Apply one command to the game.
+         * @param command The command.
+         */
+        void Execute(const Command command);
+
+        std::shared_ptr<Asteroids> game_;         /**< The simulated game. */
+        IRenderer &renderer_;                     /**< Draws the snapshots. */
+        std::unique_ptr<InputRecorder> recorder_; /**< Records the input, if the session is recorded. */
+        std::uint64_t frame_{0};                  /**< Frames run so far. */
+        bool newGame_{false};                     /**< Set to start from a new game rather than the saved game. */
+        std::thread thread_;                      /**< The simulation thread. */
+        std::atomic<bool> running_{false};        /**< Cleared to stop the simulation thread. */
+
+        std::mutex commandMutex_;                 /**< Guards the queued commands and bounds. */
+        std::vector<Command> commands_;           /**< Commands queued by the GUI thread. */
+        std::vector<Command> executing_;          /**< Commands being applied by the simulation thread. */
+        std::optional<WorldBounds> bounds_;       /**< Bounds queued by the GUI thread. */
+        std::optional<WorldBounds> drawnBounds_;  /**< Bounds last queued, owned by the GUI thread. */
+
+        TripleBuffer<RenderSnapshot> snapshots_;  /**< Snapshots handed to the GUI thread. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_simulation_h
@@ -0,0 +1,144 @@
+/**
+ * @file SnapshotPack.h
+ * @brief Declaration of the SnapshotPack which saves the game to a single binary file.
+ */
+
+#ifndef asteroids_snapshot_pack_h
+#define asteroids_snapshot_pack_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/EntityStore.h"
+#include "game/Ship.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct GameRow
+     * @brief The state of the game itself, saved in the pack header.
+     */
+    struct GameRow
+    {
+        GLint score{0};                 /**< Score of the game. */
+        GLfloat orientationAngle{0.0f}; /**< Orientation angle input. */
+        GLfloat thrust{0.0f};           /**< Thrust input. */
+    };
+
+    /**
+     * @class SnapshotPack
+     * @brief A versioned, single file binary snapshot of the game.
+     *
+     * The pack is a fixed size header followed by a table of rock rows, a table of bullet rows and the
+     * ship row. Every field is stored little-endian at a fixed offset, so the pack is written in one
+     * sequential stream and read straight from a memory mapping. Rows are only decoded when accessed.
+     */
+    class ASTEROIDS_DLL_EXPORT SnapshotPack
+    {
+    public:
+        static constexpr std::uint32_t VERSION = 1; /**< Version of the layout written by Write. */
+
+        /**
+         * @brief Write a pack, replacing any pack at the path once it is complete.
+         * @param path The path of the pack.
+         * @param game The game state.
+         * @param rocks The rock columns.
+         * @param bullets The bullet columns.
+         * @param ship The ship state, or nullptr if the ship was destroyed.
+         * @return true if the pack was written; false otherwise.
+         */
+        static bool Write(
+            const std::string &path,
+            const GameRow &game,
+            const RockArchetype &rocks,
+            const BulletArchetype &bullets,
+            const ShipRow *ship);
+
+        /**
+         * @brief Constructor.
+         */
+        SnapshotPack();
+
+        /**
+         * @brief Destructor. Unmaps the pack.
+         */
+        ~SnapshotPack() noexcept;
+
+        SnapshotPack(const SnapshotPack &) = delete;
+        SnapshotPack &operator=(const SnapshotPack &) = delete;
+
+        /**
+         * @brief Map a pack and validate its header.
+         * @param path The path of the pack.
+         * @return true if the pack is mapped and its layout is valid; false otherwise.
+         */
+        bool Open(const std::string &path);
+
+        /**
+         * @brief Unmap the pack.
+         */
+        void Close();
+
+        /**
+         * @brief Get the game state.
+         * @return The game state.
+         */
+        GameRow GetGame() const;
+
+        /**
+         * @brief Get the number of rocks.
+         * @return The number of rock rows.
+         */
+        size_t GetRockCount() const;
+
+        /**
+         * @brief Decode a rock.
+         * @param row The index of the rock row.
+         * @return The rock state.
+         */
+        RockRow GetRock(const size_t row) const;
+
+        /**
+         * @brief Get the number of bullets.
+         * @return The number of bullet rows.
+         */
+        size_t GetBulletCount() const;
+
+        /**
+         * @brief Decode a bullet.
+         * @param row The index of the bullet row.
+         * @return The bullet state.
+         */
+        BulletRow GetBullet(const size_t row) const;
+
+        /**
+         * @brief Check if the pack holds a ship.
+         * @return true if the ship was alive when the pack was written; false otherwise.
+         */
+        bool HasShip() const;
+
+        /**
+         * @brief Decode the ship.
+         * @return The ship state.
+         */
+        ShipRow GetShip() const;
+
+    private:
+        const unsigned char *data_{nullptr}; /**< Mapped bytes of the pack. */
+        size_t bytes_{0};                    /**< Number of mapped bytes. */
+        std::vector<unsigned char> buffer_;  /**< Bytes read where mapping is unavailable. */
+
+        size_t rockCount_{0};     /**< Number of rock rows. */
+        size_t bulletCount_{0};   /**< Number of bullet rows. */
+        size_t rocksOffset_{0};   /**< Offset of the rock table. */
+        size_t bulletsOffset_{0}; /**< Offset of the bullet table. */
+        size_t shipOffset_{0};    /**< Offset of the ship row, or 0 without a ship. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_snapshot_pack_h
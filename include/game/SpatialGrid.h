@@ -0,0 +1,141 @@
+/**
+ * @file SpatialGrid.h
+ * @brief Declaration of the SpatialGrid class, a uniform grid broadphase over the rocks of the game.
+ */
+
+#ifndef asteroids_spatial_grid_h
+#define asteroids_spatial_grid_h
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/EntityStore.h"
+#include "game/TaskScheduler.h"
+#include "gl/GLEntity.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class SpatialGrid
+     * @brief A uniform grid which buckets rock rows by the cell their center falls in.
+     *
+     * Cells are at least as wide as the largest collision radius, so every rock which can
+     * collide with a point is in the point's cell or one of its eight neighbours. Positions
+     * outside of the grid are clamped onto its border cells, which keeps that guarantee.
+     *
+     * The centers and sizes of the rocks are copied in cell order, so a neighbourhood is
+     * handed out as packed runs which the CollisionKernel tests in blocks.
+     */
+    class ASTEROIDS_DLL_EXPORT SpatialGrid
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param cellSize The width of a cell, no smaller than the largest collision radius.
+         */
+        explicit SpatialGrid(const GLfloat cellSize);
+
+        /**
+         * @brief Rebuild the grid from the current rock positions.
+         *
+         * Large stores are bucketed in parallel chunks on the task scheduler.
+         * @param rocks The rock columns.
+         * @param bounds The world bounds the rocks move in.
+         * @param scheduler The scheduler to build on.
+         */
+        void Build(const RockArchetype &rocks, const WorldBounds &bounds, TaskScheduler &scheduler);
+
+        /**
+         * @brief Visit the rocks in the 3x3 cell neighbourhood of a position as packed runs.
+         *
+         * Each row of three neighbouring cells is one run. The visitor is called with the rock rows,
+         * centers and sizes of the run and returns true to stop the visit.
+         * @param x The x-coordinate of the position.
+         * @param y The y-coordinate of the position.
+         * @param visitor Called as visitor(rows, xs, ys, states, count).
+         * @return true if the visitor stopped the visit; false otherwise.
+         */
+        template <typename Visitor>
+        bool VisitRuns(const GLfloat x, const GLfloat y, Visitor &&visitor) const;
+
+    private:
+        /**
+         * @brief Get the clamped cell column of an x-coordinate.
+         * @param x The x-coordinate.
+         * @return The cell column.
+         */
+        size_t CellColumn(const GLfloat x) const;
+
+        /**
+         * @brief Get the clamped cell row of a y-coordinate.
+         * @param y The y-coordinate.
+         * @return The cell row.
+         */
+        size_t CellRow(const GLfloat y) const;
+
+        /**
+         * @brief Compute the cells of a range of rocks and count them per cell.
+         * @param rocks The rock columns.
+         * @param chunk The index of the chunk.
+         * @param begin The first row of the chunk.
+         * @param end One past the last row of the chunk.
+         */
+        void CountChunk(const RockArchetype &rocks, const size_t chunk, const size_t begin, const size_t end);
+
+        /**
+         * @brief Scatter a range of rocks into their cells.
+         * @param rocks The rock columns.
+         * @param chunk The index of the chunk.
+         * @param begin The first row of the chunk.
+         * @param end One past the last row of the chunk.
+         */
+        void ScatterChunk(const RockArchetype &rocks, const size_t chunk, const size_t begin, const size_t end);
+
+        GLfloat cellSize_;                /**< Width of a cell. */
+        GLfloat minX_{0.0f};              /**< Left edge of the grid. */
+        GLfloat minY_{0.0f};              /**< Bottom edge of the grid. */
+        size_t cellColumns_{1};           /**< Number of cell columns. */
+        size_t cellRows_{1};              /**< Number of cell rows. */
+        size_t chunks_{1};                /**< Number of chunks of the last build. */
+        std::vector<size_t> cellOfRock_;  /**< Cell of each rock row. */
+        std::vector<size_t> chunkCounts_; /**< Per chunk cell counts, turned into per chunk cell offsets. */
+        std::vector<size_t> cellStart_;   /**< Offset of each cell's first entry, plus one past the last entry. */
+        std::vector<size_t> entries_;     /**< Rock rows sorted by cell. */
+        std::vector<GLfloat> entryX_;     /**< Rock center x-coordinates sorted by cell. */
+        std::vector<GLfloat> entryY_;     /**< Rock center y-coordinates sorted by cell. */
+        std::vector<State> entryState_;   /**< Rock sizes sorted by cell. */
+    };
+
+    template <typename Visitor>
+    bool SpatialGrid::VisitRuns(const GLfloat x, const GLfloat y, Visitor &&visitor) const
+    {
+        if (entries_.empty())
+            return false;
+
+        const size_t column = CellColumn(x);
+        const size_t row = CellRow(y);
+        const size_t firstColumn = column > 0 ? column - 1 : 0;
+        const size_t lastColumn = std::min(column + 1, cellColumns_ - 1);
+        const size_t firstRow = row > 0 ? row - 1 : 0;
+        const size_t lastRow = std::min(row + 1, cellRows_ - 1);
+
+        for (size_t cellRow = firstRow; cellRow <= lastRow; ++cellRow)
+        {
+            // the cells of a row are adjacent, so the three cells form one contiguous run of entries
+            const size_t first = cellStart_[cellRow * cellColumns_ + firstColumn];
+            const size_t last = cellStart_[cellRow * cellColumns_ + lastColumn + 1];
+            if (first == last)
+                continue;
+            if (visitor(&entries_[first], &entryX_[first], &entryY_[first], &entryState_[first], last - first))
+                return true;
+        }
+        return false;
+    }
+
+} // end namespace asteroids
+
+#endif // asteroids_spatial_grid_h
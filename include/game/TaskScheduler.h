@@ -0,0 +1,215 @@
+/**
+ * @file TaskScheduler.h
+ * @brief Declaration of the work-stealing task scheduler and the stage graph the game ticks on.
+ */
+
+#ifndef asteroids_task_scheduler_h
+#define asteroids_task_scheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    class TaskScheduler;
+
+    /**
+     * @class TaskGroup
+     * @brief Counts the submitted tasks of a group which have not finished yet and keeps the first
+     * exception one of them threw.
+     */
+    class ASTEROIDS_DLL_EXPORT TaskGroup
+    {
+    public:
+        /**
+         * @brief Check if every task of the group has finished.
+         * @return true if no task of the group is pending; false otherwise.
+         */
+        bool Done() const;
+
+    private:
+        friend class TaskScheduler;
+
+        /**
+         * @brief Keep the exception a task threw, unless an earlier one is kept already.
+         * @param error The exception.
+         */
+        void Fail(std::exception_ptr error);
+
+        std::atomic<size_t> pending_{0}; /**< Number of unfinished tasks. */
+        std::mutex errorMutex_;          /**< Guards the error. */
+        std::exception_ptr error_;       /**< The first exception a task threw. */
+    };
+
+    /**
+     * @class TaskScheduler
+     * @brief A fixed set of worker threads which run tasks from per-worker queues.
+     *
+     * Each worker pops its own queue from the back and steals from the front of the others when it
+     * runs dry. Threads outside of the scheduler submit to a shared queue. A thread waiting on a group
+     * runs pending tasks instead of sleeping, so tasks may submit and wait on nested work without
+     * starving a small pool.
+     */
+    class ASTEROIDS_DLL_EXPORT TaskScheduler
+    {
+    public:
+        /**
+         * @brief A unit of work.
+         */
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Constructor.
+         * @param workers The number of worker threads, besides the threads which wait on groups.
+         */
+        explicit TaskScheduler(const size_t workers);
+
+        /**
+         * @brief Destructor. Stops and joins the workers.
+         */
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler &) = delete;
+        TaskScheduler &operator=(const TaskScheduler &) = delete;
+        TaskScheduler(TaskScheduler &&) = delete;
+        TaskScheduler &operator=(TaskScheduler &&) = delete;
+
+        /**
+         * @brief Get the number of worker threads.
+         * @return The number of workers.
+         */
+        size_t WorkerCount() const;
+
+        /**
+         * @brief Submit a task to the queue of the calling thread.
+         * @param group The group the task is counted in.
+         * @param task The task.
+         */
+        void Submit(TaskGroup &group, Task task);
+
+        /**
+         * @brief Run pending tasks until every task of a group has finished.
+         *
+         * A task which throws still counts as finished. Once the whole group has finished, the first
+         * exception one of its tasks threw is rethrown from here.
+         * @param group The group to wait on.
+         */
+        void Wait(TaskGroup &group);
+
+    private:
+        /**
+         * @struct Entry
+         * @brief A queued task and the group it is counted in.
+         */
+        struct Entry
+        {
+            Task task;                  /**< The task. */
+            TaskGroup *group{nullptr};  /**< The group of the task. */
+        };
+
+        /**
+         * @struct Queue
+         * @brief A task queue owned by one thread and stolen from by the others.
+         */
+        struct Queue
+        {
+            std::mutex mutex;          /**< Guards the tasks. */
+            std::deque<Entry> tasks;   /**< Queued tasks. */
+        };
+
+        /**
+         * @brief Get the queue of the calling thread.
+         * @return The index of the queue.
+         */
+        size_t HomeQueue() const;
+
+        /**
+         * @brief Run one pending task, from the home queue first and stolen from another queue otherwise.
+         * @param home The index of the calling thread's queue.
+         * @return true if a task was run; false if every queue was empty.
+         */
+        bool RunOne(const size_t home);
+
+        /**
+         * @brief The loop of a worker thread.
+         * @param index The index of the worker's queue.
+         */
+        void WorkerLoop(const size_t index);
+
+        std::vector<std::unique_ptr<Queue>> queues_; /**< One queue per worker followed by the shared queue. */
+        std::vector<std::thread> workers_;           /**< Worker threads. */
+        std::atomic<size_t> queued_{0};              /**< Number of queued tasks. */
+        std::atomic<size_t> sleeping_{0};            /**< Number of idle workers waiting for tasks. */
+        std::atomic<bool> stop_{false};              /**< Set when the scheduler shuts down. */
+        std::mutex sleepMutex_;                      /**< Guards idle workers going to sleep. */
+        std::condition_variable wake_;               /**< Wakes idle workers. */
+    };
+
+    /**
+     * @class TaskGraph
+     * @brief A set of stages which run on a TaskScheduler once all of their dependencies have run.
+     */
+    class ASTEROIDS_DLL_EXPORT TaskGraph
+    {
+    public:
+        /**
+         * @brief Identifier of a stage.
+         */
+        using StageId = size_t;
+
+        /**
+         * @brief Add a stage.
+         * @param work The work of the stage.
+         * @param dependencies The stages which have to run before it.
+         * @return The identifier of the stage.
+         */
+        StageId AddStage(TaskScheduler::Task work, std::initializer_list<StageId> dependencies = {});
+
+        /**
+         * @brief Run every stage once. The calling thread runs stages until the whole graph is done.
+         *
+         * The stages depending on a stage which throws are skipped, and the first exception is rethrown
+         * once the running stages are done.
+         * @param scheduler The scheduler to run on.
+         */
+        void Run(TaskScheduler &scheduler);
+
+    private:
+        /**
+         * @struct Stage
+         * @brief A stage and the stages waiting on it.
+         */
+        struct Stage
+        {
+            TaskScheduler::Task work;            /**< The work of the stage. */
+            std::vector<StageId> dependents;     /**< Stages which depend on this one. */
+            size_t dependencyCount{0};           /**< Number of stages this one depends on. */
+            std::atomic<size_t> remaining{0};    /**< Dependencies which have not run yet in the current run. */
+        };
+
+        /**
+         * @brief Submit a stage which has no outstanding dependencies.
+         * @param scheduler The scheduler to run on.
+         * @param group The group of the current run.
+         * @param stage The stage.
+         */
+        void Schedule(TaskScheduler &scheduler, TaskGroup &group, const StageId stage);
+
+        std::deque<Stage> stages_; /**< Stages in the order they were added. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_task_scheduler_h
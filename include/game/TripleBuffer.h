@@ -0,0 +1,70 @@
+/**
+ * @file TripleBuffer.h
+ * @brief Declaration of the lock-free TripleBuffer which hands values from one writer thread to one reader thread.
+ */
+
+#ifndef asteroids_triple_buffer_h
+#define asteroids_triple_buffer_h
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class TripleBuffer
+     * @brief Three slots shared by one writer and one reader without locks.
+     *
+     * The writer fills its back slot and publishes it by swapping it with the middle slot. The reader
+     * swaps its front slot with the middle slot when a newer value was published. Neither side ever
+     * waits for the other, and the reader always sees the latest complete value.
+     */
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        /**
+         * @brief Get the slot the writer fills next.
+         * @return The back slot.
+         */
+        T &Back()
+        {
+            return slots_[back_];
+        }
+
+        /**
+         * @brief Publish the back slot to the reader.
+         */
+        void Publish()
+        {
+            back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        /**
+         * @brief Get the latest published value.
+         * @return The front slot, swapped for the middle slot if a newer value was published.
+         */
+        const T &Acquire()
+        {
+            if (middle_.load(std::memory_order_relaxed) & FRESH)
+                front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+            return slots_[front_];
+        }
+
+    private:
+        static constexpr std::uint8_t INDEX = 0x3; /**< Slot index bits of the middle slot. */
+        static constexpr std::uint8_t FRESH = 0x4; /**< Set while the middle slot is unread. */
+
+        std::array<T, 3> slots_;              /**< The three slots. */
+        std::uint8_t back_{0};                /**< Writer owned slot. */
+        std::atomic<std::uint8_t> middle_{1}; /**< Shared slot and its fresh bit. */
+        std::uint8_t front_{2};               /**< Reader owned slot. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_triple_buffer_h
@@ -12,6 +12,10 @@
 #include <QOpenGLFunctions>
 
 #include "configuration/config.h"
+#include "game/IRenderer.h"
+#include "game/RenderSnapshot.h"
+#include "gl/GLEntity.h"
+#include "gl/InstancedRenderer.h"
 
 namespace asteroids
 {
@@ -20,9 +24,10 @@ namespace asteroids
      * @class GL
      * @brief A class responsible for managing the underlying graphics library.
      *
-     * This class initializes OpenGL and handles rendering.
+     * This class initializes OpenGL and handles rendering. Snapshots are drawn by the instanced renderer
+     * when the context provides OpenGL 3.3, and through the fixed function pipeline otherwise.
      */
-    class ASTEROIDS_DLL_EXPORT GL : protected QOpenGLFunctions
+    class ASTEROIDS_DLL_EXPORT GL : protected QOpenGLFunctions, public IRenderer
     {
     public:
         /**
@@ -60,8 +65,33 @@ namespace asteroids
 
         /**
          * @brief Initialize OpenGL Function pointers.
+         * @param coreProfile Whether the current context has a core profile, which lacks the fixed function fallback.
+         * @return False if the instanced renderer failed in a core profile, leaving nothing to draw with.
          */
-        void InitOpenGLFunctions();
+        bool InitOpenGLFunctions(const bool coreProfile);
+
+        /**
+         * @brief Restore the server state after the frame was painted over by a QPainter.
+         */
+        void RestoreState();
+
+        /**
+         * @brief Get the score of the last drawn snapshot.
+         * @return The score.
+         */
+        GLint GetScore() const;
+
+        /**
+         * @brief Get the bounds of the world the current viewport shows.
+         * @return The world bounds.
+         */
+        WorldBounds GetBounds() const override;
+
+        /**
+         * @brief Draw a snapshot.
+         * @param snapshot The snapshot to draw.
+         */
+        void Draw(const RenderSnapshot &snapshot) override;
 
     private:
         /**
@@ -81,6 +111,10 @@ namespace asteroids
 
         // Members
         static std::unique_ptr<GL> instance_;
+
+        std::unique_ptr<InstancedRenderer> instancedRenderer_; /**< Null when the context lacks OpenGL 3.3. */
+        WorldBounds bounds_{WorldBounds::FromViewport(WIN_WIDTH, WIN_HEIGHT)}; /**< Bounds of the current viewport. */
+        GLint score_{0};                                                       /**< Score of the last drawn snapshot. */
     };
 
 } // end asteroids
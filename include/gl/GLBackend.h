@@ -98,9 +98,16 @@ namespace asteroids
          */
         void KeyboardUpdateState();
 
+        /**
+         * @brief Paint the score, the reset hint and, if toggled on, the frame timings over the frame.
+         */
+        void DrawGameInfo();
+
         // Members
         std::array<bool, 256> keysPressed_; /** @brief Array to track pressed keys. */
         GLBackendEmitters emitters_;        /**< Handles input events and actions. */
+        bool timingsVisible_{false};        /**< Whether the frame timings overlay is drawn. */
+        bool rendererFailed_{false};        /**< Whether the context could not initialize a renderer. */
 
         /** @brief a timer for periodically rendering this widget. */
         std::unique_ptr<QTimer> frameTimer_;
@@ -19,12 +19,32 @@
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/config.h"
+#include "gl/Mat4.h"
+#include "gl/Mat4Resource.h"
 
 namespace asteroids
 {
 
     using Resource2DGLfloat = ContainerResource2D<GLfloat>;
 
+    /**
+     * @struct WorldBounds
+     * @brief The half extents of the orthographic view volume which entities move and wrap around in.
+     */
+    struct ASTEROIDS_DLL_EXPORT WorldBounds
+    {
+        GLfloat right; /**< Half width of the view volume. */
+        GLfloat top;   /**< Half height of the view volume. */
+
+        /**
+         * @brief Derive the bounds from a viewport the same way GL::Reshape sets up its projection.
+         * @param _w Viewport width.
+         * @param _h Viewport height.
+         * @return The world bounds.
+         */
+        static WorldBounds FromViewport(const int _w, const int _h);
+    };
+
     /**
      * @class GLEntity
      * @brief A class representing an OpenGL entity with scale, translation, and rotation transformations.
@@ -45,7 +65,7 @@ namespace asteroids
          * @param frame Matrix representing entity geometry
          * @param unitVelocity Unit velocity matrix.
          */
-        GLEntity(Resource2DGLfloat frame, Resource2DGLfloat unitVelocity);
+        GLEntity(const Mat4 &frame, const Mat4 &unitVelocity);
 
         /**
          * @brief Destructor for GLEntity.
@@ -83,17 +103,24 @@ namespace asteroids
          */
         virtual void Draw();
 
+        /**
+         * @brief Add the matrices changed since the last save or load to the batch of the save database.
+         *
+         * A persisted save commits its matrices before the hierarchy, so this runs ahead of Save.
+         */
+        virtual void PersistMatrices() const;
+
         /**
          * @brief Get the transformation matrix describing the entity's geometry.
          * @return Reference to the frame matrix.
          */
-        Resource2DGLfloat &GetFrame();
+        Mat4Resource &GetFrame();
 
         /**
          * @brief Get the unit velocity matrix of the entity.
          * @return Reference to the unit velocity matrix.
          */
-        Resource2DGLfloat &GetUnitVelocity();
+        Mat4Resource &GetUnitVelocity();
 
         /**
          * @brief Get the entity's speed.
@@ -117,19 +144,19 @@ namespace asteroids
          * @brief Get the scale transformation matrix.
          * @return A constant reference to the scale matrix.
          */
-        const Resource2DGLfloat &SMatrix() const;
+        const Mat4Resource &SMatrix() const;
 
         /**
          * @brief Get the translation transformation matrix.
          * @return A constant reference to the translation matrix.
          */
-        const Resource2DGLfloat &TMatrix() const;
+        const Mat4Resource &TMatrix() const;
 
         /**
          * @brief Get the rotation transformation matrix.
          * @return A constant reference to the rotation matrix.
          */
-        const Resource2DGLfloat &RMatrix() const;
+        const Mat4Resource &RMatrix() const;
 
         /**
          * @brief Set a value in the frame matrix.
@@ -143,7 +170,7 @@ namespace asteroids
          * @brief Set the entire frame matrix.
          * @param frame The frame matrix to set.
          */
-        void SetFrame(const Resource2DGLfloat &frame);
+        void SetFrame(const Mat4 &frame);
 
         /**
          * @brief Set a value in the unit velocity matrix.
@@ -157,7 +184,7 @@ namespace asteroids
          * @brief Set the unit velocity matrix.
          * @param unitVelocity The unit velocity matrix to set.
          */
-        void SetUnitVelocity(const Resource2DGLfloat &unitVelocity);
+        void SetUnitVelocity(const Mat4 &unitVelocity);
 
         /**
          * @brief Set speed of this GL object.
@@ -177,19 +204,34 @@ namespace asteroids
          */
         void SetVelocityAngle(const GLfloat angle);
 
+    protected:
+        /**
+         * @brief Set the scale and translation matrices from the current speed and frame.
+         */
+        void SetMotionMatrices();
+
         /**
-         * @brief Register serialization keys with the deserializer.
-         * @param key The entity key.
+         * @brief Move the entity per time step ( p = av + frame ).
          */
-        static void RegisterSerializationResources(const std::string_view key);
+        void Move();
 
         /**
-         * @brief Register serialization keys with the loader.
-         * @param key The entity key.
+         * @brief Teleport the entity to the other side of the world if it moves out of bounds.
+         * @param bounds The world bounds.
+         * @param epsilon The distance past the bounds at which the entity wraps around.
          */
-        static void RegisterPersistenceResources(const std::string_view key);
+        void WrapAround(const WorldBounds &bounds, const GLfloat epsilon);
+
+        /**
+         * @brief Teleport a position to the other side of the world if it is out of bounds.
+         * @param x The x-coordinate of the position.
+         * @param y The y-coordinate of the position.
+         * @param bounds The world bounds.
+         * @param epsilon The distance past the bounds at which the position wraps around.
+         * @return true if the position wrapped around; false otherwise.
+         */
+        static bool WrapAround(GLfloat &x, GLfloat &y, const WorldBounds &bounds, const GLfloat epsilon);
 
-    protected:
         /**
          * @brief Save the entity data to a property tree.
          * @param tree The property tree to save data into.
@@ -226,17 +268,23 @@ namespace asteroids
         SharedEntity &GetAggregatedMember(const Key &key) const override;
 
     private:
-        Resource2DGLfloat frame_;        /**< Matrix representing entity geometry. */
-        Resource2DGLfloat unitVelocity_; /**< Unit velocity matrix. */
+        /**
+         * @brief Defer the decode of the matrices to the restore queue.
+         * @param path The folder of the serialized entity; empty when the entity is persisted.
+         */
+        void DeferMatrices(const std::string &path);
+
+        Mat4Resource frame_;        /**< Matrix representing entity geometry. */
+        Mat4Resource unitVelocity_; /**< Unit velocity matrix. */
 
         GLfloat velocityAngle_ = 0.0; /**< Velocity angle. */
         GLfloat speed_ = 0.0;         /**< Speed of the entity. */
         GLfloat mass_ = 1.0;          /**< Mass of the entity. */
 
     protected:
-        Resource2DGLfloat S_; /**< Scale transformation matrix. */
-        Resource2DGLfloat T_; /**< Translation transformation matrix. */
-        Resource2DGLfloat R_; /**< Rotation transformation matrix. */
+        Mat4Resource S_; /**< Scale transformation matrix. */
+        Mat4Resource T_; /**< Translation transformation matrix. */
+        Mat4Resource R_; /**< Rotation transformation matrix. */
     };
 
 } // end asteroids
@@ -0,0 +1,141 @@
+/**
+ * @file InstancedRenderer.h
+ * @brief Declaration of the InstancedRenderer class which draws every entity of a kind with one call.
+ */
+
+#ifndef asteroids_instanced_renderer_h
+#define asteroids_instanced_renderer_h
+
+#include <array>
+#include <cstddef>
+
+#include <QOpenGLExtraFunctions>
+
+#include "configuration/config.h"
+#include "game/MeshRegistry.h"
+#include "game/RenderSnapshot.h"
+#include "gl/Mat4.h"
+#include "gl/StreamingBuffer.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class InstancedRenderer
+     * @brief A core profile renderer which keeps the meshes in buffer objects and draws them instanced.
+     *
+     * The rock, ship and bullet meshes are uploaded once. Every frame the transforms and colors of the
+     * snapshot's entities are written straight into a region of a streaming instance buffer and each
+     * mesh is drawn with a single glDrawElementsInstanced call.
+     */
+    class ASTEROIDS_DLL_EXPORT InstancedRenderer : protected QOpenGLExtraFunctions
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        InstancedRenderer();
+
+        /**
+         * @brief Destructor. The buffer objects are released with the context which owns them.
+         */
+        ~InstancedRenderer() noexcept;
+
+        InstancedRenderer(const InstancedRenderer &) = delete;
+        InstancedRenderer(InstancedRenderer &&) = delete;
+        InstancedRenderer &operator=(const InstancedRenderer &) = delete;
+        InstancedRenderer &operator=(InstancedRenderer &&) = delete;
+
+        /**
+         * @brief Compile the shaders and upload the meshes. Requires a current context.
+         * @return true if the context supports the renderer; false otherwise.
+         */
+        bool Initialize();
+
+        /**
+         * @brief Set the projection matrix.
+         * @param projection The projection matrix.
+         */
+        void SetProjection(const Mat4 &projection);
+
+        /**
+         * @brief Draw a snapshot.
+         * @param snapshot The snapshot to draw.
+         */
+        void Draw(const RenderSnapshot &snapshot);
+
+    private:
+        /**
+         * @struct Mesh
+         * @brief The buffer objects of an uploaded mesh.
+         */
+        struct Mesh
+        {
+            GLuint vertexArray{0};     /**< Vertex array object binding the mesh and instance attributes. */
+            GLuint vertexBuffer{0};    /**< Vertex positions. */
+            GLuint indexBuffer{0};     /**< Element indices. */
+            GLenum mode{GL_LINE_LOOP}; /**< Primitive type. */
+            GLsizei indexCount{0};     /**< Number of indices. */
+        };
+
+        /**
+         * @struct Instance
+         * @brief The per-instance attributes of a drawn entity.
+         */
+        struct Instance
+        {
+            GLfloat x;     /**< x-coordinate. */
+            GLfloat y;     /**< y-coordinate. */
+            GLfloat z;     /**< z-coordinate. */
+            GLfloat angle; /**< Rotation about the z-axis in radians. */
+            GLfloat r;     /**< Red component. */
+            GLfloat g;     /**< Green component. */
+            GLfloat b;     /**< Blue component. */
+        };
+
+        /**
+         * @brief Compile a shader.
+         * @param type The shader type.
+         * @param source The GLSL source.
+         * @return The shader; 0 if it does not compile.
+         */
+        GLuint CompileShader(const GLenum type, const char *source);
+
+        /**
+         * @brief Upload a mesh of the registry and bind its vertex and instance attributes to a vertex array object.
+         * @param id The mesh.
+         */
+        void UploadMesh(const MeshId id);
+
+        /**
+         * @brief Count the instances of a snapshot per mesh and compute where each mesh's instances start.
+         * @param snapshot The snapshot.
+         */
+        void CountInstances(const RenderSnapshot &snapshot);
+
+        /**
+         * @brief Write the instances of a snapshot, grouped by mesh.
+         * @param snapshot The snapshot.
+         * @param instances Where to write the instances; holds offsets_[MeshRegistry::MESH_COUNT] of them.
+         */
+        void WriteInstances(const RenderSnapshot &snapshot, Instance *instances) const;
+
+        /**
+         * @brief Draw the written instances of a mesh.
+         * @param id The mesh.
+         * @param base The offset of the frame's instances in the instance buffer.
+         */
+        void DrawMesh(const MeshId id, const size_t base);
+
+        GLuint program_{0};               /**< Shader program. */
+        GLint projectionLocation_{-1};    /**< Location of the projection uniform. */
+        Mat4 projection_;                 /**< Projection matrix. */
+
+        std::array<Mesh, MeshRegistry::MESH_COUNT> meshes_;          /**< Uploaded meshes, in registry order. */
+        std::array<size_t, MeshRegistry::MESH_COUNT + 1> offsets_{}; /**< First instance of each mesh, followed by the instance count. */
+        StreamingBuffer instances_;                                  /**< Per-instance attributes of the frames in flight. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_instanced_renderer_h
@@ -0,0 +1,325 @@
+/**
+ * @file Mat4.h
+ * @brief Declaration of the Vec4 and Mat4 types used to transform entities on the CPU.
+ */
+
+#ifndef asteroids_mat4_h
+#define asteroids_mat4_h
+
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+#if !defined(ASTEROIDS_SCALAR_MATH) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define ASTEROIDS_MAT4_SSE
+#elif !defined(ASTEROIDS_SCALAR_MATH) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ASTEROIDS_MAT4_NEON
+#endif
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @struct Vec4
+     * @brief A 16-byte aligned homogeneous vector.
+     */
+    struct alignas(16) Vec4
+    {
+        GLfloat x{0.0f}; /**< The x-component. */
+        GLfloat y{0.0f}; /**< The y-component. */
+        GLfloat z{0.0f}; /**< The z-component. */
+        GLfloat w{0.0f}; /**< The w-component. */
+
+        /**
+         * @brief Add two vectors.
+         * @param lhs The left hand side vector.
+         * @param rhs The right hand side vector.
+         * @return The component-wise sum.
+         */
+        friend constexpr Vec4 operator+(const Vec4 &lhs, const Vec4 &rhs)
+        {
+            return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w};
+        }
+
+        /**
+         * @brief Scale a vector.
+         * @param lhs The vector.
+         * @param rhs The scale.
+         * @return The scaled vector.
+         */
+        friend constexpr Vec4 operator*(const Vec4 &lhs, const GLfloat rhs)
+        {
+            return {lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs};
+        }
+
+        /**
+         * @brief Compare two vectors component-wise.
+         */
+        friend constexpr bool operator==(const Vec4 &, const Vec4 &) = default;
+    };
+
+    /**
+     * @struct Mat4
+     * @brief A 16-byte aligned 4x4 matrix stored column major, the layout glLoadMatrixf expects.
+     *
+     * Products use SSE or NEON where available and a scalar loop otherwise, when ASTEROIDS_SCALAR_MATH
+     * is defined, or when evaluated at compile time. Matrices held in row major Resource2DGLfloat
+     * members are converted with FromRows and StoreRows.
+     */
+    struct alignas(16) Mat4
+    {
+        std::array<GLfloat, 16> m{}; /**< The elements, column by column. */
+
+        /**
+         * @brief Get an element.
+         * @param row The row index.
+         * @param col The column index.
+         * @return The element.
+         */
+        constexpr GLfloat operator()(const int row, const int col) const
+        {
+            return m[col * 4 + row];
+        }
+
+        /**
+         * @brief Get an element.
+         * @param row The row index.
+         * @param col The column index.
+         * @return Reference to the element.
+         */
+        constexpr GLfloat &operator()(const int row, const int col)
+        {
+            return m[col * 4 + row];
+        }
+
+        /**
+         * @brief Get the elements for GL.
+         * @return The column major elements.
+         */
+        const GLfloat *Data() const
+        {
+            return m.data();
+        }
+
+        /**
+         * @brief Get the identity matrix.
+         * @return The identity.
+         */
+        static constexpr Mat4 Identity()
+        {
+            return Scale(1.0f);
+        }
+
+        /**
+         * @brief Get a uniform scale matrix.
+         * @param scale The scale of x, y and z.
+         * @return The scale matrix.
+         */
+        static constexpr Mat4 Scale(const GLfloat scale)
+        {
+            Mat4 result;
+            result(0, 0) = scale;
+            result(1, 1) = scale;
+            result(2, 2) = scale;
+            result(3, 3) = 1.0f;
+            return result;
+        }
+
+        /**
+         * @brief Get a translation matrix.
+         * @param x The x-offset.
+         * @param y The y-offset.
+         * @param z The z-offset.
+         * @return The translation matrix.
+         */
+        static constexpr Mat4 Translation(const GLfloat x, const GLfloat y, const GLfloat z)
+        {
+            Mat4 result = Identity();
+            result(0, 3) = x;
+            result(1, 3) = y;
+            result(2, 3) = z;
+            return result;
+        }
+
+        /**
+         * @brief Get an orthographic projection matrix, the same matrix glOrtho multiplies in.
+         * @param left The left clipping plane.
+         * @param right The right clipping plane.
+         * @param bottom The bottom clipping plane.
+         * @param top The top clipping plane.
+         * @param nearVal The near clipping plane.
+         * @param farVal The far clipping plane.
+         * @return The projection matrix.
+         */
+        static constexpr Mat4 Ortho(
+            const GLfloat left,
+            const GLfloat right,
+            const GLfloat bottom,
+            const GLfloat top,
+            const GLfloat nearVal,
+            const GLfloat farVal)
+        {
+            Mat4 result = Identity();
+            result(0, 0) = 2.0f / (right - left);
+            result(1, 1) = 2.0f / (top - bottom);
+            result(2, 2) = -2.0f / (farVal - nearVal);
+            result(0, 3) = -(right + left) / (right - left);
+            result(1, 3) = -(top + bottom) / (top - bottom);
+            result(2, 3) = -(farVal + nearVal) / (farVal - nearVal);
+            return result;
+        }
+
+        /**
+         * @brief Get a rotation matrix about the z-axis.
+         * @param angle The angle in radians.
+         * @return The rotation matrix.
+         */
+        static Mat4 RotationZ(const GLfloat angle)
+        {
+            const GLfloat c = std::cos(angle);
+            const GLfloat s = std::sin(angle);
+            Mat4 result = Identity();
+            result(0, 0) = c;
+            result(0, 1) = -s;
+            result(1, 0) = s;
+            result(1, 1) = c;
+            return result;
+        }
+
+        /**
+         * @brief Get the matrix of a translated and rotated 2D entity.
+         * @param x The x-coordinate.
+         * @param y The y-coordinate.
+         * @param z The z-coordinate.
+         * @param angle The rotation about the z-axis in radians.
+         * @return Translation(x, y, z) * RotationZ(angle).
+         */
+        static Mat4 Transform(const GLfloat x, const GLfloat y, const GLfloat z, const GLfloat angle)
+        {
+            Mat4 result = RotationZ(angle);
+            result(0, 3) = x;
+            result(1, 3) = y;
+            result(2, 3) = z;
+            return result;
+        }
+
+        /**
+         * @brief Get a matrix holding a vector in its first column, the layout entity positions and velocities are stored in.
+         * @param x The x-component.
+         * @param y The y-component.
+         * @param z The z-component.
+         * @param w The w-component.
+         * @return The matrix.
+         */
+        static constexpr Mat4 ColumnVector(const GLfloat x, const GLfloat y, const GLfloat z, const GLfloat w)
+        {
+            Mat4 result;
+            result(0, 0) = x;
+            result(1, 0) = y;
+            result(2, 0) = z;
+            result(3, 0) = w;
+            return result;
+        }
+
+        /**
+         * @brief Read a matrix stored row major.
+         * @param rows The 16 row major elements.
+         * @return The matrix.
+         */
+        static constexpr Mat4 FromRows(const GLfloat *rows)
+        {
+            Mat4 result;
+            for (int row = 0; row < 4; ++row)
+                for (int col = 0; col < 4; ++col)
+                    result(row, col) = rows[row * 4 + col];
+            return result;
+        }
+
+        /**
+         * @brief Write the matrix row major.
+         * @param rows The 16 row major elements to write.
+         */
+        constexpr void StoreRows(GLfloat *rows) const
+        {
+            for (int row = 0; row < 4; ++row)
+                for (int col = 0; col < 4; ++col)
+                    rows[row * 4 + col] = (*this)(row, col);
+        }
+
+        /**
+         * @brief Get a column.
+         * @param col The column index.
+         * @return The column.
+         */
+        constexpr Vec4 Column(const int col) const
+        {
+            return {m[col * 4], m[col * 4 + 1], m[col * 4 + 2], m[col * 4 + 3]};
+        }
+
+        /**
+         * @brief Transform a vector.
+         * @param lhs The matrix.
+         * @param rhs The vector.
+         * @return lhs * rhs.
+         */
+        friend constexpr Vec4 operator*(const Mat4 &lhs, const Vec4 &rhs)
+        {
+            if (!std::is_constant_evaluated())
+            {
+#if defined(ASTEROIDS_MAT4_SSE)
+                Vec4 result;
+                __m128 sum = _mm_mul_ps(_mm_load_ps(&lhs.m[0]), _mm_set1_ps(rhs.x));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&lhs.m[4]), _mm_set1_ps(rhs.y)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&lhs.m[8]), _mm_set1_ps(rhs.z)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&lhs.m[12]), _mm_set1_ps(rhs.w)));
+                _mm_store_ps(&result.x, sum);
+                return result;
+#elif defined(ASTEROIDS_MAT4_NEON)
+                Vec4 result;
+                float32x4_t sum = vmulq_n_f32(vld1q_f32(&lhs.m[0]), rhs.x);
+                sum = vmlaq_n_f32(sum, vld1q_f32(&lhs.m[4]), rhs.y);
+                sum = vmlaq_n_f32(sum, vld1q_f32(&lhs.m[8]), rhs.z);
+                sum = vmlaq_n_f32(sum, vld1q_f32(&lhs.m[12]), rhs.w);
+                vst1q_f32(&result.x, sum);
+                return result;
+#endif
+            }
+            return lhs.Column(0) * rhs.x + lhs.Column(1) * rhs.y + lhs.Column(2) * rhs.z + lhs.Column(3) * rhs.w;
+        }
+
+        /**
+         * @brief Multiply two matrices.
+         * @param lhs The left hand side matrix.
+         * @param rhs The right hand side matrix.
+         * @return lhs * rhs.
+         */
+        friend constexpr Mat4 operator*(const Mat4 &lhs, const Mat4 &rhs)
+        {
+            Mat4 result;
+            for (int col = 0; col < 4; ++col)
+            {
+                const Vec4 column = lhs * rhs.Column(col);
+                result.m[col * 4] = column.x;
+                result.m[col * 4 + 1] = column.y;
+                result.m[col * 4 + 2] = column.z;
+                result.m[col * 4 + 3] = column.w;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Compare two matrices element-wise.
+         */
+        friend constexpr bool operator==(const Mat4 &, const Mat4 &) = default;
+    };
+
+    static_assert(alignof(Mat4) == 16 && sizeof(Mat4) == 16 * sizeof(GLfloat));
+    static_assert(Mat4::Translation(1.0f, 2.0f, 3.0f) * Vec4{0.0f, 0.0f, 0.0f, 1.0f} == Vec4{1.0f, 2.0f, 3.0f, 1.0f});
+
+} // end namespace asteroids
+
+#endif // asteroids_mat4_h
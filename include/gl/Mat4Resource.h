@@ -0,0 +1,99 @@
+/**
+ * @file Mat4Resource.h
+ * @brief Declaration of the Mat4Resource class which stores an entity transform in place.
+ */
+
+#ifndef asteroids_mat4_resource_h
+#define asteroids_mat4_resource_h
+
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+#include "configuration/config.h"
+#include "gl/Mat4.h"
+
+namespace asteroids
+{
+
+    using Resource2DGLfloat = ContainerResource2D<GLfloat>;
+
+    /**
+     * @class Mat4Resource
+     * @brief A fixed size 4x4 matrix stored inline and aligned to a cache line.
+     *
+     * The matrix is updated in place without allocating. It is converted to a row major Resource2DGLfloat
+     * only when it is serialized or persisted, so saved games keep their format.
+     */
+    class ASTEROIDS_DLL_EXPORT Mat4Resource
+    {
+    public:
+        /**
+         * @brief Default constructor. All elements are zero.
+         */
+        Mat4Resource() = default;
+
+        /**
+         * @brief Constructor.
+         * @param matrix The initial matrix.
+         */
+        Mat4Resource(const Mat4 &matrix);
+
+        /**
+         * @brief Get an element and mark the matrix dirty.
+         * @param i Row index.
+         * @param j Column index.
+         * @return Reference to the element.
+         */
+        GLfloat &GetData(const int i, const int j);
+
+        /**
+         * @brief Get an element.
+         * @param i Row index.
+         * @param j Column index.
+         * @return The element.
+         */
+        GLfloat GetData(const int i, const int j) const;
+
+        /**
+         * @brief Get the matrix.
+         * @return A constant reference to the matrix.
+         */
+        const Mat4 &Get() const;
+
+        /**
+         * @brief Overwrite the matrix and mark it dirty.
+         * @param matrix The matrix.
+         */
+        void Set(const Mat4 &matrix);
+
+        /**
+         * @brief Check if the matrix changed since it was last loaded.
+         * @return true if the matrix is dirty; false otherwise.
+         */
+        bool GetDirty() const;
+
+        /**
+         * @brief Copy the matrix into a row major resource for the serializers.
+         * @return The resource.
+         */
+        Resource2DGLfloat ToResource() const;
+
+        /**
+         * @brief Overwrite the matrix with a deserialized or loaded row major 4x4 resource.
+         * @param resource The resource.
+         */
+        void Assign(const Resource2DGLfloat &resource);
+
+        /**
+         * @brief Overwrite the matrix with a loaded column major matrix.
+         * @param matrix The matrix.
+         */
+        void Assign(const Mat4 &matrix);
+
+    private:
+        alignas(64) Mat4 matrix_; /**< The matrix, on a cache line of its own. */
+        bool dirty_{true};        /**< Set when the matrix changes and cleared when it is assigned from a resource. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_mat4_resource_h
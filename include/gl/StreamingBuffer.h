@@ -0,0 +1,120 @@
+/**
+ * @file StreamingBuffer.h
+ * @brief Declaration of the StreamingBuffer class which streams per-frame vertex data to the GPU.
+ */
+
+#ifndef asteroids_streaming_buffer_h
+#define asteroids_streaming_buffer_h
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <QOpenGLExtraFunctions>
+
+#include "configuration/config.h"
+
+namespace asteroids
+{
+
+    /**
+     * @class StreamingBuffer
+     * @brief A buffer object split into one region per frame in flight.
+     *
+     * With ARB_buffer_storage the buffer is mapped once, persistently and coherently, and callers write
+     * a frame's data straight into the mapped region. Each region is guarded by a fence, so a region is
+     * only rewritten once the GPU has finished the draws which read it. Without ARB_buffer_storage the
+     * data is written to client memory and uploaded into orphaned storage instead.
+     */
+    class ASTEROIDS_DLL_EXPORT StreamingBuffer : protected QOpenGLExtraFunctions
+    {
+    public:
+        /**
+         * @brief The number of frames which may be in flight at once.
+         */
+        static constexpr size_t REGION_COUNT = 3;
+
+        /**
+         * @brief Constructor.
+         */
+        StreamingBuffer();
+
+        /**
+         * @brief Destructor. The buffer object is released with the context which owns it.
+         */
+        ~StreamingBuffer() noexcept;
+
+        StreamingBuffer(const StreamingBuffer &) = delete;
+        StreamingBuffer(StreamingBuffer &&) = delete;
+        StreamingBuffer &operator=(const StreamingBuffer &) = delete;
+        StreamingBuffer &operator=(StreamingBuffer &&) = delete;
+
+        /**
+         * @brief Create the buffer object. Requires a current context.
+         * @param target The target the buffer is bound to, such as GL_ARRAY_BUFFER.
+         * @param regionBytes The initial size of each region.
+         */
+        void Initialize(const GLenum target, const size_t regionBytes);
+
+        /**
+         * @brief Check if the buffer is persistently mapped.
+         * @return true if writes go straight to the buffer object; false if they are uploaded.
+         */
+        bool IsPersistent() const;
+
+        /**
+         * @brief Get the buffer object.
+         * @return The buffer object name.
+         */
+        GLuint Buffer() const;
+
+        /**
+         * @brief Start writing the data of a frame. Waits if the GPU still reads the next region.
+         * @param bytes The size of the frame's data.
+         * @return Where to write the data.
+         */
+        void *Begin(const size_t bytes);
+
+        /**
+         * @brief Finish writing the data of a frame. The buffer is bound to its target afterwards.
+         * @return The offset of the frame's data in the buffer object.
+         */
+        size_t End();
+
+        /**
+         * @brief Guard the current region once the draws which read it have been issued, and move on to the next.
+         */
+        void Fence();
+
+    private:
+        /**
+         * @brief Signature of glBufferStorage, which QOpenGLExtraFunctions does not resolve.
+         */
+        using BufferStorage = void(QOPENGLF_APIENTRYP)(GLenum, GLsizeiptr, const void *, GLbitfield);
+
+        /**
+         * @brief Allocate and map storage for regions of at least a given size.
+         * @param regionBytes The size of each region.
+         */
+        void Allocate(const size_t regionBytes);
+
+        /**
+         * @brief Wait for the GPU to finish reading a region.
+         * @param region The region.
+         */
+        void Wait(const size_t region);
+
+        GLenum target_{0};                          /**< The target the buffer is bound to. */
+        GLuint buffer_{0};                          /**< The buffer object. */
+        size_t regionBytes_{0};                     /**< The size of each region. */
+        size_t region_{0};                          /**< The region of the current frame. */
+        size_t pendingBytes_{0};                    /**< Size of the data written since Begin. */
+        char *mapped_{nullptr};                     /**< The persistently mapped buffer; null when uploading instead. */
+        std::vector<char> staging_;                 /**< Client memory written when the buffer is not mapped. */
+        std::array<GLsync, REGION_COUNT> fences_{}; /**< Fences of the draws reading each region. */
+        BufferStorage bufferStorage_{nullptr};      /**< glBufferStorage; null without ARB_buffer_storage. */
+    };
+
+} // end namespace asteroids
+
+#endif // asteroids_streaming_buffer_h
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Events/EventChannel.h"
+
+#include "configuration/config.h"
+#include "game/Asteroids.h"
+#include "game/AsteroidsConsumers.h"
+#include "game/IRenderer.h"
+#include "game/InputRecording.h"
+#include "game/RenderSnapshot.h"
+#include "game/Scenario.h"
+#include "game/Simulation.h"
+#include "gl/GLBackendEmitters.h"
+#include "gl/GLEntity.h"
+
+using asteroids::Asteroids;
+using asteroids::AsteroidsConsumers;
+using asteroids::Command;
+using asteroids::GLBackendEmitters;
+using asteroids::InputEvent;
+using asteroids::InputReplay;
+using asteroids::IRenderer;
+using asteroids::RegisterEvents;
+using asteroids::RenderSnapshot;
+using asteroids::Scenario;
+using asteroids::Simulation;
+using asteroids::WorldBounds;
+using events::EventChannel;
+
+namespace
+{
+	const std::string HASHES_ARG = "--hashes";
+
+	void PrintUsage(const char *program)
+	{
+		std::cerr << "usage: " << program << " RECORDING [" << HASHES_ARG << " PATH]" << std::endl;
+	}
+
+	/**
+	 * @brief Hashes every snapshot it is asked to draw instead of drawing it, and shows the recorded bounds.
+	 */
+	class HashRenderer : public IRenderer
+	{
+	public:
+		WorldBounds GetBounds() const override
+		{
+			return bounds;
+		}
+
+		void Draw(const RenderSnapshot &snapshot) override
+		{
+			hashes.push_back(InputReplay::Hash(snapshot));
+		}
+
+		WorldBounds bounds = WorldBounds::FromViewport(WIN_WIDTH, WIN_HEIGHT);
+		std::vector<std::uint64_t> hashes;
+	};
+
+	void Emit(GLBackendEmitters &emitters, const Command command)
+	{
+		switch (command)
+		{
+		case Command::ROTATE_LEFT:
+			emitters.GetLeftArrowEmitter()->Signal()();
+			break;
+		case Command::ROTATE_RIGHT:
+			emitters.GetRightArrowEmitter()->Signal()();
+			break;
+		case Command::THRUST:
+			emitters.GetThrustEmitter()->Signal()();
+			break;
+		case Command::FIRE:
+			emitters.GetFireEmitter()->Signal()();
+			break;
+		case Command::RESET:
+			emitters.GetResetEmitter()->Signal()();
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+int main(int _argc, char *_argv[])
+{
+	if (_argc < 2)
+	{
+		PrintUsage(_argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	std::string hashesPath;
+	for (int i = 2; i < _argc; ++i)
+	{
+		const std::string arg = _argv[i];
+		if (arg == HASHES_ARG && i + 1 < _argc)
+			hashesPath = _argv[++i];
+		else
+		{
+			PrintUsage(_argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	InputReplay replay;
+	const std::optional<Scenario> scenario = replay.Open(_argv[1]) ? Scenario::Parse(replay.GetScenario()) : std::nullopt;
+	if (!scenario)
+	{
+		std::cerr << "invalid recording: " << _argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// the recorded session started from a new game under its seed, in the scenario it was recorded in
+	auto game = std::make_shared<Asteroids>();
+	game->SetSeed(replay.GetSeed());
+	game->SetScenario(*scenario);
+	game->ResetGame();
+
+	// input takes the path of the front end, but the simulation is advanced here rather than on its thread
+	HashRenderer renderer;
+	auto simulation = std::make_shared<Simulation>(game, renderer);
+	AsteroidsConsumers frontendConsumers(simulation);
+	GLBackendEmitters emitters;
+	EventChannel channel;
+	RegisterEvents(frontendConsumers, emitters, channel);
+
+	const std::vector<InputEvent> &events = replay.GetEvents();
+	auto event = events.begin();
+	renderer.hashes.reserve(replay.GetFrameCount());
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::uint64_t frame = 0; frame < replay.GetFrameCount(); ++frame)
+	{
+		for (; event != events.end() && event->frame == frame; ++event)
+		{
+			if (event->resize)
+			{
+				renderer.bounds = event->bounds;
+				simulation->Resize(event->bounds);
+			}
+			else
+				Emit(emitters, event->command);
+		}
+		simulation->Advance();
+		emitters.GetDrawEmitter()->Signal()();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	if (!hashesPath.empty())
+	{
+		std::ofstream hashes(hashesPath);
+		for (const std::uint64_t hash : renderer.hashes)
+			hashes << std::hex << std::setw(16) << std::setfill('0') << hash << '\n';
+		if (!hashes)
+		{
+			std::cerr << "could not write hashes: " << hashesPath << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::cout << "frames: " << replay.GetFrameCount() << std::endl;
+	std::cout << "seconds: " << elapsed.count() << std::endl;
+	std::cout << "frames/s: " << (elapsed.count() > 0.0 ? replay.GetFrameCount() / elapsed.count() : 0.0) << std::endl;
+	std::cout << "score: " << game->GetScore() << std::endl;
+	std::cout << "hash: " << std::hex << std::setw(16) << std::setfill('0') << (renderer.hashes.empty() ? 0 : renderer.hashes.back()) << std::endl;
+
+	return EXIT_SUCCESS;
+}
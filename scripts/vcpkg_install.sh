@@ -20,6 +20,7 @@ vcpkg install --classic \
   boost-property-tree \
   boost-lexical-cast \
   boost-uuid \
+  benchmark \
   --triplet "${TRIPLET}"
 
   # Clear cached files and intermediate results
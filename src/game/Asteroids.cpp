@@ -3,10 +3,13 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
-#include <future>
+#include <functional>
 #include <memory>
 #include <numbers>
+#include <optional>
+#include <set>
 #include <stdio.h>
 #include <string>
 #include <string_view>
@@ -14,15 +17,8 @@
 #include <utility>
 #include <vector>
 
-#include <boost/asio/packaged_task.hpp>
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
-#include <boost/lexical_cast.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
 
 #include "DatabaseAdapters/EntityLoader.h"
 #include "DatabaseAdapters/EntityPersister.h"
@@ -39,19 +35,57 @@
 
 #include "configuration/filesystem.hpp"
 #include "configuration/serialization.h"
+#include "game/BlobStore.h"
 #include "game/Bullet.h"
+#include "game/CollisionKernel.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/FrameTimings.h"
+#include "game/ParallelFor.h"
+#include "game/ResourceSchema.h"
+#include "game/RestoreQueue.h"
 #include "game/Rock.h"
+#include "game/SaveDatabase.h"
+#include "game/SaveJournal.h"
+#include "game/Scenario.h"
 #include "game/Ship.h"
-#include "gl/GLEntityTask.h"
+#include "game/SnapshotPack.h"
+#include "game/SpatialGrid.h"
+#include "game/TaskScheduler.h"
 
 using boost::property_tree::ptree;
 
 using asteroids::Asteroids;
+using asteroids::BlobStore;
 using asteroids::Bullet;
-using asteroids::GLEntityTask;
+using asteroids::BulletArchetype;
+using asteroids::BulletRow;
+using asteroids::CollisionKernel;
+using asteroids::CounterRng;
+using asteroids::EntityHandle;
+using asteroids::EntityKind;
+using asteroids::GameRow;
+using asteroids::GLEntity;
+using asteroids::Mat4Resource;
+using asteroids::ParallelFor;
+using asteroids::RenderSnapshot;
+using asteroids::ResourceSchema;
+using asteroids::RestoreQueue;
 using asteroids::Rock;
+using asteroids::RockArchetype;
+using asteroids::RockRow;
+using asteroids::SaveDatabase;
+using asteroids::SaveJournal;
+using asteroids::Scenario;
+using asteroids::ScopedTimer;
 using asteroids::Ship;
+using asteroids::ShipRow;
+using asteroids::SnapshotPack;
+using asteroids::SquaredRadii;
+using asteroids::TaskGraph;
 using asteroids::State;
+using asteroids::TimedStage;
+using asteroids::WorldBounds;
 using database_adapters::EntityLoader;
 using database_adapters::EntityPersister;
 using database_adapters::ResourceLoader;
@@ -68,20 +102,30 @@ namespace pt = boost::property_tree;
 namespace
 {
 const double PI = std::numbers::pi;
-const int ROCK_NUMBER = 6;
+const GLfloat TICK_SECONDS = static_cast<GLfloat>(FRAME_MS) / 1000.0f;
 const std::string ASTEROIDS_KEY = "Asteroids";
 const std::string SCORE_KEY = "score";
 const std::string ROCK_COUNT_KEY = "rock_count";
 const std::string ORIENTATION_ANGLE_KEY = "orientation_angle";
 const std::string THRUST_KEY = "thrust";
-const std::string ROCK_PREFIX = "Rock";
-const std::string BULLET_PREFIX = "Bullet";
-const std::vector<std::string> ROCK_RESOURCES = {"rock_vertices", "rock_indices", "frame", "unit_velocity", "S", "T", "R"};
-const std::vector<std::string> BULLET_RESOURCES = {"bullet_vertices", "bullet_indices", "projection_matrix", "frame", "unit_velocity", "S", "T", "R"};
-const std::vector<std::string> SHIP_RESOURCES = {"frame", "unit_velocity", "S", "T", "R", "ship_vertices", "ship_indices", "unit_orientation"};
+const std::string TOMBSTONES_KEY = "tombstones";
 
-const std::string RESET = "Press X to RESET";
-const std::string SCORE = "SCORE: ";
+// saves between sweeps of the resources of removed entities; each sweep also rewrites every resource
+const size_t COMPACTION_INTERVAL = 16;
+
+// collision radii indexed by State (LARGE, MEDIUM, SMALL)
+const std::array<GLfloat, 3> BULLET_COLLISION_RADII = {1.7f, 1.3f, 0.8f};
+const std::array<GLfloat, 3> SHIP_COLLISION_RADII = {2.2f, 1.6f, 1.0f};
+const SquaredRadii BULLET_SQUARED_RADII = asteroids::SquareRadii(BULLET_COLLISION_RADII);
+const SquaredRadii SHIP_SQUARED_RADII = asteroids::SquareRadii(SHIP_COLLISION_RADII);
+
+// smallest ranges worth handing to another thread
+const size_t ROCK_UPDATE_GRAIN = 2048;
+const size_t BULLET_QUERY_GRAIN = 256;
+
+// rocks spawned on reset and in waves draw from their own streams; every other stream is keyed by a rock's handle
+const std::uint64_t RESET_STREAM = ~std::uint64_t{0};
+const std::uint64_t WAVE_STREAM = ~std::uint64_t{1};
 
 EntityDeserializer *const Deserializer = EntityDeserializer::GetInstance();
 EntitySerializer *const Serializer = EntitySerializer::GetInstance();
@@ -91,6 +135,33 @@ ResourceDeserializer *const RDeserializer = ResourceDeserializer::GetInstance();
 ResourceSerializer *const RSerializer = ResourceSerializer::GetInstance();
 ResourceLoader *const RLoader = ResourceLoader::GetInstance();
 ResourcePersister *const RPersister = ResourcePersister::GetInstance();
+BlobStore *const Blobs = BlobStore::GetInstance();
+SaveJournal *const Journal = SaveJournal::GetInstance();
+SaveDatabase *const Database = SaveDatabase::GetInstance();
+RestoreQueue *const Restore = RestoreQueue::GetInstance();
+
+// set while the persisters keep the database open; only touched by the save writer or once it is idle
+bool SaveDatabasesOpen = false;
+
+void PutTombstones(ptree &tree, const std::set<std::string, std::less<>> &keys)
+{
+	ptree tombstones;
+	for (const std::string &key : keys)
+	{
+		ptree tombstone;
+		tombstone.put_value(key);
+		tombstones.push_back(std::make_pair("", tombstone));
+	}
+	tree.put_child(TOMBSTONES_KEY, tombstones);
+}
+
+void GetTombstones(const ptree &tree, std::set<std::string, std::less<>> &keys)
+{
+	// saves which predate tombstones swept removed entities immediately
+	if (auto tombstones = tree.get_child_optional(TOMBSTONES_KEY); tombstones)
+		for (const std::pair<const std::string, ptree> &tombstone : *tombstones)
+			keys.insert(tombstone.second.data());
+}
 
 void RegisterEntitiesForSerialization(const ptree &tree)
 {
@@ -98,25 +169,21 @@ void RegisterEntitiesForSerialization(const ptree &tree)
 	{
 		auto& [nodeKey, node] = keyValue;
 
-		if (nodeKey.starts_with(Rock::RockPrefix()))
+		switch (ResourceSchema::KindOf(nodeKey))
 		{
+		case EntityKind::ROCK:
 			Deserializer->GetRegistry().RegisterEntity<Rock>(nodeKey);
-			Rock::RegisterSerializationResources(nodeKey);
-		}
-		else if (nodeKey.starts_with(Bullet::BulletPrefix()))
-		{
+			break;
+		case EntityKind::BULLET:
 			Deserializer->GetRegistry().RegisterEntity<Bullet>(nodeKey);
-			Bullet::RegisterSerializationResources(nodeKey);
-		}
-		else if (nodeKey == Ship::ShipKey())
-		{
+			break;
+		case EntityKind::SHIP:
 			Deserializer->GetRegistry().RegisterEntity<Ship>(nodeKey);
-			Ship::RegisterSerializationResources(nodeKey);
-		}
-		else if (nodeKey == ASTEROIDS_KEY)
-		{
-			Deserializer->GetRegistry().RegisterEntity<Asteroids>(nodeKey);
-			Asteroids::RegisterSerializationResources(nodeKey);
+			break;
+		default:
+			if (nodeKey == ASTEROIDS_KEY)
+				Deserializer->GetRegistry().RegisterEntity<Asteroids>(nodeKey);
+			break;
 		}
 		RegisterEntitiesForSerialization(node);
 	}
@@ -128,92 +195,282 @@ void RegisterEntitiesForPersistence(const ptree &tree)
 	{
 		auto& [nodeKey, node] = keyValue;
 
-		if (nodeKey.starts_with(Rock::RockPrefix()))
+		switch (ResourceSchema::KindOf(nodeKey))
 		{
+		case EntityKind::ROCK:
 			Loader->GetRegistry().RegisterEntity<Rock>(nodeKey);
-			Rock::RegisterPersistenceResources(nodeKey);
+			break;
+		case EntityKind::BULLET:
+			Loader->GetRegistry().RegisterEntity<Bullet>(nodeKey);
+			break;
+		case EntityKind::SHIP:
+			Loader->GetRegistry().RegisterEntity<Ship>(nodeKey);
+			break;
+		default:
+			if (nodeKey == ASTEROIDS_KEY)
+				Loader->GetRegistry().RegisterEntity<Asteroids>(nodeKey);
+			break;
 		}
-		else if (nodeKey.starts_with(Bullet::BulletPrefix()))
+		RegisterEntitiesForPersistence(node);
+	}
+}
+
+std::uint64_t StreamOf(const EntityHandle handle)
+{
+	return (static_cast<std::uint64_t>(handle.slot) << 32) | handle.generation;
+}
+
+void InitializeRockVelocity(RockRow &rock, CounterRng &rng)
+{
+	const GLint randy = static_cast<GLint>(rng.Below(9)) + 1;
+	Rock::Initialize(rock, static_cast<GLfloat>(PI * randy / 5), static_cast<GLfloat>(randy % 3) / 100, static_cast<GLfloat>(randy % 6) / 100);
+}
+
+void SaveGame(ptree &tree, const GameRow &game, const std::set<std::string, std::less<>> &tombstones)
+{
+	tree.put(SCORE_KEY, game.score);
+	tree.put(ORIENTATION_ANGLE_KEY, game.orientationAngle);
+	tree.put(THRUST_KEY, game.thrust);
+	PutTombstones(tree, tombstones);
+}
+
+#if !defined(SAVE_TO_PACK) && !defined(SAVE_TO_DB)
+void ClearUnusedSerializationKeys(const std::set<std::string, std::less<>> &keys)
+{
+	for (const std::string &key : keys)
+	{
+		const EntityKind kind = ResourceSchema::KindOf(key);
+		if (kind == EntityKind::ROCK)
 		{
-			Loader->GetRegistry().RegisterEntity<Bullet>(nodeKey);
-			Bullet::RegisterPersistenceResources(nodeKey);
+			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / ASTEROIDS_KEY / key;
+			for (const std::string &resourceKey : ResourceSchema::Resources(kind))
+				RSerializer->Unserialize(resourceKey, resourceFolder.string());
+			// also sweeps the mesh resources of saves which predate the blob store
+			fs::remove_all(resourceFolder);
 		}
-		else if (nodeKey == Ship::ShipKey())
+		else if (kind == EntityKind::BULLET)
 		{
-			Loader->GetRegistry().RegisterEntity<Ship>(nodeKey);
-			Ship::RegisterPersistenceResources(nodeKey);
+			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / ASTEROIDS_KEY / Ship::ShipKey() / key;
+			for (const std::string &resourceKey : ResourceSchema::Resources(kind))
+				RSerializer->Unserialize(resourceKey, resourceFolder.string());
+			fs::remove_all(resourceFolder);
 		}
-		else if (nodeKey == ASTEROIDS_KEY)
+		else
 		{
-			Loader->GetRegistry().RegisterEntity<Asteroids>(nodeKey);
-			Asteroids::RegisterPersistenceResources(nodeKey);
+			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / ASTEROIDS_KEY / key;
+			for (const std::string &resourceKey : ResourceSchema::Resources(EntityKind::SHIP))
+				RSerializer->Unserialize(resourceKey, resourceFolder.string());
 		}
-		RegisterEntitiesForPersistence(node);
 	}
 }
 
-std::vector<std::string> RockResourceKeys(const std::string &key)
+#endif
+
+#if !defined(SAVE_TO_PACK) && defined(SAVE_TO_DB)
+void ClearUnusedPersistenceKeys(const std::set<std::string, std::less<>> &keys)
 {
-	std::vector<std::string> keys;
-	for (const std::string &suffix : ROCK_RESOURCES)
-		keys.push_back(FormatKey(key + suffix));
-	return keys;
+	for (const std::string &key : keys)
+	{
+		const EntityKind kind = ResourceSchema::KindOf(key);
+		for (const std::string &suffix : ResourceSchema::Resources(kind == EntityKind::NONE ? EntityKind::SHIP : kind))
+			Database->Unpersist(FormatKey(key + suffix));
+	}
 }
+#endif
 
-std::vector<std::string> BulletResourceKeys(const std::string &key)
+/**
+ * @brief The game state captured by the simulation thread for the save writer.
+ */
+struct SaveState
 {
-	std::vector<std::string> keys;
-	for (const std::string &suffix : BULLET_RESOURCES)
-		keys.push_back(FormatKey(key + suffix));
-	return keys;
+	GameRow game;                                  /**< Score and input. */
+	RockArchetype rocks;                           /**< Rock columns. */
+	BulletArchetype bullets;                       /**< Bullet columns. */
+	std::optional<ShipRow> ship;                   /**< Ship state, unless the ship was destroyed. */
+	WorldBounds bounds;                            /**< World bounds the bullets were projected with. */
+	std::set<std::string, std::less<>> tombstones; /**< Removed keys recorded in the save. */
+	std::set<std::string, std::less<>> sweep;      /**< Removed keys whose resources the save deletes. */
+};
+
+/**
+ * @brief The entity hierarchy of a captured game, materialized on the save writer thread.
+ *
+ * It saves under the key of the game and in its format, so the save loads back into Asteroids.
+ */
+class SavedGame : public GLEntity
+{
+public:
+	explicit SavedGame(const SaveState &state) : state_(state)
+	{
+		SetKey(ASTEROIDS_KEY);
+
+		for (size_t row = 0; row < state.rocks.Size(); ++row)
+		{
+			auto rock = std::make_shared<Rock>(state.rocks.Get(row));
+			entities_.push_back(rock);
+			AggregateMember(rock);
+		}
+
+		if (!state.ship)
+		{
+			AggregateMember(Ship::ShipKey());
+			return;
+		}
+
+		auto ship = std::make_shared<Ship>(*state.ship);
+		entities_.push_back(ship);
+		for (size_t row = 0; row < state.bullets.Size(); ++row)
+		{
+			auto bullet = std::make_shared<Bullet>(state.bullets.Get(row), state.bounds);
+			entities_.push_back(bullet);
+			ship->AddBullet(bullet);
+		}
+		AggregateMember(ship);
+	}
+
+	void PersistMatrices() const override
+	{
+		for (const std::shared_ptr<const GLEntity> &entity : entities_)
+			entity->PersistMatrices();
+	}
+
+	void Save(ptree &tree, const std::string &path) const override
+	{
+		if (!fs::exists(path))
+			fs::create_directories(path);
+		SaveGame(tree, state_.game, state_.tombstones);
+	}
+
+	void Load(ptree &, const std::string &) override
+	{
+	}
+
+	void Save(ptree &tree, Sqlite &) const override
+	{
+		SaveGame(tree, state_.game, state_.tombstones);
+	}
+
+	void Load(ptree &, Sqlite &) override
+	{
+	}
+
+private:
+	const SaveState &state_;
+	std::vector<std::shared_ptr<const GLEntity>> entities_; /**< Every entity of the hierarchy below the game. */
+};
+
+bool OpenSaveDatabases()
+{
+	if (!SaveDatabasesOpen)
+	{
+		Persister->OpenDatabase(ROOT_PATH / DB_NAME);
+		RPersister->OpenDatabase(ROOT_PATH / DB_NAME);
+		SaveDatabasesOpen = true;
+	}
+	return Database->Open(ROOT_PATH / DB_NAME);
 }
 
-void LoadShipResources(std::shared_ptr<Ship> ship)
-{
-	if (ship->GetFrame().GetDirty())
-		RPersister->Load("Shipframe");
-	if (ship->GetUnitVelocity().GetDirty())
-		RPersister->Load("Shipunitvelocity");
-	if (ship->SMatrix().GetDirty())
-		RPersister->Load("ShipS");
-	if (ship->TMatrix().GetDirty())
-		RPersister->Load("ShipT");
-	if (ship->RMatrix().GetDirty())
-		RPersister->Load("ShipR");
-	if (ship->GetShipVertices().GetDirty())
-		RPersister->Load("Shipshipvertices");
-	if (ship->GetShipIndices().GetDirty())
-		RPersister->Load("Shipshipindices");
-	if (ship->GetUnitOrientation().GetDirty())
-		RPersister->Load("Shipunitorientation");
+void CloseSaveDatabases()
+{
+	if (SaveDatabasesOpen)
+	{
+		Persister->CloseDatabase();
+		RPersister->CloseDatabase();
+		SaveDatabasesOpen = false;
+	}
+	Database->Close();
 }
+
+bool WriteSave(const SaveState &state)
+{
+	ScopedTimer timer(TimedStage::WRITE);
+#ifdef SAVE_TO_PACK
+	return SnapshotPack::Write(PACK_PATH.string(), state.game, state.rocks, state.bullets, state.ship ? &*state.ship : nullptr);
+#else
+	Blobs->BeginSave();
+
+	// a compaction sweeps the removed entities and rewrites everything else
+	if (!state.sweep.empty())
+	{
+		Journal->Clear();
+		Blobs->Reset();
+	}
+
+	SavedGame game(state);
+
+#ifndef SAVE_TO_DB
+	Serializer->GetHierarchy().SetSerializationPath(SERIALIZATION_PATH.string());
+	ClearUnusedSerializationKeys(state.sweep);
+	Serializer->Serialize(game);
+	return true;
+#else
+	if (!OpenSaveDatabases())
+	{
+		Journal->Clear();
+		return false;
+	}
+
+	// the matrices commit before the hierarchy which names them, so a committed hierarchy never lacks one;
+	// the journal already counts rolled back matrices as written, so the next save writes everything
+	Database->Begin();
+	game.PersistMatrices();
+	if (!Database->Commit())
+	{
+		Journal->Clear();
+		return false;
+	}
+
+	Persister->Persist(game);
+
+	// the removed entities' matrices are only deleted once the hierarchy naming them is replaced
+	Database->Begin();
+	ClearUnusedPersistenceKeys(state.sweep);
+	if (!Database->Commit())
+	{
+		Journal->Clear();
+		return false;
+	}
+	return true;
+#endif
+#endif
+}
+
 } // end namespace
 
-Asteroids::Asteroids() : threadPool_(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1)
+Asteroids::Asteroids() : bounds_(WorldBounds::FromViewport(WIN_WIDTH, WIN_HEIGHT)),
+						 rockGrid_(SHIP_COLLISION_RADII[static_cast<size_t>(State::LARGE)]),
+						 scheduler_(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1)
 {
 	SetKey(ASTEROIDS_KEY);
+	BuildTickGraph();
 
 	AggregateMember(Ship::ShipKey());
 #ifndef SAVE_TO_DB
-	Asteroids::RegisterSerializationResources(GetKey());
+	ResourceSchema::RegisterSerialization();
 	Deserializer->GetRegistry().RegisterEntity<Ship>(Ship::ShipKey());
 #else
-	Asteroids::RegisterPersistenceResources(GetKey());
 	Loader->GetRegistry().RegisterEntity<Ship>(Ship::ShipKey());
 #endif
 
 	ResetGame();
 }
 
-Asteroids::~Asteroids() noexcept = default;
+Asteroids::~Asteroids() noexcept
+{
+	FlushSave();
+	CloseSaveDatabases();
+}
 
 void Asteroids::Run()
 {
-#ifndef SAVE_TO_DB
+#if defined(SAVE_TO_PACK)
+	LoadPack();
+#elif !defined(SAVE_TO_DB)
 	Deserializer->GetRegistry().RegisterEntity<Asteroids>(ASTEROIDS_KEY);
 	if (fs::exists(SERIALIZATION_PATH))
 	{
 		ClearGame();
+		Blobs->BeginLoad();
 
 		Deserializer->GetRegistry().UnregisterAll();
 		Deserializer->GetHierarchy().LoadSerializationStructure(SERIALIZATION_PATH.string());
@@ -221,20 +478,24 @@ void Asteroids::Run()
 		RegisterEntitiesForSerialization(Deserializer->GetHierarchy().GetSerializationStructure());
 
 		Deserializer->LoadEntity(*this);
+		FinishLoad();
 	}
 #else
 	Loader->GetRegistry().RegisterEntity<Asteroids>(ASTEROIDS_KEY);
 	Loader->OpenDatabase(ROOT_PATH / DB_NAME);
 	RLoader->OpenDatabase(ROOT_PATH / DB_NAME);
+	Database->Open(ROOT_PATH / DB_NAME);
 	if (Loader->GetHierarchy().HasSerializationStructure())
 	{
 		ClearGame();
+		Blobs->BeginLoad();
 
 		Loader->GetRegistry().UnregisterAll();
 
 		RegisterEntitiesForPersistence(Loader->GetHierarchy().GetSerializationStructure());
 
 		Loader->LoadEntity(*this);
+		FinishLoad();
 	}
 	Loader->CloseDatabase();
 	RLoader->CloseDatabase();
@@ -258,176 +519,201 @@ Asteroids::SharedEntity &Asteroids::GetShip()
 
 void Asteroids::ClearGame()
 {
-	for (std::vector<Key> rockKeys = GetRockKeys(); Key &key : rockKeys)
-	{
-		AddToRemoveKeys(key);
-		RemoveMember(key);
-	}
+	ClearRocks();
+	ClearBullets();
 	AddToRemoveKeys(GetShip()->GetKey());
 	RemoveMember(GetShip()->GetKey());
-}
 
-std::string Asteroids::GenerateUUID() const
-{
-	const boost::uuids::uuid tag = boost::uuids::random_generator()();
-	return boost::lexical_cast<std::string>(tag);
+	// the entities being loaded may take the keys of the ones just removed
+	ForgetRemovedEntities();
 }
 
 void Asteroids::ResetGame()
 {
-	auto CreateRock = [this](const GLint randy1, const GLint randy2, const std::string &uuidStr)
-	{
-		SharedEntity rock = std::make_shared<Rock>(State::LARGE, static_cast<const GLfloat>(randy1), static_cast<const GLfloat>(randy2));
-		rock->SetKey(Rock::RockPrefix() + uuidStr);
-
-		AggregateMember(rock);
-#ifndef SAVE_TO_DB
-		Rock::RegisterSerializationResources(rock->GetKey());
-		Deserializer->GetRegistry().RegisterEntity<Rock>(rock->GetKey());
-#else
-		Rock::RegisterPersistenceResources(rock->GetKey());
-		Loader->GetRegistry().RegisterEntity<Rock>(rock->GetKey());
-#endif
-	};
-
 	auto CreateShip = [this]()
 	{
 		SharedEntity &sharedShip = GetShip();
 		sharedShip = std::make_shared<Ship>(Ship::ShipKey());
-#ifndef SAVE_TO_DB
-		Ship::RegisterSerializationResources(sharedShip->GetKey());
-#else
-		Ship::RegisterPersistenceResources(sharedShip->GetKey());
-#endif
 	};
 
 	ClearRocks();
 	ClearBullets();
 	ClearShip();
 
-	GLint randy1, randy2;
-	for (GLint nextRock = 0; nextRock < 10; ++nextRock)
-	{
-		do
-		{
-			randy1 = rand();
-			randy2 = rand();
-			randy1 = pow(-1, nextRock) * randy1;
-			randy1 = randy1 % 15;
-			randy2 = pow(-1, nextRock % 2) * randy2;
-			randy2 = randy2 % 15;
-		} while (fabs(randy1) < 3 || fabs(randy2) < 3);
-
-		CreateRock(randy1, randy2, GenerateUUID());
-	}
+	CounterRng rng(seed_, RESET_STREAM, tickCount_);
+	store_.Rocks().Reserve(scenario_.rocks);
+	for (size_t nextRock = 0; nextRock < scenario_.rocks; ++nextRock)
+		CreateRock(scenario_.MakeRock(rng, bounds_));
 
 	CreateShip();
 	score_ = 0;
+	resetTick_ = tickCount_;
+	fireAccumulator_ = 0.0f;
 }
 
-void Asteroids::UpdateRockTask(std::shared_ptr<GLEntity> sharedRock)
+void Asteroids::SetSeed(const std::uint64_t seed)
 {
-	auto rock = dynamic_pointer_cast<Rock>(sharedRock);
-	GLint randy = rand();
-	randy = (randy % 9) + 1;
-	rock->Update(static_cast<GLfloat>(PI * randy / 5), static_cast<GLfloat>(randy % 3) / 100, static_cast<GLfloat>(randy % 6) / 100);
-};
+	seed_ = seed;
+}
 
-void Asteroids::UpdateShipTask(std::shared_ptr<GLEntity> sharedShip, std::vector<std::future<std::shared_ptr<GLEntity>>> &futures)
+void Asteroids::SetScenario(const Scenario &scenario)
 {
-	auto ship = dynamic_pointer_cast<Ship>(sharedShip);
-	ship->Update(orientationAngle_, thrust_, keysSerialized_, threadPool_, futures);
-};
+	scenario_ = scenario;
+}
 
-void Asteroids::DrawGLEntities()
+void Asteroids::BuildTickGraph()
 {
-	std::vector<std::future<std::shared_ptr<GLEntity>>> futures;
-	std::vector<std::future<std::shared_ptr<GLEntity>>> bulletFutures;
+	// rocks and the ship touch disjoint columns, so they update side by side
+	const TaskGraph::StageId updateRocks = tickGraph_.AddStage(std::bind_front(&Asteroids::UpdateRocks, this));
+	const TaskGraph::StageId updateShip = tickGraph_.AddStage(std::bind_front(&Asteroids::UpdateShip, this));
+	const TaskGraph::StageId collide = tickGraph_.AddStage(std::bind_front(&Asteroids::FindCollisions, this), {updateRocks, updateShip});
+	tickGraph_.AddStage(std::bind_front(&Asteroids::ApplyCollisions, this), {collide});
+}
 
-	for (const Key &key : GetRockKeys())
-	{
-		SharedEntity &sharedRock = GetRock(key);
-		if (!sharedRock)
-			continue;
+void Asteroids::UpdateRocks()
+{
+	ScopedTimer timer(TimedStage::UPDATE_ROCKS);
+	RockArchetype &rocks = store_.Rocks();
+	ParallelFor(scheduler_, rocks.Size(), ROCK_UPDATE_GRAIN, [this, &rocks](const size_t begin, const size_t end)
+				{ Rock::UpdateRocks(rocks, begin, end, bounds_); });
+}
 
-		auto rock = dynamic_pointer_cast<GLEntity>(sharedRock);
-		GLEntityTask task([rock, this]()
-						  { UpdateRockTask(rock); return rock; });
-		futures.push_back(task.GetFuture());
+void Asteroids::UpdateShip()
+{
+	ScopedTimer timer(TimedStage::UPDATE_SHIP);
+	ExpireBullets();
 
-		boost::asio::post(threadPool_, task);
-	}
+	if (auto ship = dynamic_pointer_cast<Ship>(GetShip()); ship)
+		ship->Update(orientationAngle_, thrust_, bounds_, store_.Bullets(), scheduler_);
+}
 
-	if (SharedEntity &sharedShip = GetShip(); sharedShip)
+void Asteroids::Snapshot(RenderSnapshot &snapshot) const
+{
+	const RockArchetype &rocks = store_.Rocks();
+	snapshot.rockX.assign(rocks.x.begin(), rocks.x.end());
+	snapshot.rockY.assign(rocks.y.begin(), rocks.y.end());
+	snapshot.rockSpin.assign(rocks.spin.begin(), rocks.spin.end());
+	snapshot.rockState.assign(rocks.state.begin(), rocks.state.end());
+
+	const BulletArchetype &bullets = store_.Bullets();
+	snapshot.bulletX.assign(bullets.x.begin(), bullets.x.end());
+	snapshot.bulletY.assign(bullets.y.begin(), bullets.y.end());
+	snapshot.bulletAngle.assign(bullets.velocityAngle.begin(), bullets.velocityAngle.end());
+
+	snapshot.hasShip = false;
+	if (auto ship = dynamic_pointer_cast<Ship>(GetAggregatedMember(Ship::ShipKey())); ship)
+		ship->Snapshot(snapshot);
+
+	snapshot.score = score_;
+	snapshot.tick = tickCount_;
+}
+
+void Asteroids::DrawSnapshot(const RenderSnapshot &snapshot)
+{
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	Rock::DrawRocks(snapshot);
+	if (snapshot.hasShip)
 	{
-		auto ship = dynamic_pointer_cast<GLEntity>(sharedShip);
-		GLEntityTask task([ship, &bulletFutures, this]()
-						  { UpdateShipTask(ship, bulletFutures); return ship; });
-		futures.push_back(task.GetFuture());
+		Ship::DrawShip(snapshot);
+		Bullet::DrawBullets(snapshot);
+	}
+}
 
-		boost::asio::post(threadPool_, task);
+void Asteroids::RunScenario()
+{
+	if (scenario_.waveRocks > 0 && scenario_.waveSeconds > 0.0f)
+	{
+		const std::uint64_t waveTicks = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::lround(scenario_.waveSeconds / TICK_SECONDS)));
+		const std::uint64_t ticksSinceReset = tickCount_ - resetTick_;
+		if (ticksSinceReset > 0 && ticksSinceReset % waveTicks == 0)
+		{
+			CounterRng rng(seed_, WAVE_STREAM, tickCount_);
+			for (size_t nextRock = 0; nextRock < scenario_.waveRocks; ++nextRock)
+				CreateRock(scenario_.MakeRock(rng, bounds_));
+		}
 	}
 
-	for (std::future<std::shared_ptr<GLEntity>> &future : futures)
-		future.get()->Draw();
-	for (std::future<std::shared_ptr<GLEntity>> &future : bulletFutures)
-		future.get()->Draw();
+	// bullets past the cap are dropped rather than owed
+	fireAccumulator_ += scenario_.fireRate * TICK_SECONDS;
+	const GLfloat fired = std::floor(fireAccumulator_);
+	fireAccumulator_ -= fired;
+	for (GLfloat nextBullet = 0.0f; nextBullet < fired && store_.Bullets().Size() < scenario_.maxBullets; ++nextBullet)
+		Fire();
 }
 
-void Asteroids::DrawGameInfo()
+void Asteroids::Tick()
 {
-	// glColor3f(0.0f, 1.0f, 1.0f);
+	ScopedTimer timer(TimedStage::TICK);
+	// a save refused while the previous one was written captures the state at this tick boundary
+	if (saveRequested_)
+		SubmitSave();
 
-	// GLint i;
-	// glRasterPos3f(7.5f, -9.0f, 0.0f);
+	RunScenario();
+	tickGraph_.Run(scheduler_);
+	ResetThrustAndRotation();
+	++tickCount_;
+}
 
-	// for (size_t i = 0; i < RESET.size(); ++i)
-	// 	glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, RESET[i]);
+GLint Asteroids::Step(const GLfloat dt)
+{
+	GLint ticks = 0;
+	stepAccumulator_ += dt;
+	while (stepAccumulator_ >= TICK_SECONDS)
+	{
+		Tick();
+		stepAccumulator_ -= TICK_SECONDS;
+		++ticks;
+	}
+	return ticks;
+}
+
+void Asteroids::Draw()
+{
+}
 
-	// glRasterPos3f(-12.0f, 9.0f, 0.0f);
+GLint Asteroids::GetScore() const
+{
+	return score_;
+}
 
-	// for (size_t i = 0; i < SCORE.size(); ++i)
-	// 	glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, SCORE[i]);
-	// char amount[4];
-	// i = snprintf(amount, sizeof(amount), "%d", score_);
-	// for (i = 0; i < 4; i++)
-	// 	glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, amount[i]);
+void Asteroids::SetBounds(const WorldBounds &bounds)
+{
+	bounds_ = bounds;
 }
 
-void Asteroids::Draw()
+GLfloat Asteroids::TickSeconds()
 {
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	DrawGLEntities();
-	DrawGameInfo();
-	DetermineCollisions();
-	ResetThrustAndRotation();
+	return TICK_SECONDS;
 }
 
 void Asteroids::ClearRocks()
 {
-	for (std::vector<Key> rockKeys = GetRockKeys(); Key &key : rockKeys)
+	RockArchetype &rocks = store_.Rocks();
+	if (!savedRocks_.empty())
 	{
-		AddToRemoveKeys(key);
-		SharedEntity &sharedRock = GetRock(key);
-		RemoveMember(sharedRock);
+		for (const EntityHandle handle : rocks.handles)
+		{
+			if (savedRocks_.erase(StreamOf(handle)))
+				removedRocks_.push_back(handle);
+		}
 	}
+	rocks.Clear();
 }
 
 void Asteroids::ClearBullets()
 {
-	auto ship = dynamic_pointer_cast<Ship>(GetShip());
-	if (!ship)
-		return;
-
-	for (std::vector<Key> bulletKeys = ship->GetBulletKeys(); Key &key : bulletKeys)
+	BulletArchetype &bullets = store_.Bullets();
+	if (!savedBullets_.empty())
 	{
-		AddToRemoveKeys(key);
-		SharedEntity &sharedBullet = ship->GetBullet(key);
-		ship->RemoveBullet(sharedBullet->GetKey(), keysSerialized_);
+		for (const EntityHandle handle : bullets.handles)
+		{
+			if (savedBullets_.erase(StreamOf(handle)))
+				removedBullets_.push_back(handle);
+		}
 	}
-
-	AddOutOfScopeBulletsToRemovalKeys();
+	bullets.Clear();
 }
 
 void Asteroids::ClearShip()
@@ -441,166 +727,139 @@ void Asteroids::ClearShip()
 	sharedShip.reset();
 }
 
-bool Asteroids::HasRocks()
+bool Asteroids::HasRocks() const
 {
-	for (std::vector<Key> rockKeys = GetRockKeys(); Key &key : rockKeys)
-	{
-		if (SharedEntity &sharedRock = GetRock(key); sharedRock)
-			return true;
-	}
-	return false;
+	return store_.Rocks().Size() > 0;
 }
 
-bool Asteroids::HasRock(const std::string_view key) const
+void Asteroids::FindCollisions()
 {
-	std::vector<Key> rockKeys = GetRockKeys();
-	return std::any_of(rockKeys.begin(), rockKeys.end(), [&key](const std::string &rockKey)
-					   { return rockKey == key; });
-}
+	ScopedTimer timer(TimedStage::COLLISIONS);
+	collisions_.clear();
 
-void Asteroids::DetermineCollisions()
-{
 	SharedEntity &sharedShip = GetShip();
 	if (!sharedShip)
 		return;
 
-	std::vector<std::pair<std::shared_ptr<Bullet>, std::future<std::shared_ptr<GLEntity>>>> bulletAndRockFuture;
+	rockGrid_.Build(store_.Rocks(), bounds_, scheduler_);
 
-	auto ship = dynamic_pointer_cast<Ship>(sharedShip);
-
-	for (std::vector<Ship::Key> bulletKeys = ship->GetBulletKeys(); Ship::Key &bulletKey : bulletKeys)
+	const size_t bulletCount = store_.Bullets().Size();
+	bulletHits_.resize(bulletCount);
+	auto QueryBullets = [this](const size_t begin, const size_t end)
 	{
-		Ship::SharedEntity &sharedBullet = ship->GetBullet(bulletKey);
-		auto bullet = dynamic_pointer_cast<Bullet>(sharedBullet);
-
-		GLEntityTask task([bullet, this]()
-						  { return Collision(bullet); });
-		bulletAndRockFuture.emplace_back(bullet, task.GetFuture());
-
-		boost::asio::post(threadPool_, task);
-	}
+		for (size_t bullet = begin; bullet < end; ++bullet)
+			bulletHits_[bullet] = Collision(bullet);
+	};
+	ParallelFor(scheduler_, bulletCount, BULLET_QUERY_GRAIN, QueryBullets);
 
-	std::vector<std::pair<std::shared_ptr<Bullet>, Key>> collisionPairs;
-	for (std::pair<std::shared_ptr<Bullet>, std::future<std::shared_ptr<GLEntity>>> &bulletRock : bulletAndRockFuture)
+	for (size_t bullet = 0; bullet < bulletCount; ++bullet)
 	{
-		auto& [bullet, entityFuture] = bulletRock;
-		if (auto rock = dynamic_pointer_cast<Rock>(entityFuture.get()); rock) {
-			collisionPairs.push_back(std::make_pair(bullet, rock->GetKey()));
-		}
+		if (const std::optional<size_t> &rock = bulletHits_[bullet]; rock)
+			collisions_.emplace_back(*rock, bullet);
 	}
+}
 
-	std::vector<std::future<std::shared_ptr<GLEntity>>> collisionFutures;
+void Asteroids::ApplyCollisions()
+{
+	ScopedTimer timer(TimedStage::RESOLVE);
+	SharedEntity &sharedShip = GetShip();
+	if (!sharedShip)
+		return;
 
-	for (std::pair<std::shared_ptr<Bullet>, Key> &collisions : collisionPairs)
+	if (!collisions_.empty())
 	{
-		auto& [bullet, rockKey] = collisions;
-		if (HasRock(rockKey))
-		{
-			GLEntityTask task([bullet, rockKey, this]()
-							  { ProcessCollision(bullet, rockKey); return bullet; });
-			collisionFutures.emplace_back(task.GetFuture());
-			boost::asio::post(threadPool_, task);
-		}
+		ResolveCollisions(collisions_);
+		// broken rocks moved rows and spawned new ones
+		rockGrid_.Build(store_.Rocks(), bounds_, scheduler_);
 	}
 
-	for (std::future<std::shared_ptr<GLEntity>> &future : collisionFutures)
-		future.get();
-
 	if (!HasRocks() || ShipCollision())
 		ResetGame();
 }
 
-void Asteroids::ProcessCollision(std::shared_ptr<Bullet> bullet, const std::string_view rockKey)
+void Asteroids::ResolveCollisions(std::vector<std::pair<size_t, size_t>> &collisions)
 {
+	// Rows are removed by moving the last row into their place, so rocks are resolved from the
+	// highest row down; rows which move are then either already resolved or were not hit.
+	std::sort(collisions.begin(), collisions.end(), std::greater<>());
+
+	std::vector<size_t> spentBullets;
+	std::optional<size_t> previousRock;
+	for (const std::pair<size_t, size_t> &collision : collisions)
 	{
-		std::lock_guard<std::mutex> lock(rockCollisionMutex_);
-		if (HasRock(rockKey))
-		{
-			auto rock = dynamic_pointer_cast<Rock>(GetRock(rockKey));
-			score_ += 1;
-			if (rock->GetState() != State::SMALL)
-			{
-				CalculateConservationOfMomentum(bullet, rock);
-				BreakRock(rock);
-			}
-			DestroyRock(rock);
-		}
+		auto& [rock, bullet] = collision;
+		spentBullets.push_back(bullet);
+
+		// a rock hit by several bullets in the same time step only breaks once
+		if (previousRock == rock)
+			continue;
+		previousRock = rock;
+
+		ProcessCollision(bullet, rock);
 	}
-	DestroyBullet(bullet);
+
+	std::sort(spentBullets.begin(), spentBullets.end(), std::greater<>());
+	for (const size_t bullet : spentBullets)
+		DestroyBullet(bullet);
 }
 
-std::shared_ptr<Rock> Asteroids::Collision(std::shared_ptr<Bullet> _bullet)
+void Asteroids::ProcessCollision(const size_t bullet, const size_t rock)
 {
-	GLfloat epsilon{};
-
-	for (std::vector<Key> rockKeys = GetRockKeys(); Key &key : rockKeys)
+	score_ += 1;
+	if (store_.Rocks().state[rock] != State::SMALL)
 	{
-		SharedEntity &sharedRock = GetRock(key);
-		if (!sharedRock)
-			continue;
-
-		auto rock = dynamic_pointer_cast<Rock>(sharedRock);
-		Resource2DGLfloat& bulletFrame = _bullet->GetFrame();
-		Resource2DGLfloat& rockFrame = rock->GetFrame();
+		CalculateConservationOfMomentum(bullet, rock);
+		BreakRock(rock);
+	}
+	DestroyRock(rock);
+}
 
-		GLfloat ray = std::hypot(fabs(bulletFrame.GetData(0, 0) - rockFrame.GetData(0, 0)), 
-						 fabs(bulletFrame.GetData(1, 0) - rockFrame.GetData(1, 0)));
+std::optional<size_t> Asteroids::Collision(const size_t bullet) const
+{
+	const GLfloat bulletX = store_.Bullets().x[bullet];
+	const GLfloat bulletY = store_.Bullets().y[bullet];
 
-		if (rock->GetState() == State::LARGE)
-			epsilon = 1.7f;
-		else if (rock->GetState() == State::MEDIUM)
-			epsilon = 1.3f;
-		else
-			epsilon = 0.8f;
+	std::optional<size_t> hit;
+	auto HitsBullet = [&hit, bulletX, bulletY](const size_t *rows, const GLfloat *xs, const GLfloat *ys, const State *states, const size_t count)
+	{
+		if (std::optional<size_t> offset = CollisionKernel::FirstHit(bulletX, bulletY, xs, ys, states, count, BULLET_SQUARED_RADII); offset)
+			hit = rows[*offset];
+		return hit.has_value();
+	};
 
-		if (ray < epsilon)
-			return rock;
-	}
-	return nullptr;
+	rockGrid_.VisitRuns(bulletX, bulletY, HitsBullet);
+	return hit;
 }
 
-std::shared_ptr<Rock> Asteroids::ShipCollision()
+bool Asteroids::ShipCollision() const
 {
-	GLfloat epsilon{};
+	auto ship = dynamic_pointer_cast<Ship>(GetAggregatedMember(Ship::ShipKey()));
+	if (!ship)
+		return false;
 
-	if (SharedEntity &sharedShip = GetShip(); sharedShip)
+	Mat4Resource& shipFrame = ship->GetFrame();
+	const GLfloat shipX = shipFrame.GetData(0, 0);
+	const GLfloat shipY = shipFrame.GetData(1, 0);
+
+	auto HitsShip = [shipX, shipY](const size_t *, const GLfloat *xs, const GLfloat *ys, const State *states, const size_t count)
 	{
-		auto ship = dynamic_pointer_cast<Ship>(sharedShip);
-		for (std::vector<Key> rockKeys = GetRockKeys(); Key &key : rockKeys)
-		{
-			SharedEntity &sharedRock = GetRock(key);
-			if (!sharedRock)
-				continue;
-
-			auto rock = dynamic_pointer_cast<Rock>(sharedRock);
-			Resource2DGLfloat& shipFrame = ship->GetFrame();
-			Resource2DGLfloat& rockFrame = rock->GetFrame();
-
-			GLfloat ray = std::hypot(fabs(shipFrame.GetData(0, 0) - rockFrame.GetData(0, 0)),
-							 fabs(shipFrame.GetData(1, 0) - rockFrame.GetData(1, 0)));
-
-			if (rock->GetState() == State::LARGE)
-				epsilon = 2.2f;
-			else if (rock->GetState() == State::MEDIUM)
-				epsilon = 1.6f;
-			else
-				epsilon = 1.0f;
-
-			if (ray < epsilon)
-				return rock;
-		}
-	}
-	return nullptr;
+		return CollisionKernel::FirstHit(shipX, shipY, xs, ys, states, count, SHIP_SQUARED_RADII).has_value();
+	};
+
+	return rockGrid_.VisitRuns(shipX, shipY, HitsShip);
 }
 
-void Asteroids::CalculateConservationOfMomentum(std::shared_ptr<Bullet> bullet, std::shared_ptr<Rock> rock)
+void Asteroids::CalculateConservationOfMomentum(const size_t bullet, const size_t rock)
 {
-	const GLfloat bulletSpeed = bullet->GetSpeed();
-	const GLfloat rockSpeed = rock->GetSpeed();
-	const GLfloat bulletMass = bullet->GetMass();
-	const GLfloat rockMass = rock->GetMass();
-	const GLfloat bulletVelAngle = bullet->GetVelocityAngle();
-	const GLfloat rockVelAngle = rock->GetVelocityAngle();
+	const BulletArchetype &bullets = store_.Bullets();
+	RockArchetype &rocks = store_.Rocks();
+
+	const GLfloat bulletSpeed = bullets.speed[bullet];
+	const GLfloat rockSpeed = rocks.speed[rock];
+	const GLfloat bulletMass = bullets.mass[bullet];
+	const GLfloat rockMass = rocks.mass[rock];
+	const GLfloat bulletVelAngle = bullets.velocityAngle[bullet];
+	const GLfloat rockVelAngle = rocks.velocityAngle[rock];
 
 	const GLfloat xCompMomentumB = bulletMass * bulletSpeed * cos(bulletVelAngle);
 	const GLfloat yCompMomentumB = bulletMass * bulletSpeed * sin(bulletVelAngle);
@@ -618,98 +877,85 @@ void Asteroids::CalculateConservationOfMomentum(std::shared_ptr<Bullet> bullet,
 	else if (yCompMomentumR < 0)
 		momentumAngle += 2 * PI;
 
-	rock->SetMass(rockMass + bulletMass);
-	rock->SetSpeed(momentumMagnitude / rockMass);
+	rocks.mass[rock] = rockMass + bulletMass;
+	rocks.speed[rock] = momentumMagnitude / rockMass;
 
-	rock->SetVelocityAngle(momentumAngle);
+	rocks.velocityAngle[rock] = momentumAngle;
 
-	rock->SetUnitVelocity(0, 0, cos(momentumAngle));
-	rock->SetUnitVelocity(1, 0, sin(momentumAngle));
+	rocks.ux[rock] = cos(momentumAngle);
+	rocks.uy[rock] = sin(momentumAngle);
 }
 
-std::shared_ptr<Rock> Asteroids::MakeRock(const State rockSize, std::shared_ptr<Rock> rock, const bool halfMass, const bool clockwise)
+RockRow Asteroids::MakeRock(const State rockSize, const RockRow &rock, const bool halfMass, const bool clockwise, CounterRng &rng)
 {
 	const GLint massDenominator = halfMass ? 2 : 1;
 	const GLfloat angleMultiplier = clockwise ? 1.0 : -1.0;
 
-	Resource2DGLfloat& rockFrame = rock->GetFrame();
-	auto rock1 = std::make_shared<Rock>(rockSize, rockFrame.GetData(0, 0), rockFrame.GetData(1, 0));
+	RockRow rock1 = Rock::NewRow(rockSize, rock.x, rock.y, rng);
 
-	rock1->SetKey(Rock::RockPrefix() + GenerateUUID());
-#ifndef SAVE_TO_DB
-	Rock::RegisterSerializationResources(rock1->GetKey());
-#else
-	Rock::RegisterPersistenceResources(rock1->GetKey());
-#endif
-
-	rock1->SetMass(rock->GetMass() / massDenominator);
-	rock1->SetSpeed(rock->GetSpeed());
-	rock1->SetSpin(rock->GetSpin());
-	rock1->SetSpinEpsilon(rock->GetSpinEpsilon());
-	rock1->SetVelocityAngle(rock->GetVelocityAngle() + angleMultiplier * PI / 4);
-	const GLfloat rock1VelAngle = rock1->GetVelocityAngle();
-	rock1->SetUnitVelocity(0, 0, cos(rock1VelAngle));
-	rock1->SetUnitVelocity(1, 0, sin(rock1VelAngle));
-	rock1->SetRockInitialized(true);
+	rock1.mass = rock.mass / massDenominator;
+	rock1.speed = rock.speed;
+	rock1.spin = rock.spin;
+	rock1.spinEpsilon = rock.spinEpsilon;
+	rock1.velocityAngle = rock.velocityAngle + angleMultiplier * PI / 4;
+	rock1.ux = cos(rock1.velocityAngle);
+	rock1.uy = sin(rock1.velocityAngle);
+	rock1.initialized = true;
 
 	return rock1;
 }
 
-void Asteroids::BreakRock(std::shared_ptr<Rock> rock)
+void Asteroids::BreakRock(const size_t row)
 {
-	std::shared_ptr<Rock> rock1;
-	std::shared_ptr<Rock> rock2;
-	if (rock->GetState() == State::LARGE)
+	const RockRow rock = store_.Rocks().Get(row);
+	CounterRng rng(seed_, StreamOf(rock.handle), tickCount_);
+	if (rock.state == State::LARGE)
 	{
-		rock1 = MakeRock(State::MEDIUM, rock, true, true);
-		rock2 = MakeRock(State::MEDIUM, rock, true, false);
+		CreateRock(MakeRock(State::MEDIUM, rock, true, true, rng));
+		CreateRock(MakeRock(State::MEDIUM, rock, true, false, rng));
 	}
-	else if (rock->GetState() == State::MEDIUM)
+	else if (rock.state == State::MEDIUM)
 	{
-		rock1 = MakeRock(State::SMALL, rock, false, true);
-		rock2 = MakeRock(State::SMALL, rock, false, false);
+		CreateRock(MakeRock(State::SMALL, rock, false, true, rng));
+		CreateRock(MakeRock(State::SMALL, rock, false, false, rng));
 	}
-	AggregateMember(rock1);
-	AggregateMember(rock2);
-#ifndef SAVE_TO_DB
-	Deserializer->GetRegistry().RegisterEntity<Rock>(rock1->GetKey());
-	Deserializer->GetRegistry().RegisterEntity<Rock>(rock2->GetKey());
-#else
-	Loader->GetRegistry().RegisterEntity<Rock>(rock1->GetKey());
-	Loader->GetRegistry().RegisterEntity<Rock>(rock2->GetKey());
-#endif
 }
 
-void Asteroids::DestroyBullet(std::shared_ptr<Bullet> bullet)
+void Asteroids::CreateRock(const RockRow &rock)
 {
-	const std::string bulletKey = bullet->GetKey();
-	AddToRemoveKeys(bulletKey);
-
-	SharedEntity &sharedShip = GetShip();
-	if (!sharedShip)
-		return;
+	store_.Rocks().Add(rock);
+}
 
-	auto ship = dynamic_pointer_cast<Ship>(sharedShip);
+void Asteroids::CreateBullet(const BulletRow &bullet)
+{
+	store_.Bullets().Add(bullet);
+}
 
-#ifndef SAVE_TO_DB
-	Deserializer->GetRegistry().UnregisterEntity(bulletKey);
-#else
-	Loader->GetRegistry().UnregisterEntity(bulletKey);
-#endif
-	ship->RemoveBullet(bulletKey, keysSerialized_);
+void Asteroids::DestroyBullet(const size_t row)
+{
+	// only entities in the last save or load leave persisted state behind; keys are derived when saving
+	BulletArchetype &bullets = store_.Bullets();
+	if (savedBullets_.erase(StreamOf(bullets.handles[row])))
+		removedBullets_.push_back(bullets.handles[row]);
+	bullets.Remove(row);
 }
 
-void Asteroids::DestroyRock(std::shared_ptr<Rock> rock)
+void Asteroids::DestroyRock(const size_t row)
 {
-	const std::string rockKey = rock->GetKey();
-	AddToRemoveKeys(rockKey);
+	RockArchetype &rocks = store_.Rocks();
+	if (savedRocks_.erase(StreamOf(rocks.handles[row])))
+		removedRocks_.push_back(rocks.handles[row]);
+	rocks.Remove(row);
+}
 
-#ifndef SAVE_TO_DB
-	Deserializer->GetRegistry().UnregisterEntity(rockKey);
-#else
-	Loader->GetRegistry().UnregisterEntity(rockKey);
-#endif
-	RemoveMember(rockKey);
+void Asteroids::ExpireBullets()
+{
+	BulletArchetype &bullets = store_.Bullets();
+	for (size_t row = bullets.Size(); row-- > 0;)
+	{
+		if (bullets.outOfBounds[row])
+			DestroyBullet(row);
+	}
 }
 
 void Asteroids::ResetThrustAndRotation()
@@ -723,7 +969,7 @@ void Asteroids::Fire()
 	if (SharedEntity &sharedShip = GetShip(); sharedShip)
 	{
 		auto ship = dynamic_pointer_cast<Ship>(sharedShip);
-		ship->Fire();
+		ship->Fire(store_.Bullets(), scenario_.maxBullets);
 	}
 }
 
@@ -747,9 +993,7 @@ void Asteroids::Save(boost::property_tree::ptree &tree, const std::string &path)
 	if (!fs::exists(path))
 		fs::create_directories(path);
 
-	tree.put(SCORE_KEY, score_);
-	tree.put(ORIENTATION_ANGLE_KEY, orientationAngle_);
-	tree.put(THRUST_KEY, thrust_);
+	SaveGame(tree, GameRow{score_, orientationAngle_, thrust_}, keysToRemove_);
 }
 
 void Asteroids::Load(boost::property_tree::ptree &tree, const std::string &path)
@@ -757,13 +1001,12 @@ void Asteroids::Load(boost::property_tree::ptree &tree, const std::string &path)
 	score_ = std::stoi(tree.get_child(SCORE_KEY).data());
 	orientationAngle_ = std::stof(tree.get_child(ORIENTATION_ANGLE_KEY).data());
 	thrust_ = std::stoi(tree.get_child(THRUST_KEY).data());
+	GetTombstones(tree, keysToRemove_);
 }
 
 void Asteroids::Save(boost::property_tree::ptree &tree, Sqlite &database) const
 {
-	tree.put(SCORE_KEY, score_);
-	tree.put(ORIENTATION_ANGLE_KEY, orientationAngle_);
-	tree.put(THRUST_KEY, thrust_);
+	SaveGame(tree, GameRow{score_, orientationAngle_, thrust_}, keysToRemove_);
 }
 
 void Asteroids::Load(boost::property_tree::ptree &tree, Sqlite &database)
@@ -771,128 +1014,282 @@ void Asteroids::Load(boost::property_tree::ptree &tree, Sqlite &database)
 	score_ = std::stoi(tree.get_child(SCORE_KEY).data());
 	orientationAngle_ = std::stof(tree.get_child(ORIENTATION_ANGLE_KEY).data());
 	thrust_ = std::stoi(tree.get_child(THRUST_KEY).data());
+	GetTombstones(tree, keysToRemove_);
 }
 
 void Asteroids::AddToRemoveKeys(const std::string_view key)
 {
-	if (keysSerialized_.find(key) != keysSerialized_.end())
+	// an entity later created under the same key is saved in full
+	Journal->Forget(key);
+	if (keysSerialized_.contains(key) || keysSaving_.contains(key))
 		keysToRemove_.insert(std::string(key));
 }
 
-void Asteroids::AddOutOfScopeBulletsToRemovalKeys()
+void Asteroids::ForgetRemovedEntities()
 {
-	auto ship = std::dynamic_pointer_cast<Ship>(GetShip());
-	for (const std::set<std::string, std::less<>> &outOfScopeBullets = ship->GetOutOfScopeBulletKeys(); const Key &key : outOfScopeBullets)
-		AddToRemoveKeys(key);
-	ship->ClearOutOfScopeBulletKeys();
+	// every recorded entity was persisted, so its key is tombstoned whether or not this session saved it
+	auto Forget = [this](const std::string &key)
+	{
+		Journal->Forget(key);
+		keysToRemove_.insert(key);
+	};
+
+	for (const EntityHandle handle : removedRocks_)
+		Forget(Rock::RockKey(handle));
+	for (const EntityHandle handle : removedBullets_)
+		Forget(Bullet::BulletKey(handle));
+	removedRocks_.clear();
+	removedBullets_.clear();
 }
 
-void Asteroids::ClearUnusedSerializationKeys()
+void Asteroids::MarkSaved()
 {
-	AddOutOfScopeBulletsToRemovalKeys();
-
-	for (const std::string &key : keysToRemove_)
+	auto Mark = [](const std::vector<EntityHandle> &handles, std::unordered_set<std::uint64_t> &saved)
 	{
-		if (key.find(ROCK_PREFIX) != std::string::npos)
-		{
-			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / GetKey() / key;
-			for (const std::string &resourceKey : ROCK_RESOURCES)
-				RSerializer->Unserialize(resourceKey, resourceFolder.string());
-			fs::remove(resourceFolder);
-		}
-		else if (key.find(BULLET_PREFIX) != std::string::npos)
-		{
-			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / GetKey() / Ship::ShipKey() / key;
-			for (const std::string &resourceKey : BULLET_RESOURCES)
-				RSerializer->Unserialize(resourceKey, resourceFolder.string());
-			fs::remove(resourceFolder);
-		}
-		else
-		{
-			const fs::path resourceFolder = SERIALIZATION_PATH.parent_path() / GetKey() / key;
-			for (const std::string &resourceKey : SHIP_RESOURCES)
-				RSerializer->Unserialize(resourceKey, resourceFolder.string());
-		}
-	}
-	keysToRemove_.clear();
+		saved.clear();
+		saved.reserve(handles.size());
+		for (const EntityHandle handle : handles)
+			saved.insert(StreamOf(handle));
+	};
+
+	Mark(store_.Rocks().handles, savedRocks_);
+	Mark(store_.Bullets().handles, savedBullets_);
 }
 
-void Asteroids::ClearUnusedPersistenceKeys()
+
+std::set<std::string, std::less<>> Asteroids::GetKeysToSerialize()
 {
-	AddOutOfScopeBulletsToRemovalKeys();
+	const std::vector<std::string> keysSerialized = GetAggregatedMemberKeys();
+
+	std::set<std::string, std::less<>> keys;
+	keys.insert(keysSerialized.begin(), keysSerialized.end());
+	for (const EntityHandle handle : store_.Rocks().handles)
+		keys.insert(Rock::RockKey(handle));
+	for (const EntityHandle handle : store_.Bullets().handles)
+		keys.insert(Bullet::BulletKey(handle));
+	return keys;
+}
 
-	for (const std::string &key : keysToRemove_)
+
+void Asteroids::AdoptLoadedEntities()
+{
+	for (const Key &key : GetRockKeys())
 	{
-		if (key.find(ROCK_PREFIX) != std::string::npos)
+		if (auto rock = dynamic_pointer_cast<Rock>(GetRock(key)); rock)
 		{
-			for (const std::string &resourceKey : RockResourceKeys(key))
-				RPersister->Load(resourceKey);
-		}
-		else if (key.find(BULLET_PREFIX) != std::string::npos)
-		{
-			for (const std::string &resourceKey : BulletResourceKeys(key))
-				RPersister->Load(resourceKey);
+			RockRow row = rock->ToRow();
+			if (!row.initialized)
+			{
+				CounterRng rng(seed_, StreamOf(row.handle), tickCount_);
+				InitializeRockVelocity(row, rng);
+			}
+			// rocks saved under keys which were not derived from a handle are re-keyed
+			if (!store_.Rocks().Restore(row))
+			{
+				Journal->Forget(key);
+				keysToRemove_.insert(key);
+				CreateRock(row);
+			}
 		}
-		else
+		RemoveMember(key);
+	}
+
+	auto ship = dynamic_pointer_cast<Ship>(GetShip());
+	if (!ship)
+	{
+		MarkSaved();
+		return;
+	}
+
+	for (const Key &key : ship->GetBulletKeys())
+	{
+		if (auto bullet = dynamic_pointer_cast<Bullet>(ship->GetBullet(key)); bullet)
 		{
-			auto ship = dynamic_pointer_cast<Ship>(GetShip());
-			LoadShipResources(ship);
+			const BulletRow row = bullet->ToRow();
+			if (!store_.Bullets().Restore(row))
+			{
+				Journal->Forget(key);
+				keysToRemove_.insert(key);
+				CreateBullet(row);
+			}
 		}
+		ship->RemoveBullet(key);
 	}
-	keysToRemove_.clear();
+	MarkSaved();
 }
 
-std::set<std::string, std::less<>> Asteroids::GetKeysToSerialize()
+void Asteroids::FinishLoad()
 {
-	std::vector<std::string> keysSerialized = GetAggregatedMemberKeys();
-	auto ship = std::dynamic_pointer_cast<Ship>(GetShip());
-	std::vector<std::string> bulletsSerialized = ship->GetBulletKeys();
-	keysSerialized.insert(keysSerialized.end(), bulletsSerialized.begin(), bulletsSerialized.end());
+	if (Restore->Finish(scheduler_))
+	{
+		AdoptLoadedEntities();
+		return;
+	}
 
-	std::set<std::string, std::less<>> keys;
-	keys.insert(keysSerialized.begin(), keysSerialized.end());
-	return keys;
+	// a save missing any of its matrices is dropped rather than loaded with default or stale transforms
+	for (const Key &key : GetRockKeys())
+		RemoveMember(key);
+	Journal->Clear();
+	ResetGame();
 }
 
 void Asteroids::Serialize()
 {
-#ifndef SAVE_TO_DB
-	Serializer->GetHierarchy().SetSerializationPath(SERIALIZATION_PATH.string());
-	ClearUnusedSerializationKeys();
-	Serializer->Serialize(*this);
-#else
-	Persister->OpenDatabase(ROOT_PATH / DB_NAME);
-	RPersister->OpenDatabase(ROOT_PATH / DB_NAME);
-
-	ClearUnusedPersistenceKeys();
-
-	Persister->Persist(*this);
-
-	Persister->CloseDatabase();
-	RPersister->CloseDatabase();
-#endif
-
-	keysSerialized_ = GetKeysToSerialize();
+	saveRequested_ = true;
+	SubmitSave();
 }
 
 void Asteroids::Deserialize()
 {
+	ScopedTimer timer(TimedStage::LOAD);
+	// a load observes every save requested before it
+	FlushSave();
+
+#ifdef SAVE_TO_PACK
+	LoadPack();
+#else
 	ClearGame();
+	Blobs->BeginLoad();
 
 #ifndef SAVE_TO_DB
 	Deserializer->GetRegistry().UnregisterAll();
 	Deserializer->GetHierarchy().LoadSerializationStructure(SERIALIZATION_PATH.string());
 	RegisterEntitiesForSerialization(Deserializer->GetHierarchy().GetSerializationStructure());
 	Deserializer->LoadEntity(*this);
+	FinishLoad();
 #else
 	Loader->GetRegistry().UnregisterAll();
 	Loader->OpenDatabase(ROOT_PATH / DB_NAME);
 	RLoader->OpenDatabase(ROOT_PATH / DB_NAME);
+	Database->Open(ROOT_PATH / DB_NAME);
 	RegisterEntitiesForPersistence(Loader->GetHierarchy().GetSerializationStructure());
 	Loader->LoadEntity(*this);
+	FinishLoad();
 	Loader->CloseDatabase();
 	RLoader->CloseDatabase();
 #endif
 
 	keysSerialized_ = GetKeysToSerialize();
+#endif
+}
+
+void Asteroids::LoadPack()
+{
+	SnapshotPack pack;
+	if (!pack.Open(PACK_PATH.string()))
+		return;
+
+	ClearGame();
+
+	const GameRow game = pack.GetGame();
+	score_ = game.score;
+	orientationAngle_ = game.orientationAngle;
+	thrust_ = game.thrust;
+
+	// rows are decoded straight from the mapping into the store, without materializing entities
+	store_.Rocks().Reserve(pack.GetRockCount());
+	for (size_t row = 0; row < pack.GetRockCount(); ++row)
+	{
+		RockRow rock = pack.GetRock(row);
+		if (!rock.initialized)
+		{
+			CounterRng rng(seed_, StreamOf(rock.handle), tickCount_);
+			InitializeRockVelocity(rock, rng);
+		}
+		if (!store_.Rocks().Restore(rock))
+			CreateRock(rock);
+	}
+
+	for (size_t row = 0; row < pack.GetBulletCount(); ++row)
+	{
+		const BulletRow bullet = pack.GetBullet(row);
+		if (!store_.Bullets().Restore(bullet))
+			CreateBullet(bullet);
+	}
+
+	if (pack.HasShip())
+		AggregateMember(std::make_shared<Ship>(pack.GetShip()));
+	else
+		AggregateMember(Ship::ShipKey());
+	MarkSaved();
+}
+
+void Asteroids::SubmitSave()
+{
+	// a request made while a save is written waits in saveRequested_, so nothing is captured until the writer is idle
+	FinishSave();
+	if (saveWriter_.Busy())
+		return;
+
+	ScopedTimer timer(TimedStage::SAVE);
+	ForgetRemovedEntities();
+
+	// the state is copied rather than shared, since every row changes on the next tick anyway
+	auto state = std::make_shared<SaveState>();
+	state->game = GameRow{score_, orientationAngle_, thrust_};
+	state->rocks = store_.Rocks();
+	state->bullets = store_.Bullets();
+	if (auto ship = dynamic_pointer_cast<Ship>(GetShip()); ship)
+		state->ship = ship->ToRow();
+	state->bounds = bounds_;
+
+	// a key which is live again was forgotten by the journal when it was removed, so its resources are rewritten
+	const std::set<std::string, std::less<>> keysToSerialize = GetKeysToSerialize();
+	std::erase_if(keysToRemove_, [&keysToSerialize](const std::string &key)
+				  { return keysToSerialize.contains(key); });
+
+	// removed entities are only tombstoned until the next compaction, which sweeps them and rewrites everything
+	const bool compact = savesSinceCompaction_ + 1 >= COMPACTION_INTERVAL;
+	if (compact)
+		state->sweep = keysToRemove_;
+	else
+		state->tombstones = keysToRemove_;
+
+	auto Write = [state]()
+	{
+		const bool written = WriteSave(*state);
+		Journal->EndSave();
+		return written;
+	};
+
+	// entities forgotten from here on may be recorded again by this save, so the journal forgets them once more after it
+	Journal->BeginSave();
+	if (!saveWriter_.TrySubmit(Write))
+	{
+		Journal->EndSave();
+		return;
+	}
+
+	// the keys only count as saved, and the swept keys as gone, once the writer reports the save was written
+	saveRequested_ = false;
+	compacting_ = compact;
+	keysSweeping_ = state->sweep;
+	keysSaving_ = keysToSerialize;
+	MarkSaved();
+}
+
+void Asteroids::FinishSave()
+{
+	const std::optional<bool> written = saveWriter_.TakeResult();
+	if (!written || !*written)
+		return;
+
+	savesSinceCompaction_ = compacting_ ? 0 : savesSinceCompaction_ + 1;
+	for (const std::string &key : keysSweeping_)
+		keysToRemove_.erase(key);
+	keysSweeping_.clear();
+	keysSerialized_ = std::move(keysSaving_);
+	keysSaving_.clear();
+}
+
+void Asteroids::FlushSave()
+{
+	saveWriter_.Wait();
+	FinishSave();
+	if (!saveRequested_)
+		return;
+
+	SubmitSave();
+	saveWriter_.Wait();
+	FinishSave();
 }
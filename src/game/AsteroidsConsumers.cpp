@@ -5,61 +5,85 @@
 #include <string>
 
 #include "Entities/Entity.h"
+#include "Events/EventChannel.h"
 #include "Events/EventConsumer.h"
 
 #include "configuration/config.h"
 #include "configuration/filesystem.h"
-#include "game/Asteroids.h"
+#include "game/Simulation.h"
+#include "gl/GLBackendEmitters.h"
 
-using asteroids::Asteroids;
 using asteroids::AsteroidsConsumers;
+using asteroids::Command;
+using asteroids::GLBackendEmitters;
+using asteroids::Simulation;
 using entity::Entity;
+using events::EventChannel;
 using events::EventConsumer;
 using Consumer = EventConsumer<void(void)>;
 
 namespace
 {
 const std::string ASTEROIDS_CONSUMERS_KEY = "AsteroidsConsumers";
+
+const std::string LEFT_EVENT = "left_event";
+const std::string LEFT_ACTION = "left_action";
+const std::string RIGHT_EVENT = "right_event";
+const std::string RIGHT_ACTION = "right_action";
+const std::string THRUST_EVENT = "thrust_event";
+const std::string THRUST_ACTION = "thrust_action";
+const std::string FIRE_EVENT = "fire_event";
+const std::string FIRE_ACTION = "fire_action";
+const std::string RESET_EVENT = "reset_event";
+const std::string RESET_ACTION = "reset_action";
+const std::string DRAW_EVENT = "draw_event";
+const std::string DRAW_ACTION = "draw_action";
+const std::string RUN_EVENT = "run_event";
+const std::string RUN_ACTION = "run_action";
+const std::string SERIALIZE_EVENT = "serialize_event";
+const std::string SERIALIZE_ACTION = "serialize_action";
+const std::string DESERIALIZE_EVENT = "deserialize_event";
+const std::string DESERIALIZE_ACTION = "deserialize_action";
 } // end namespace
 
 AsteroidsConsumers::AsteroidsConsumers(
-	std::shared_ptr<Asteroids> asteroids) : Entity(),
-											leftArrowConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->RotateLeft(); })),
-											rightArrowConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->RotateRight(); })),
-											thrustConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Thrust(); })),
-											fireConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Fire(); })),
-											resetConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->ResetGame(); })),
-											drawConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Draw(); })),
-											runConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Run(); })),
-											serializeConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Serialize(); })),
-											deserializeConsumer_(
-												std::make_shared<Consumer>(
-													[asteroids]()
-													{ asteroids->Deserialize(); }))
+	std::shared_ptr<Simulation> simulation) : Entity(),
+											  leftArrowConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::ROTATE_LEFT); })),
+											  rightArrowConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::ROTATE_RIGHT); })),
+											  thrustConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::THRUST); })),
+											  fireConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::FIRE); })),
+											  resetConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::RESET); })),
+											  drawConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Draw(); })),
+											  runConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Start(); })),
+											  serializeConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::SERIALIZE); })),
+											  deserializeConsumer_(
+												  std::make_shared<Consumer>(
+													  [simulation]()
+													  { simulation->Post(Command::DESERIALIZE); }))
 {
 	SetKey(ASTEROIDS_CONSUMERS_KEY);
 }
@@ -109,4 +133,26 @@ std::shared_ptr<Consumer> AsteroidsConsumers::GetSerializeConsumer()
 std::shared_ptr<Consumer> AsteroidsConsumers::GetDeserializeConsumer()
 {
 	return deserializeConsumer_;
-}
\ No newline at end of file
+}
+
+void asteroids::RegisterEvents(AsteroidsConsumers &frontend, GLBackendEmitters &emitters, EventChannel &channel)
+{
+	channel.RegisterEmitter(LEFT_EVENT, emitters.GetLeftArrowEmitter());
+	channel.RegisterConsumer(LEFT_ACTION, LEFT_EVENT, frontend.GetLeftArrowConsumer());
+	channel.RegisterEmitter(RIGHT_EVENT, emitters.GetRightArrowEmitter());
+	channel.RegisterConsumer(RIGHT_ACTION, RIGHT_EVENT, frontend.GetRightArrowConsumer());
+	channel.RegisterEmitter(THRUST_EVENT, emitters.GetThrustEmitter());
+	channel.RegisterConsumer(THRUST_ACTION, THRUST_EVENT, frontend.GetThrustConsumer());
+	channel.RegisterEmitter(FIRE_EVENT, emitters.GetFireEmitter());
+	channel.RegisterConsumer(FIRE_ACTION, FIRE_EVENT, frontend.GetFireConsumer());
+	channel.RegisterEmitter(RESET_EVENT, emitters.GetResetEmitter());
+	channel.RegisterConsumer(RESET_ACTION, RESET_EVENT, frontend.GetResetConsumer());
+	channel.RegisterEmitter(DRAW_EVENT, emitters.GetDrawEmitter());
+	channel.RegisterConsumer(DRAW_ACTION, DRAW_EVENT, frontend.GetDrawConsumer());
+	channel.RegisterEmitter(RUN_EVENT, emitters.GetRunEmitter());
+	channel.RegisterConsumer(RUN_ACTION, RUN_EVENT, frontend.GetRunConsumer());
+	channel.RegisterEmitter(SERIALIZE_EVENT, emitters.GetSerializeEmitter());
+	channel.RegisterConsumer(SERIALIZE_ACTION, SERIALIZE_EVENT, frontend.GetSerializeConsumer());
+	channel.RegisterEmitter(DESERIALIZE_EVENT, emitters.GetDeserializeEmitter());
+	channel.RegisterConsumer(DESERIALIZE_ACTION, DESERIALIZE_EVENT, frontend.GetDeserializeConsumer());
+}
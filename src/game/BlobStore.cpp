@@ -0,0 +1,80 @@
+#include "game/BlobStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "configuration/filesystem.hpp"
+#include "configuration/serialization.h"
+#include "gl/Mat4.h"
+#include "gl/Mat4Resource.h"
+
+using asteroids::BlobStore;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+
+namespace
+{
+const std::string BLOB_PREFIX = "blob";
+const std::string BLOB_FOLDER = "Blobs";
+} // end namespace
+
+BlobStore *BlobStore::GetInstance()
+{
+	static BlobStore instance;
+	return &instance;
+}
+
+BlobStore::Digest BlobStore::Hash(const void *data, const size_t bytes, Digest digest)
+{
+	const unsigned char *byte = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		digest ^= byte[i];
+		digest *= FNV_PRIME;
+	}
+	return digest;
+}
+
+BlobStore::Digest BlobStore::Hash(const Mat4Resource &resource)
+{
+	const Mat4 &matrix = resource.Get();
+	return Hash(matrix.Data(), sizeof(matrix.m));
+}
+
+std::string BlobStore::BlobKey(const Digest digest)
+{
+	char hex[17];
+	std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(digest));
+	return BLOB_PREFIX + hex;
+}
+
+std::string BlobStore::BlobPath()
+{
+	return (SERIALIZATION_PATH.parent_path() / BLOB_FOLDER).string();
+}
+
+void BlobStore::BeginSave()
+{
+#ifndef SAVE_TO_DB
+	if (!fs::exists(BlobPath()))
+		fs::create_directories(BlobPath());
+#endif
+}
+
+void BlobStore::Reset()
+{
+	written_.clear();
+}
+
+void BlobStore::BeginLoad()
+{
+	deserialized_.clear();
+	loaded_.clear();
+}
+
+bool BlobStore::MarkWritten(const std::string &blobKey)
+{
+	return written_.insert(blobKey).second;
+}
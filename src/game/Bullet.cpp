@@ -1,7 +1,6 @@
 #include "game/Bullet.h"
 
 #include <memory>
-#include <numbers>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -10,36 +9,47 @@
 
 #include "DatabaseAdapters/IPersistableResource.h"
 #include "DatabaseAdapters/ResourceLoader.h"
-#include "DatabaseAdapters/ResourcePersister.h"
 #include "DatabaseAdapters/Sqlite.h"
 #include "FilesystemAdapters/EntityDeserializer.h"
 #include "FilesystemAdapters/ISerializableResource.h"
 #include "FilesystemAdapters/ResourceDeserializer.h"
-#include "FilesystemAdapters/ResourceSerializer.h"
 #include "test_filesystem_adapters/ContainerResource.h"
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/filesystem.hpp"
 #include "configuration/serialization.h"
+#include "game/BlobStore.h"
+#include "game/EntityStore.h"
+#include "game/MeshRegistry.h"
+#include "game/ResourceSchema.h"
 
+using asteroids::BlobStore;
 using asteroids::Bullet;
+using asteroids::BulletArchetype;
+using asteroids::BulletRow;
+using asteroids::EntityHandle;
 using asteroids::GLEntity;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::MeshGeometry;
+using asteroids::MeshId;
+using asteroids::MeshRegistry;
+using asteroids::RenderSnapshot;
+using asteroids::ResourceSchema;
+using asteroids::WorldBounds;
 using boost::property_tree::ptree;
 using database_adapters::IPersistableResource;
 using database_adapters::ResourceLoader;
-using database_adapters::ResourcePersister;
 using database_adapters::Sqlite;
 using filesystem_adapters::EntityDeserializer;
 using filesystem_adapters::ISerializableResource;
 using filesystem_adapters::ResourceDeserializer;
-using filesystem_adapters::ResourceSerializer;
 
 using ResourceGLubyte = ContainerResource<GLubyte>;
 using Resource2DGLfloat = ContainerResource2D<GLfloat>;
 
 namespace
 {
-const double PI = std::numbers::pi;
 const GLfloat BULLET_SPEED_ = 0.5;
 const std::string BULLET_INITIALIZED_KEY = "bullet_initialized";
 const std::string OUT_OF_BOUNDS_KEY = "out_of_bounds";
@@ -47,17 +57,8 @@ const std::string BULLET_VERTICES_KEY = "bullet_vertices";
 const std::string BULLET_INDICES_KEY = "bullet_indices";
 const std::string PROJECTION_MATRIX_KEY = "projection_matrix";
 const std::string TRUE_VAL = "true";
+const GLfloat OUT_OF_BOUNDS_EPSILON = 3.0f;
 
-std::vector<std::vector<GLfloat>> BUFFER({std::vector<GLfloat>(16)});
-
-auto RES_GLUBYTE_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES_GLUBYTE_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
 } // end namespace
 
 std::string Bullet::BulletPrefix()
@@ -65,66 +66,41 @@ std::string Bullet::BulletPrefix()
 	return "Bullet";
 }
 
-Bullet::Bullet() : GLEntity(),
-				   bulletIndices_(
-					   ResourceGLubyte({0, 3, 2, 1, 2, 3, 7, 6, 0, 4, 7, 3, 1, 2, 6, 5, 4, 5, 6, 7, 0, 1, 5, 4})),
-				   projectionMatrix_(
-					   Resource2DGLfloat(
-						   std::vector<std::vector<GLfloat>>(4, std::vector<GLfloat>(4)))),
-
-				   bulletVertices_(
-					   Resource2DGLfloat(
-						   {{-0.2f, -0.1f, 0.5f},
-							{0.2f, -0.0f, 0.5f},
-							{0.2f, 0.0f, 0.5f},
-							{-0.2f, 0.1f, 0.5f},
-							{-0.2f, -0.1f, 1.0f},
-							{0.2f, -0.0f, 1.0f},
-							{0.2f, 0.0f, 1.0f},
-							{-0.2f, 0.1f, 1.0f}}))
-{
-}
-
-void Bullet::RegisterSerializationResources(const std::string_view resourceKey)
+std::string Bullet::BulletKey(const EntityHandle handle)
 {
-	GLEntity::RegisterSerializationResources(resourceKey);
-
-	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
-	if (!deserializer->HasSerializationKey(BULLET_VERTICES_KEY))
-		deserializer->RegisterResource<GLfloat>(BULLET_VERTICES_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(BULLET_INDICES_KEY))
-		deserializer->RegisterResource<GLubyte>(BULLET_INDICES_KEY, RES_GLUBYTE_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(PROJECTION_MATRIX_KEY))
-		deserializer->RegisterResource<GLfloat>(PROJECTION_MATRIX_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
+	return handle.ToKey(BulletPrefix());
 }
 
-void Bullet::RegisterPersistenceResources(const std::string_view resourceKey)
+Bullet::Bullet() : GLEntity(),
+				   projectionMatrix_(
+					   Resource2DGLfloat(
+						   std::vector<std::vector<GLfloat>>(4, std::vector<GLfloat>(4))))
 {
-	GLEntity::RegisterPersistenceResources(resourceKey);
-
-	const std::string key{resourceKey};
-	ResourceLoader * const loader = ResourceLoader::GetInstance();
-	if (!loader->HasPersistenceKey(FormatKey(key + BULLET_VERTICES_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + BULLET_VERTICES_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + BULLET_INDICES_KEY)))
-		loader->RegisterResource<GLubyte>(FormatKey(key + BULLET_INDICES_KEY), RES_GLUBYTE_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + PROJECTION_MATRIX_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + PROJECTION_MATRIX_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
 }
 
 Bullet::Bullet(const GLfloat _x, const GLfloat _y) : Bullet()
 {
 	SetMass(0.5f);
 
-	SetFrame(Resource2DGLfloat({{_x, 0.0f, 0.0f, 0.0f},
-								{_y, 0.0f, 0.0f, 0.0f},
-								{0.0f, 0.0f, 0.0f, 0.0f},
-								{1.0f, 0.0f, 0.0f, 0.0f}}));
+	SetFrame(Mat4::ColumnVector(_x, _y, 0.0f, 1.0f));
+	SetUnitVelocity(Mat4::ColumnVector(1.0f, 0.0f, 0.0f, 1.0f));
+}
 
-	SetUnitVelocity(Resource2DGLfloat({{1.0f, 0.0f, 0.0f, 0.0f},
-									   {0.0f, 0.0f, 0.0f, 0.0f},
-									   {0.0f, 0.0f, 0.0f, 0.0f},
-									   {1.0f, 0.0f, 0.0f, 0.0f}}));
+Bullet::Bullet(const BulletRow &row, const WorldBounds &bounds) : Bullet(row.x, row.y)
+{
+	SetKey(BulletKey(row.handle));
+	SetMass(row.mass);
+	SetSpeed(row.speed);
+	SetVelocityAngle(row.velocityAngle);
+	SetUnitVelocity(0, 0, row.ux);
+	SetUnitVelocity(1, 0, row.uy);
+	SetMotionMatrices();
+
+	bulletInitialized_ = row.initialized;
+	outOfBounds_ = row.outOfBounds;
+
+	projectionMatrix_.GetData(0, 0) = 1 / bounds.right;
+	projectionMatrix_.GetData(1, 1) = 1 / bounds.top;
 }
 
 Bullet::~Bullet() noexcept = default;
@@ -133,92 +109,78 @@ Bullet::Bullet(Bullet &&) noexcept = default;
 Bullet &Bullet::operator=(const Bullet &) = default;
 Bullet &Bullet::operator=(Bullet &&) noexcept = default;
 
-void Bullet::InitializeBullet(const GLfloat _velocityAngle, const GLfloat _speed)
-{
-	SetSpeed(_speed + BULLET_SPEED_);
-	SetVelocityAngle(_velocityAngle);
-	SetUnitVelocity(0, 0, cos(_velocityAngle));
-	SetUnitVelocity(1, 0, sin(_velocityAngle));
-}
-
-void Bullet::SetSMatrix()
-{
-	const GLfloat speed = GetSpeed();
-	S_ = Resource2DGLfloat({{speed, 0.0f, 0.0f, 0.0f},
-							{0.0f, speed, 0.0f, 0.0f},
-							{0.0f, 0.0f, speed, 0.0f},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
-}
-
-void Bullet::SetTMatrix()
+BulletRow Bullet::NewRow(const GLfloat _x, const GLfloat _y)
 {
-	Resource2DGLfloat &frame = GetFrame();
-	T_ = Resource2DGLfloat({{1.0f, 0.0f, 0.0f, frame.GetData(0, 0)},
-							{0.0f, 1.0f, 0.0f, frame.GetData(1, 0)},
-							{0.0f, 0.0f, 1.0f, frame.GetData(2, 0)},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
+	BulletRow bullet;
+	bullet.x = _x;
+	bullet.y = _y;
+	bullet.mass = 0.5f;
+	return bullet;
 }
 
-void Bullet::SetBulletOutOfBounds()
+void Bullet::UpdateBullets(
+	BulletArchetype &bullets,
+	const size_t begin,
+	const size_t end,
+	const GLfloat _velocityAngle,
+	const GLfloat _speed,
+	const WorldBounds &bounds)
 {
-	const GLfloat epsilon = 3.0f;
-
-	const GLfloat right = (1 / fabs(static_cast<GLfloat *>(projectionMatrix_.Data())[0]));
-	const GLfloat left = -1 * right;
-	const GLfloat top = (1 / fabs(static_cast<GLfloat *>(projectionMatrix_.Data())[5]));
-	const GLfloat bottom = -1 * top;
+	const GLfloat right = bounds.right + OUT_OF_BOUNDS_EPSILON;
+	const GLfloat top = bounds.top + OUT_OF_BOUNDS_EPSILON;
 
-	Resource2DGLfloat &frame = GetFrame();
-	if ((frame.GetData(0, 0) <= left - epsilon) || (frame.GetData(0, 0) >= right + epsilon) ||
-		(frame.GetData(1, 0) >= top + epsilon) || (frame.GetData(1, 0) <= bottom - epsilon))
+	for (size_t row = begin; row < end; ++row)
 	{
-		outOfBounds_ = true;
+		if (!bullets.initialized[row])
+		{
+			bullets.speed[row] = _speed + BULLET_SPEED_;
+			bullets.velocityAngle[row] = _velocityAngle;
+			bullets.ux[row] = cos(_velocityAngle);
+			bullets.uy[row] = sin(_velocityAngle);
+			bullets.initialized[row] = true;
+		}
+
+		// Move the bullet ( p = av + frame )
+		const GLfloat x = bullets.x[row] += bullets.speed[row] * bullets.ux[row];
+		const GLfloat y = bullets.y[row] += bullets.speed[row] * bullets.uy[row];
+
+		if ((x <= -right) || (x >= right) || (y >= top) || (y <= -top))
+			bullets.outOfBounds[row] = true;
 	}
 }
 
-void Bullet::Update(const GLfloat _velocityAngle, const GLfloat _speed)
-{
-	if (!bulletInitialized_)
-		InitializeBullet(_velocityAngle, _speed);
-	bulletInitialized_ = true;
-
-	// Move the bullet ( p = av + frame )
-	SetSMatrix();
-	SetTMatrix();
-}
-
-void Bullet::Draw()
+void Bullet::DrawBullets(const RenderSnapshot &snapshot)
 {
-	auto MoveBullet = [this]()
-	{
-		glLoadMatrixf(static_cast<GLfloat *>(GetUnitVelocity().Data()));
-		glMultMatrixf(static_cast<GLfloat *>(S_.Data()));
-		glMultMatrixf(static_cast<GLfloat *>(T_.Data()));
-
-		glGetFloatv(GL_MODELVIEW_MATRIX, static_cast<GLfloat *>(GetFrame().Data()));
-	};
-
-	auto DrawBullet = [this]()
+	const MeshGeometry &mesh = MeshRegistry::Get(MeshId::BULLET);
+	glColor3f(0.0f, 1.0f, 1.0f);
+	glVertexPointer(3, GL_FLOAT, 0, mesh.vertices.data());
+	for (size_t bullet = 0; bullet < snapshot.bulletX.size(); ++bullet)
 	{
-		glVertexPointer(3, GL_FLOAT, 0, bulletVertices_.Data());
-		glColor3f(0.0f, 1.0f, 1.0f);
-		glLoadIdentity();
-		Resource2DGLfloat& frame = GetFrame();
-		glTranslatef(frame.GetData(0, 0), frame.GetData(1, 0), frame.GetData(2, 0));
-		glRotatef(GetVelocityAngle() * (180.0f / PI), 0.0f, 0.0f, 1.0f);
-		glDrawElements(GL_QUADS, 24, GL_UNSIGNED_BYTE, bulletIndices_.Data());
-	};
+		glPushMatrix();
 
-	glGetFloatv(GL_PROJECTION_MATRIX, BUFFER[0].data());
-	projectionMatrix_ = Resource2DGLfloat(BUFFER);
+		glLoadMatrixf(Mat4::Transform(snapshot.bulletX[bullet], snapshot.bulletY[bullet], 0.0f, snapshot.bulletAngle[bullet]).Data());
+		glDrawElements(mesh.mode, MeshGeometry::INDEX_COUNT, GL_UNSIGNED_BYTE, mesh.indices.data());
 
-	glPushMatrix();
-
-	MoveBullet();
-	SetBulletOutOfBounds();
-	DrawBullet();
+		glPopMatrix();
+	}
+}
 
-	glPopMatrix();
+BulletRow Bullet::ToRow()
+{
+	BulletRow bullet;
+	bullet.handle = EntityHandle::FromKey(GetKey(), BulletPrefix()).value_or(EntityHandle{});
+	Mat4Resource &frame = GetFrame();
+	bullet.x = frame.GetData(0, 0);
+	bullet.y = frame.GetData(1, 0);
+	Mat4Resource &unitVel = GetUnitVelocity();
+	bullet.ux = unitVel.GetData(0, 0);
+	bullet.uy = unitVel.GetData(1, 0);
+	bullet.speed = GetSpeed();
+	bullet.velocityAngle = GetVelocityAngle();
+	bullet.mass = GetMass();
+	bullet.initialized = bulletInitialized_;
+	bullet.outOfBounds = outOfBounds_;
+	return bullet;
 }
 
 bool Bullet::IsOutOfBounds() const
@@ -234,11 +196,11 @@ void Bullet::Save(boost::property_tree::ptree &tree, const std::string &path) co
 	if (!fs::exists(path))
 		fs::create_directories(path);
 
-	ResourceSerializer * const serializer = ResourceSerializer::GetInstance();
+	BlobStore * const blobs = BlobStore::GetInstance();
 
-	serializer->Serialize(bulletVertices_.Lock(), BULLET_VERTICES_KEY, path);
-	serializer->Serialize(bulletIndices_.Lock(), BULLET_INDICES_KEY, path);
-	serializer->Serialize(projectionMatrix_.Lock(), PROJECTION_MATRIX_KEY, path);
+	tree.put(BULLET_VERTICES_KEY, blobs->Serialize(MeshRegistry::VerticesResource(MeshId::BULLET)));
+	tree.put(BULLET_INDICES_KEY, blobs->Serialize(MeshRegistry::IndicesResource(MeshId::BULLET)));
+	tree.put(PROJECTION_MATRIX_KEY, blobs->Serialize(projectionMatrix_));
 
 	GLEntity::Save(tree, path);
 }
@@ -250,14 +212,16 @@ void Bullet::Load(boost::property_tree::ptree &tree, const std::string &path)
 	bulletInitialized_ = tree.get_child(BULLET_INITIALIZED_KEY).data() == TRUE_VAL ? true : false;
 	outOfBounds_ = tree.get_child(OUT_OF_BOUNDS_KEY).data() == TRUE_VAL ? true : false;
 
+	if (const boost::optional<std::string> blobKey = tree.get_optional<std::string>(PROJECTION_MATRIX_KEY))
+	{
+		projectionMatrix_ = BlobStore::GetInstance()->Deserialize<GLfloat, Resource2DGLfloat>(*blobKey);
+		return;
+	}
+
 	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
 
-	std::unique_ptr<ISerializableResource> deserializedVertices = deserializer->Deserialize(BULLET_VERTICES_KEY, path);
-	bulletVertices_ = *static_cast<Resource2DGLfloat *>(deserializedVertices.release());
-	std::unique_ptr<ISerializableResource> deserializedIndices = deserializer->Deserialize(BULLET_INDICES_KEY, path);
-	bulletIndices_ = *static_cast<ResourceGLubyte *>(deserializedIndices.release());
 	std::unique_ptr<ISerializableResource> deserializedProjection = deserializer->Deserialize(PROJECTION_MATRIX_KEY, path);
-	projectionMatrix_ = *static_cast<Resource2DGLfloat *>(deserializedProjection.release());
+	projectionMatrix_ = *static_cast<Resource2DGLfloat *>(deserializedProjection.get());
 }
 
 void Bullet::Save(boost::property_tree::ptree &tree, Sqlite &database) const
@@ -265,11 +229,11 @@ void Bullet::Save(boost::property_tree::ptree &tree, Sqlite &database) const
 	tree.put(BULLET_INITIALIZED_KEY, bulletInitialized_);
 	tree.put(OUT_OF_BOUNDS_KEY, outOfBounds_);
 
-	ResourcePersister * const persister = ResourcePersister::GetInstance();
+	BlobStore * const blobs = BlobStore::GetInstance();
 
-	persister->Persist(bulletVertices_, FormatKey(GetKey() + BULLET_VERTICES_KEY));
-	persister->Persist(bulletIndices_, FormatKey(GetKey() + BULLET_INDICES_KEY));
-	persister->Persist(projectionMatrix_, FormatKey(GetKey() + PROJECTION_MATRIX_KEY));
+	tree.put(BULLET_VERTICES_KEY, blobs->Persist(MeshRegistry::VerticesResource(MeshId::BULLET)));
+	tree.put(BULLET_INDICES_KEY, blobs->Persist(MeshRegistry::IndicesResource(MeshId::BULLET)));
+	tree.put(PROJECTION_MATRIX_KEY, blobs->Persist(projectionMatrix_));
 
 	GLEntity::Save(tree, database);
 }
@@ -281,12 +245,15 @@ void Bullet::Load(boost::property_tree::ptree &tree, Sqlite &database)
 	bulletInitialized_ = tree.get_child(BULLET_INITIALIZED_KEY).data() == TRUE_VAL ? true : false;
 	outOfBounds_ = tree.get_child(OUT_OF_BOUNDS_KEY).data() == TRUE_VAL ? true : false;
 
-	ResourceLoader * const loader = ResourceLoader::GetInstance();
+	if (const boost::optional<std::string> blobKey = tree.get_optional<std::string>(PROJECTION_MATRIX_KEY))
+	{
+		projectionMatrix_ = BlobStore::GetInstance()->Load<GLfloat, Resource2DGLfloat>(*blobKey);
+		return;
+	}
+
+	const std::string projectionKey = FormatKey(GetKey() + PROJECTION_MATRIX_KEY);
+	ResourceSchema::RegisterPersisted(projectionKey);
 
-	std::unique_ptr<IPersistableResource> deserializedVertices = loader->Load(FormatKey(GetKey() + BULLET_VERTICES_KEY));
-	bulletVertices_ = *static_cast<Resource2DGLfloat *>(deserializedVertices.release());
-	std::unique_ptr<IPersistableResource> deserializedIndices = loader->Load(FormatKey(GetKey() + BULLET_INDICES_KEY));
-	bulletIndices_ = *static_cast<ResourceGLubyte *>(deserializedIndices.release());
-	std::unique_ptr<IPersistableResource> deserializedProjection = loader->Load(FormatKey(GetKey() + PROJECTION_MATRIX_KEY));
-	projectionMatrix_ = *static_cast<Resource2DGLfloat *>(deserializedProjection.release());
+	std::unique_ptr<IPersistableResource> deserializedProjection = ResourceLoader::GetInstance()->Load(projectionKey);
+	projectionMatrix_ = *static_cast<Resource2DGLfloat *>(deserializedProjection.get());
 }
@@ -0,0 +1,92 @@
+#include "game/CollisionKernel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#if !defined(ASTEROIDS_SCALAR_COLLISION) && __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define ASTEROIDS_SIMD_COLLISION
+#endif
+
+#include "game/EntityStore.h"
+
+using asteroids::CollisionKernel;
+using asteroids::SquaredRadii;
+using asteroids::State;
+
+namespace
+{
+#ifdef ASTEROIDS_SIMD_COLLISION
+namespace stdx = std::experimental;
+using FloatV = stdx::native_simd<GLfloat>;
+#endif
+
+bool Hit(const GLfloat x, const GLfloat y, const GLfloat rockX, const GLfloat rockY, const State state, const SquaredRadii &radii)
+{
+	const GLfloat dx = rockX - x;
+	const GLfloat dy = rockY - y;
+	return dx * dx + dy * dy < radii[static_cast<size_t>(state)];
+}
+} // end namespace
+
+std::uint64_t CollisionKernel::HitMask(
+	const GLfloat x,
+	const GLfloat y,
+	const GLfloat *rockX,
+	const GLfloat *rockY,
+	const State *states,
+	const size_t count,
+	const SquaredRadii &radii)
+{
+	std::uint64_t mask = 0;
+	size_t rock = 0;
+
+#ifdef ASTEROIDS_SIMD_COLLISION
+	const FloatV pointX(x);
+	const FloatV pointY(y);
+	for (; rock + FloatV::size() <= count; rock += FloatV::size())
+	{
+		const FloatV dx = FloatV(rockX + rock, stdx::element_aligned) - pointX;
+		const FloatV dy = FloatV(rockY + rock, stdx::element_aligned) - pointY;
+		const FloatV squaredRadius([&](const auto lane)
+								   { return radii[static_cast<size_t>(states[rock + lane])]; });
+
+		const auto hits = dx * dx + dy * dy < squaredRadius;
+		if (stdx::none_of(hits))
+			continue;
+		for (size_t lane = 0; lane < FloatV::size(); ++lane)
+		{
+			if (hits[lane])
+				mask |= std::uint64_t{1} << (rock + lane);
+		}
+	}
+#endif
+
+	for (; rock < count; ++rock)
+	{
+		if (Hit(x, y, rockX[rock], rockY[rock], states[rock], radii))
+			mask |= std::uint64_t{1} << rock;
+	}
+	return mask;
+}
+
+std::optional<size_t> CollisionKernel::FirstHit(
+	const GLfloat x,
+	const GLfloat y,
+	const GLfloat *rockX,
+	const GLfloat *rockY,
+	const State *states,
+	const size_t count,
+	const SquaredRadii &radii)
+{
+	for (size_t block = 0; block < count; block += BLOCK_SIZE)
+	{
+		const size_t blockCount = std::min(BLOCK_SIZE, count - block);
+		if (const std::uint64_t mask = HitMask(x, y, rockX + block, rockY + block, states + block, blockCount, radii); mask)
+			return block + static_cast<size_t>(std::countr_zero(mask));
+	}
+	return std::nullopt;
+}
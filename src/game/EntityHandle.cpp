@@ -0,0 +1,152 @@
+#include "game/EntityHandle.h"
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+using asteroids::EntityHandle;
+using asteroids::HandleTable;
+
+namespace
+{
+const char GENERATION_SEPARATOR = 'g';
+
+bool ParseNumber(const std::string_view text, std::uint32_t &value)
+{
+	if (text.empty())
+		return false;
+	const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+	return error == std::errc() && end == text.data() + text.size();
+}
+} // end namespace
+
+bool EntityHandle::IsNull() const
+{
+	return slot == NULL_SLOT;
+}
+
+std::string EntityHandle::ToKey(const std::string_view prefix) const
+{
+	std::string key{prefix};
+	key += std::to_string(slot);
+	key += GENERATION_SEPARATOR;
+	key += std::to_string(generation);
+	return key;
+}
+
+std::optional<EntityHandle> EntityHandle::FromKey(const std::string_view key, const std::string_view prefix)
+{
+	if (!key.starts_with(prefix))
+		return std::nullopt;
+
+	const std::string_view handle = key.substr(prefix.size());
+	const size_t separator = handle.find(GENERATION_SEPARATOR);
+	if (separator == std::string_view::npos)
+		return std::nullopt;
+
+	EntityHandle parsed;
+	if (!ParseNumber(handle.substr(0, separator), parsed.slot) ||
+		!ParseNumber(handle.substr(separator + 1), parsed.generation) ||
+		parsed.IsNull())
+		return std::nullopt;
+	return parsed;
+}
+
+EntityHandle HandleTable::Create(const size_t row)
+{
+	std::uint32_t slot;
+	if (!free_.empty())
+	{
+		slot = free_.back();
+		free_.pop_back();
+	}
+	else
+	{
+		slot = static_cast<std::uint32_t>(slots_.size());
+		slots_.emplace_back();
+	}
+
+	Slot &entry = slots_[slot];
+	entry.row = row;
+	entry.live = true;
+	return EntityHandle{slot, entry.generation};
+}
+
+bool HandleTable::Claim(const EntityHandle handle, const size_t row)
+{
+	if (handle.IsNull())
+		return false;
+
+	if (handle.slot >= slots_.size())
+	{
+		// the skipped slots become free for later entities
+		const size_t first = slots_.size();
+		slots_.resize(static_cast<size_t>(handle.slot) + 1);
+		for (size_t slot = first; slot < handle.slot; ++slot)
+			Release(static_cast<std::uint32_t>(slot));
+	}
+	else if (slots_[handle.slot].live)
+	{
+		return false;
+	}
+	else
+	{
+		// the last free slot takes the place of the claimed one, so a restore stays linear
+		const size_t index = slots_[handle.slot].freeIndex;
+		free_[index] = free_.back();
+		slots_[free_[index]].freeIndex = index;
+		free_.pop_back();
+	}
+
+	Slot &entry = slots_[handle.slot];
+	entry.generation = handle.generation;
+	entry.row = row;
+	entry.live = true;
+	return true;
+}
+
+bool HandleTable::Contains(const EntityHandle handle) const
+{
+	return handle.slot < slots_.size() && slots_[handle.slot].live && slots_[handle.slot].generation == handle.generation;
+}
+
+size_t HandleTable::Row(const EntityHandle handle) const
+{
+	return slots_[handle.slot].row;
+}
+
+void HandleTable::Relocate(const EntityHandle handle, const size_t row)
+{
+	slots_[handle.slot].row = row;
+}
+
+void HandleTable::Destroy(const EntityHandle handle)
+{
+	if (!Contains(handle))
+		return;
+
+	Slot &entry = slots_[handle.slot];
+	entry.live = false;
+	++entry.generation;
+	Release(handle.slot);
+}
+
+void HandleTable::Clear()
+{
+	for (size_t slot = 0; slot < slots_.size(); ++slot)
+	{
+		if (!slots_[slot].live)
+			continue;
+		slots_[slot].live = false;
+		++slots_[slot].generation;
+		Release(static_cast<std::uint32_t>(slot));
+	}
+}
+
+void HandleTable::Release(const std::uint32_t slot)
+{
+	slots_[slot].freeIndex = free_.size();
+	free_.push_back(slot);
+}
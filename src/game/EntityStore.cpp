@@ -0,0 +1,256 @@
+#include "game/EntityStore.h"
+
+#include <utility>
+#include <vector>
+
+using asteroids::BulletArchetype;
+using asteroids::BulletRow;
+using asteroids::EntityHandle;
+using asteroids::EntityStore;
+using asteroids::Kinematics;
+using asteroids::RockArchetype;
+using asteroids::RockRow;
+
+namespace
+{
+template <typename T>
+void SwapRemove(std::vector<T> &column, const size_t row)
+{
+	if (row + 1 != column.size())
+		column[row] = std::move(column.back());
+	column.pop_back();
+}
+} // end namespace
+
+void Kinematics::PushKinematics(GLfloat _x, GLfloat _y, GLfloat _ux, GLfloat _uy, GLfloat _speed, GLfloat _velocityAngle, GLfloat _mass)
+{
+	x.push_back(_x);
+	y.push_back(_y);
+	ux.push_back(_ux);
+	uy.push_back(_uy);
+	speed.push_back(_speed);
+	velocityAngle.push_back(_velocityAngle);
+	mass.push_back(_mass);
+}
+
+void Kinematics::SwapRemoveKinematics(const size_t row)
+{
+	SwapRemove(x, row);
+	SwapRemove(y, row);
+	SwapRemove(ux, row);
+	SwapRemove(uy, row);
+	SwapRemove(speed, row);
+	SwapRemove(velocityAngle, row);
+	SwapRemove(mass, row);
+}
+
+void Kinematics::ClearKinematics()
+{
+	x.clear();
+	y.clear();
+	ux.clear();
+	uy.clear();
+	speed.clear();
+	velocityAngle.clear();
+	mass.clear();
+}
+
+void Kinematics::ReserveKinematics(const size_t capacity)
+{
+	x.reserve(capacity);
+	y.reserve(capacity);
+	ux.reserve(capacity);
+	uy.reserve(capacity);
+	speed.reserve(capacity);
+	velocityAngle.reserve(capacity);
+	mass.reserve(capacity);
+}
+
+size_t RockArchetype::Size() const
+{
+	return handles.size();
+}
+
+EntityHandle RockArchetype::Add(const RockRow &rock)
+{
+	const EntityHandle handle = table_.Create(Size());
+	Append(rock, handle);
+	return handle;
+}
+
+bool RockArchetype::Restore(const RockRow &rock)
+{
+	if (!table_.Claim(rock.handle, Size()))
+		return false;
+	Append(rock, rock.handle);
+	return true;
+}
+
+bool RockArchetype::Contains(const EntityHandle handle) const
+{
+	return table_.Contains(handle);
+}
+
+size_t RockArchetype::RowOf(const EntityHandle handle) const
+{
+	return table_.Row(handle);
+}
+
+void RockArchetype::Append(const RockRow &rock, const EntityHandle handle)
+{
+	PushKinematics(rock.x, rock.y, rock.ux, rock.uy, rock.speed, rock.velocityAngle, rock.mass);
+	spin.push_back(rock.spin);
+	spinEpsilon.push_back(rock.spinEpsilon);
+	spinDirection.push_back(rock.spinDirection);
+	state.push_back(rock.state);
+	handles.push_back(handle);
+}
+
+RockRow RockArchetype::Get(const size_t row) const
+{
+	RockRow rock;
+	rock.handle = handles[row];
+	rock.state = state[row];
+	rock.x = x[row];
+	rock.y = y[row];
+	rock.ux = ux[row];
+	rock.uy = uy[row];
+	rock.speed = speed[row];
+	rock.velocityAngle = velocityAngle[row];
+	rock.mass = mass[row];
+	rock.spin = spin[row];
+	rock.spinEpsilon = spinEpsilon[row];
+	rock.spinDirection = spinDirection[row];
+	rock.initialized = true;
+	return rock;
+}
+
+void RockArchetype::Remove(const size_t row)
+{
+	table_.Destroy(handles[row]);
+	if (row + 1 != Size())
+		table_.Relocate(handles.back(), row);
+
+	SwapRemoveKinematics(row);
+	SwapRemove(spin, row);
+	SwapRemove(spinEpsilon, row);
+	SwapRemove(spinDirection, row);
+	SwapRemove(state, row);
+	SwapRemove(handles, row);
+}
+
+void RockArchetype::Clear()
+{
+	table_.Clear();
+	ClearKinematics();
+	spin.clear();
+	spinEpsilon.clear();
+	spinDirection.clear();
+	state.clear();
+	handles.clear();
+}
+
+void RockArchetype::Reserve(const size_t capacity)
+{
+	ReserveKinematics(capacity);
+	spin.reserve(capacity);
+	spinEpsilon.reserve(capacity);
+	spinDirection.reserve(capacity);
+	state.reserve(capacity);
+	handles.reserve(capacity);
+}
+
+size_t BulletArchetype::Size() const
+{
+	return handles.size();
+}
+
+EntityHandle BulletArchetype::Add(const BulletRow &bullet)
+{
+	const EntityHandle handle = table_.Create(Size());
+	Append(bullet, handle);
+	return handle;
+}
+
+bool BulletArchetype::Restore(const BulletRow &bullet)
+{
+	if (!table_.Claim(bullet.handle, Size()))
+		return false;
+	Append(bullet, bullet.handle);
+	return true;
+}
+
+bool BulletArchetype::Contains(const EntityHandle handle) const
+{
+	return table_.Contains(handle);
+}
+
+size_t BulletArchetype::RowOf(const EntityHandle handle) const
+{
+	return table_.Row(handle);
+}
+
+void BulletArchetype::Append(const BulletRow &bullet, const EntityHandle handle)
+{
+	PushKinematics(bullet.x, bullet.y, bullet.ux, bullet.uy, bullet.speed, bullet.velocityAngle, bullet.mass);
+	initialized.push_back(bullet.initialized);
+	outOfBounds.push_back(bullet.outOfBounds);
+	handles.push_back(handle);
+}
+
+BulletRow BulletArchetype::Get(const size_t row) const
+{
+	BulletRow bullet;
+	bullet.handle = handles[row];
+	bullet.x = x[row];
+	bullet.y = y[row];
+	bullet.ux = ux[row];
+	bullet.uy = uy[row];
+	bullet.speed = speed[row];
+	bullet.velocityAngle = velocityAngle[row];
+	bullet.mass = mass[row];
+	bullet.initialized = initialized[row];
+	bullet.outOfBounds = outOfBounds[row];
+	return bullet;
+}
+
+void BulletArchetype::Remove(const size_t row)
+{
+	table_.Destroy(handles[row]);
+	if (row + 1 != Size())
+		table_.Relocate(handles.back(), row);
+
+	SwapRemoveKinematics(row);
+	SwapRemove(initialized, row);
+	SwapRemove(outOfBounds, row);
+	SwapRemove(handles, row);
+}
+
+void BulletArchetype::Clear()
+{
+	table_.Clear();
+	ClearKinematics();
+	initialized.clear();
+	outOfBounds.clear();
+	handles.clear();
+}
+
+RockArchetype &EntityStore::Rocks()
+{
+	return rocks_;
+}
+
+const RockArchetype &EntityStore::Rocks() const
+{
+	return rocks_;
+}
+
+BulletArchetype &EntityStore::Bullets()
+{
+	return bullets_;
+}
+
+const BulletArchetype &EntityStore::Bullets() const
+{
+	return bullets_;
+}
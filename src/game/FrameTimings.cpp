@@ -0,0 +1,146 @@
+#include "game/FrameTimings.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using asteroids::FrameTimings;
+using asteroids::RollingHistogram;
+using asteroids::ScopedTimer;
+using asteroids::StageTiming;
+using asteroids::TimedStage;
+
+namespace
+{
+const double NANOSECONDS_PER_MILLISECOND = 1.0e6;
+
+const std::array<std::string_view, static_cast<size_t>(TimedStage::COUNT)> STAGE_NAMES = {
+	"tick",
+	"update rocks",
+	"update ship",
+	"collisions",
+	"resolve",
+	"save",
+	"write",
+	"load",
+	"snapshot",
+	"draw",
+	"frame"};
+} // end namespace
+
+void RollingHistogram::Record(const std::chrono::nanoseconds duration)
+{
+	const std::uint64_t nanoseconds = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+
+	// the first duration of a slice recycles it; a summary taken meanwhile sees it partly cleared
+	const std::uint64_t sample = samples_.fetch_add(1, std::memory_order_relaxed);
+	Slice &slice = slices_[(sample / SLICE_SAMPLES) % SLICES];
+	if (sample % SLICE_SAMPLES == 0)
+	{
+		for (std::atomic<std::uint32_t> &count : slice.counts)
+			count.store(0, std::memory_order_relaxed);
+		slice.max.store(0, std::memory_order_relaxed);
+	}
+
+	slice.counts[BucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	std::uint64_t max = slice.max.load(std::memory_order_relaxed);
+	while (nanoseconds > max && !slice.max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+StageTiming RollingHistogram::Summarize() const
+{
+	std::array<std::uint64_t, BUCKETS> counts{};
+	StageTiming timing;
+	std::uint64_t max = 0;
+	for (const Slice &slice : slices_)
+	{
+		for (size_t bucket = 0; bucket < BUCKETS; ++bucket)
+			counts[bucket] += slice.counts[bucket].load(std::memory_order_relaxed);
+		max = std::max(max, slice.max.load(std::memory_order_relaxed));
+	}
+	for (const std::uint64_t count : counts)
+		timing.samples += count;
+	if (timing.samples == 0)
+		return timing;
+
+	// a bucket stands for the middle of its durations, which never exceeds the longest one recorded
+	auto Percentile = [&counts, &timing, max](const double fraction)
+	{
+		const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * timing.samples)));
+		std::uint64_t seen = 0;
+		size_t bucket = 0;
+		for (; bucket + 1 < BUCKETS; ++bucket)
+		{
+			seen += counts[bucket];
+			if (seen >= rank)
+				break;
+		}
+		return std::min(ValueOf(bucket), static_cast<double>(max)) / NANOSECONDS_PER_MILLISECOND;
+	};
+
+	timing.p50 = Percentile(0.50);
+	timing.p95 = Percentile(0.95);
+	timing.p99 = Percentile(0.99);
+	timing.max = static_cast<double>(max) / NANOSECONDS_PER_MILLISECOND;
+	return timing;
+}
+
+size_t RollingHistogram::BucketOf(const std::uint64_t nanoseconds)
+{
+	// durations below 2^SUB_BUCKET_BITS get a bucket each; above, each power of two is split evenly
+	const size_t subBuckets = size_t{1} << SUB_BUCKET_BITS;
+	if (nanoseconds < subBuckets)
+		return static_cast<size_t>(nanoseconds);
+
+	const size_t shift = static_cast<size_t>(std::bit_width(nanoseconds)) - SUB_BUCKET_BITS - 1;
+	return (shift << SUB_BUCKET_BITS) + static_cast<size_t>(nanoseconds >> shift);
+}
+
+double RollingHistogram::ValueOf(const size_t bucket)
+{
+	const size_t subBuckets = size_t{1} << SUB_BUCKET_BITS;
+	if (bucket < 2 * subBuckets)
+		return static_cast<double>(bucket);
+
+	const int shift = static_cast<int>(bucket >> SUB_BUCKET_BITS) - 1;
+	const double lowest = static_cast<double>(subBuckets + (bucket & (subBuckets - 1)));
+	return std::ldexp(lowest + 0.5, shift);
+}
+
+FrameTimings *FrameTimings::GetInstance()
+{
+	static FrameTimings instance;
+	return &instance;
+}
+
+void FrameTimings::Record(const TimedStage stage, const std::chrono::nanoseconds duration)
+{
+	histograms_[static_cast<size_t>(stage)].Record(duration);
+}
+
+StageTiming FrameTimings::Summarize(const TimedStage stage) const
+{
+	return histograms_[static_cast<size_t>(stage)].Summarize();
+}
+
+std::string_view FrameTimings::Name(const TimedStage stage)
+{
+	return STAGE_NAMES[static_cast<size_t>(stage)];
+}
+
+ScopedTimer::ScopedTimer(const TimedStage stage) : stage_(stage), start_(std::chrono::steady_clock::now())
+{
+}
+
+ScopedTimer::~ScopedTimer()
+{
+	FrameTimings::GetInstance()->Record(stage_, std::chrono::steady_clock::now() - start_);
+}
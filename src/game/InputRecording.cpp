@@ -0,0 +1,308 @@
+#include "game/InputRecording.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/BlobStore.h"
+#include "game/RenderSnapshot.h"
+#include "game/Simulation.h"
+#include "gl/GLEntity.h"
+
+using asteroids::BlobStore;
+using asteroids::Command;
+using asteroids::InputEvent;
+using asteroids::InputRecorder;
+using asteroids::InputReplay;
+using asteroids::RenderSnapshot;
+using asteroids::WorldBounds;
+
+namespace
+{
+const std::array<unsigned char, 4> MAGIC = {'A', 'S', 'T', 'I'};
+
+// header: magic, version, seed, scenario length and the scenario
+const size_t HEADER_BYTES = 20;
+
+// command records carry the command itself; these codes lie past the last command, and saves and
+// loads, which come last, are never recorded
+const std::uint8_t RESIZE_CODE = 0xFE;
+const std::uint8_t END_CODE = 0xFF;
+const std::uint8_t COMMAND_CODES = static_cast<std::uint8_t>(Command::SERIALIZE);
+
+// a 64-bit number takes at most ten seven-bit groups
+const int MAX_VARINT_BYTES = 10;
+
+/**
+ * @brief Reads little-endian fields from a recording, failing once it runs past the end.
+ */
+class RecordingReader
+{
+public:
+	RecordingReader(const unsigned char *data, const size_t bytes) : data_(data), end_(data + bytes)
+	{
+	}
+
+	bool U8(std::uint8_t &value)
+	{
+		if (data_ == end_)
+			return false;
+		value = *data_++;
+		return true;
+	}
+
+	bool U32(std::uint32_t &value)
+	{
+		value = 0;
+		std::uint8_t byte = 0;
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			if (!U8(byte))
+				return false;
+			value |= static_cast<std::uint32_t>(byte) << shift;
+		}
+		return true;
+	}
+
+	bool U64(std::uint64_t &value)
+	{
+		std::uint32_t low = 0;
+		std::uint32_t high = 0;
+		if (!U32(low) || !U32(high))
+			return false;
+		value = (static_cast<std::uint64_t>(high) << 32) | low;
+		return true;
+	}
+
+	bool F32(GLfloat &value)
+	{
+		std::uint32_t bits = 0;
+		if (!U32(bits))
+			return false;
+		value = std::bit_cast<GLfloat>(bits);
+		return true;
+	}
+
+	bool Text(const size_t length, std::string &value)
+	{
+		if (static_cast<size_t>(end_ - data_) < length)
+			return false;
+		value.assign(reinterpret_cast<const char *>(data_), length);
+		data_ += length;
+		return true;
+	}
+
+	bool Varint(std::uint64_t &value)
+	{
+		value = 0;
+		std::uint8_t byte = 0x80;
+		for (int group = 0; group < MAX_VARINT_BYTES && (byte & 0x80); ++group)
+		{
+			if (!U8(byte))
+				return false;
+			value |= static_cast<std::uint64_t>(byte & 0x7F) << (7 * group);
+		}
+		return !(byte & 0x80);
+	}
+
+	bool AtEnd() const
+	{
+		return data_ == end_;
+	}
+
+private:
+	const unsigned char *data_;
+	const unsigned char *end_;
+};
+
+void WriteU32(std::ofstream &stream, const std::uint32_t value)
+{
+	for (int byte = 0; byte < 4; ++byte)
+		stream.put(static_cast<char>(value >> (8 * byte)));
+}
+
+void WriteU64(std::ofstream &stream, const std::uint64_t value)
+{
+	WriteU32(stream, static_cast<std::uint32_t>(value));
+	WriteU32(stream, static_cast<std::uint32_t>(value >> 32));
+}
+
+void WriteVarint(std::ofstream &stream, std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		stream.put(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	stream.put(static_cast<char>(value));
+}
+
+template <typename T>
+BlobStore::Digest HashColumn(const std::vector<T> &column, const BlobStore::Digest digest)
+{
+	const size_t rows = column.size();
+	return BlobStore::Hash(column.data(), rows * sizeof(T), BlobStore::Hash(&rows, sizeof(rows), digest));
+}
+} // end namespace
+
+InputRecorder::~InputRecorder() noexcept
+{
+	if (stream_.is_open())
+		Close(lastFrame_);
+}
+
+bool InputRecorder::Open(const std::filesystem::path &path, const std::uint64_t seed, const std::string_view scenario)
+{
+	stream_.open(path, std::ios::binary | std::ios::trunc);
+	if (!stream_)
+		return false;
+
+	for (const unsigned char byte : MAGIC)
+		stream_.put(static_cast<char>(byte));
+	WriteU32(stream_, VERSION);
+	WriteU64(stream_, seed);
+	WriteU32(stream_, static_cast<std::uint32_t>(scenario.size()));
+	stream_.write(scenario.data(), static_cast<std::streamsize>(scenario.size()));
+
+	seed_ = seed;
+	lastFrame_ = 0;
+	return static_cast<bool>(stream_);
+}
+
+void InputRecorder::Record(const std::uint64_t frame, const Command command)
+{
+	Begin(frame, static_cast<std::uint8_t>(command));
+}
+
+void InputRecorder::Resize(const std::uint64_t frame, const WorldBounds &bounds)
+{
+	Begin(frame, RESIZE_CODE);
+	WriteU32(stream_, std::bit_cast<std::uint32_t>(bounds.right));
+	WriteU32(stream_, std::bit_cast<std::uint32_t>(bounds.top));
+}
+
+bool InputRecorder::Close(const std::uint64_t frames)
+{
+	if (!stream_.is_open())
+		return false;
+
+	Begin(std::max(frames, lastFrame_), END_CODE);
+	stream_.close();
+	return !stream_.fail();
+}
+
+std::uint64_t InputRecorder::GetSeed() const
+{
+	return seed_;
+}
+
+void InputRecorder::Begin(const std::uint64_t frame, const std::uint8_t code)
+{
+	WriteVarint(stream_, frame - lastFrame_);
+	stream_.put(static_cast<char>(code));
+	lastFrame_ = frame;
+}
+
+bool InputReplay::Open(const std::filesystem::path &path)
+{
+	seed_ = 0;
+	scenario_.clear();
+	frames_ = 0;
+	events_.clear();
+
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+		return false;
+	const std::vector<unsigned char> bytes{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+	if (bytes.size() < HEADER_BYTES || !std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin()))
+		return false;
+
+	RecordingReader reader(bytes.data() + MAGIC.size(), bytes.size() - MAGIC.size());
+	std::uint32_t version = 0;
+	std::uint32_t scenarioLength = 0;
+	if (!reader.U32(version) || version != InputRecorder::VERSION || !reader.U64(seed_) ||
+		!reader.U32(scenarioLength) || !reader.Text(scenarioLength, scenario_))
+		return false;
+
+	std::uint64_t frame = 0;
+	while (true)
+	{
+		std::uint64_t delta = 0;
+		std::uint8_t code = 0;
+		if (!reader.Varint(delta) || !reader.U8(code) || delta > UINT64_MAX - frame)
+			break;
+		frame += delta;
+
+		if (code == END_CODE)
+		{
+			frames_ = frame;
+			return reader.AtEnd();
+		}
+
+		InputEvent event;
+		event.frame = frame;
+		if (code == RESIZE_CODE)
+		{
+			event.resize = true;
+			if (!reader.F32(event.bounds.right) || !reader.F32(event.bounds.top))
+				break;
+		}
+		else if (code < COMMAND_CODES)
+			event.command = static_cast<Command>(code);
+		else
+			break;
+		events_.push_back(event);
+	}
+
+	events_.clear();
+	return false;
+}
+
+std::uint64_t InputReplay::GetSeed() const
+{
+	return seed_;
+}
+
+const std::string &InputReplay::GetScenario() const
+{
+	return scenario_;
+}
+
+std::uint64_t InputReplay::GetFrameCount() const
+{
+	return frames_;
+}
+
+const std::vector<InputEvent> &InputReplay::GetEvents() const
+{
+	return events_;
+}
+
+std::uint64_t InputReplay::Hash(const RenderSnapshot &snapshot)
+{
+	BlobStore::Digest digest = BlobStore::Hash(&snapshot.tick, sizeof(snapshot.tick));
+	digest = BlobStore::Hash(&snapshot.score, sizeof(snapshot.score), digest);
+
+	digest = HashColumn(snapshot.rockX, digest);
+	digest = HashColumn(snapshot.rockY, digest);
+	digest = HashColumn(snapshot.rockSpin, digest);
+	digest = HashColumn(snapshot.rockState, digest);
+	digest = HashColumn(snapshot.bulletX, digest);
+	digest = HashColumn(snapshot.bulletY, digest);
+	digest = HashColumn(snapshot.bulletAngle, digest);
+
+	if (snapshot.hasShip)
+	{
+		const std::array<GLfloat, 4> ship = {snapshot.shipX, snapshot.shipY, snapshot.shipZ, snapshot.shipOrientation};
+		digest = BlobStore::Hash(ship.data(), sizeof(ship), digest);
+	}
+	return digest;
+}
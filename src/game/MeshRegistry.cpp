@@ -0,0 +1,55 @@
+#include "game/MeshRegistry.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "test_filesystem_adapters/ContainerResource.h"
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+using asteroids::MeshGeometry;
+using asteroids::MeshId;
+using asteroids::MeshRegistry;
+
+using ResourceGLubyte = ContainerResource<GLubyte>;
+using Resource2DGLfloat = ContainerResource2D<GLfloat>;
+
+namespace
+{
+Resource2DGLfloat ToVerticesResource(const MeshGeometry &mesh)
+{
+	std::vector<std::vector<GLfloat>> rows(MeshGeometry::VERTEX_COUNT);
+	for (size_t vertex = 0; vertex < MeshGeometry::VERTEX_COUNT; ++vertex)
+		rows[vertex].assign(mesh.vertices.begin() + vertex * 3, mesh.vertices.begin() + vertex * 3 + 3);
+	return Resource2DGLfloat(rows);
+}
+
+ResourceGLubyte ToIndicesResource(const MeshGeometry &mesh)
+{
+	return ResourceGLubyte(std::vector<GLubyte>(mesh.indices.begin(), mesh.indices.end()));
+}
+} // end namespace
+
+const Resource2DGLfloat &MeshRegistry::VerticesResource(const MeshId id)
+{
+	static const std::array<Resource2DGLfloat, MESH_COUNT> resources = []()
+	{
+		std::array<Resource2DGLfloat, MESH_COUNT> built;
+		for (size_t mesh = 0; mesh < MESH_COUNT; ++mesh)
+			built[mesh] = ToVerticesResource(MESHES[mesh]);
+		return built;
+	}();
+	return resources[static_cast<size_t>(id)];
+}
+
+const ResourceGLubyte &MeshRegistry::IndicesResource(const MeshId id)
+{
+	static const std::array<ResourceGLubyte, MESH_COUNT> resources = []()
+	{
+		std::array<ResourceGLubyte, MESH_COUNT> built;
+		for (size_t mesh = 0; mesh < MESH_COUNT; ++mesh)
+			built[mesh] = ToIndicesResource(MESHES[mesh]);
+		return built;
+	}();
+	return resources[static_cast<size_t>(id)];
+}
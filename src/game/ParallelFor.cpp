@@ -0,0 +1,19 @@
+#include "game/ParallelFor.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace
+{
+size_t HardwareThreads()
+{
+	static const size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	return threads;
+}
+} // end namespace
+
+size_t asteroids::ChunkCount(const size_t count, const size_t grain)
+{
+	return std::clamp<size_t>(count / std::max<size_t>(grain, 1), 1, HardwareThreads());
+}
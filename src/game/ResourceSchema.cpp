@@ -0,0 +1,101 @@
+#include "game/ResourceSchema.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "DatabaseAdapters/IPersistableResource.h"
+#include "DatabaseAdapters/ResourceLoader.h"
+#include "FilesystemAdapters/ISerializableResource.h"
+#include "FilesystemAdapters/ResourceDeserializer.h"
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+#include "game/Bullet.h"
+#include "game/Rock.h"
+#include "game/Ship.h"
+
+using asteroids::Bullet;
+using asteroids::EntityKind;
+using asteroids::ResourceSchema;
+using asteroids::Rock;
+using asteroids::Ship;
+using database_adapters::IPersistableResource;
+using database_adapters::ResourceLoader;
+using filesystem_adapters::ISerializableResource;
+using filesystem_adapters::ResourceDeserializer;
+
+using Resource2DGLfloat = ContainerResource2D<GLfloat>;
+
+namespace
+{
+// resources saved per entity; meshes and projection matrices are shared through the blob store
+const std::vector<std::string> NO_RESOURCES = {};
+const std::vector<std::string> ROCK_RESOURCES = {"frame", "unit_velocity", "S", "T", "R"};
+const std::vector<std::string> BULLET_RESOURCES = {"frame", "unit_velocity", "S", "T", "R"};
+const std::vector<std::string> SHIP_RESOURCES = {"frame", "unit_velocity", "S", "T", "R", "unit_orientation"};
+
+// bullets of saves which predate the blob store keep their projection matrix in their own folder
+const std::string LEGACY_PROJECTION_MATRIX_KEY = "projection_matrix";
+
+auto RES2D_GLFLOAT_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
+{ return std::make_unique<Resource2DGLfloat>(); };
+auto RES2D_GLFLOAT_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
+{ return std::make_unique<Resource2DGLfloat>(); };
+} // end namespace
+
+EntityKind ResourceSchema::KindOf(const std::string_view entityKey)
+{
+	static const std::string rockPrefix = Rock::RockPrefix();
+	static const std::string bulletPrefix = Bullet::BulletPrefix();
+	static const std::string shipKey = Ship::ShipKey();
+
+	if (entityKey.starts_with(rockPrefix))
+		return EntityKind::ROCK;
+	if (entityKey.starts_with(bulletPrefix))
+		return EntityKind::BULLET;
+	if (entityKey == shipKey)
+		return EntityKind::SHIP;
+	return EntityKind::NONE;
+}
+
+const std::vector<std::string> &ResourceSchema::Resources(const EntityKind kind)
+{
+	switch (kind)
+	{
+	case EntityKind::SHIP:
+		return SHIP_RESOURCES;
+	case EntityKind::ROCK:
+		return ROCK_RESOURCES;
+	case EntityKind::BULLET:
+		return BULLET_RESOURCES;
+	default:
+		return NO_RESOURCES;
+	}
+}
+
+void ResourceSchema::RegisterSerialization()
+{
+	static std::once_flag registered;
+	std::call_once(registered, []()
+				   {
+		ResourceDeserializer *const deserializer = ResourceDeserializer::GetInstance();
+		auto Register = [deserializer](const std::string &key)
+		{
+			if (!deserializer->HasSerializationKey(key))
+				deserializer->RegisterResource<GLfloat>(key, RES2D_GLFLOAT_CONSTRUCTOR_S);
+		};
+
+		// every class shares the matrix keys of GLEntity, so the ship's list covers the rocks and bullets
+		for (const std::string &key : SHIP_RESOURCES)
+			Register(key);
+		Register(LEGACY_PROJECTION_MATRIX_KEY); });
+}
+
+void ResourceSchema::RegisterPersisted(const std::string &key)
+{
+	ResourceLoader *const loader = ResourceLoader::GetInstance();
+	if (!loader->HasPersistenceKey(key))
+		loader->RegisterResource<GLfloat>(key, RES2D_GLFLOAT_CONSTRUCTOR_T);
+}
@@ -0,0 +1,117 @@
+#include "game/RestoreQueue.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "FilesystemAdapters/ISerializableResource.h"
+#include "FilesystemAdapters/ResourceDeserializer.h"
+
+#include "configuration/serialization.h"
+#include "game/BlobStore.h"
+#include "game/ParallelFor.h"
+#include "game/SaveDatabase.h"
+#include "game/SaveJournal.h"
+#include "gl/GLEntity.h"
+
+using asteroids::BlobStore;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::ParallelFor;
+using asteroids::Resource2DGLfloat;
+using asteroids::RestoreQueue;
+using asteroids::SaveDatabase;
+using asteroids::SaveJournal;
+using asteroids::TaskScheduler;
+using filesystem_adapters::ISerializableResource;
+using filesystem_adapters::ResourceDeserializer;
+
+namespace
+{
+// each decode reads a small file, so a few of them are worth handing to another thread
+const size_t DECODE_GRAIN = 16;
+// a matrix already read from the database only has to be hashed, so many of them make a chunk
+const size_t ASSIGN_GRAIN = 1024;
+} // end namespace
+
+RestoreQueue *RestoreQueue::GetInstance()
+{
+	static RestoreQueue instance;
+	return &instance;
+}
+
+void RestoreQueue::Defer(Mat4Resource &resource, const std::string_view entityKey, const std::string_view resourceKey, const std::string_view path)
+{
+	decodes_.push_back(Decode{&resource, std::string(entityKey), std::string(resourceKey), std::string(path)});
+}
+
+bool RestoreQueue::Finish(TaskScheduler &scheduler)
+{
+	// the decoding threads only fill their own slots; the journal's lock is taken once below
+	std::vector<std::optional<BlobStore::Digest>> digests(decodes_.size());
+	auto DecodeRange = [this, &digests](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			digests[i] = Run(decodes_[i]);
+	};
+
+#ifndef SAVE_TO_DB
+	ParallelFor(scheduler, decodes_.size(), DECODE_GRAIN, DecodeRange);
+#else
+	// the save database's connection serves one caller at a time, so it reads every matrix up front
+	const std::unordered_map<std::string, Mat4> matrices = SaveDatabase::GetInstance()->LoadAll();
+	auto AssignRange = [this, &matrices, &digests](const size_t begin, const size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			const Decode &decode = decodes_[i];
+			const auto matrix = matrices.find(FormatKey(decode.entityKey + decode.resourceKey));
+			if (matrix == matrices.end())
+				continue;
+			decode.resource->Assign(matrix->second);
+			digests[i] = BlobStore::Hash(*decode.resource);
+		}
+	};
+	ParallelFor(scheduler, decodes_.size(), ASSIGN_GRAIN, AssignRange);
+
+	// the matrices missing from the table belong to saves which predate it
+	for (size_t i = 0; i < decodes_.size(); ++i)
+	{
+		if (!digests[i])
+			DecodeRange(i, i + 1);
+	}
+#endif
+
+	const bool complete = std::all_of(digests.begin(), digests.end(), [](const std::optional<BlobStore::Digest> &digest)
+									  { return digest.has_value(); });
+	if (complete)
+	{
+		SaveJournal *journal = SaveJournal::GetInstance();
+		for (size_t i = 0; i < decodes_.size(); ++i)
+			journal->Record(decodes_[i].entityKey, decodes_[i].resourceKey, *digests[i]);
+	}
+
+	decodes_.clear();
+	return complete;
+}
+
+std::optional<BlobStore::Digest> RestoreQueue::Run(const Decode &decode)
+{
+#ifndef SAVE_TO_DB
+	std::unique_ptr<ISerializableResource> deserialized = ResourceDeserializer::GetInstance()->Deserialize(decode.resourceKey, decode.path);
+	if (!deserialized)
+		return std::nullopt;
+	decode.resource->Assign(*static_cast<Resource2DGLfloat *>(deserialized.get()));
+#else
+	if (!SaveDatabase::GetInstance()->Load(FormatKey(decode.entityKey + decode.resourceKey), *decode.resource))
+		return std::nullopt;
+#endif
+
+	return BlobStore::Hash(*decode.resource);
+}
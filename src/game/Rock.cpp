@@ -1,47 +1,50 @@
 #include "game/Rock.h"
 
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <memory>
-#include <numbers>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
 
-#include "DatabaseAdapters/IPersistableResource.h"
-#include "DatabaseAdapters/ResourceLoader.h"
-#include "DatabaseAdapters/ResourcePersister.h"
 #include "DatabaseAdapters/Sqlite.h"
-#include "FilesystemAdapters/ISerializableResource.h"
-#include "FilesystemAdapters/ResourceDeserializer.h"
-#include "FilesystemAdapters/ResourceSerializer.h"
 #include "test_filesystem_adapters/ContainerResource.h"
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/filesystem.hpp"
 #include "configuration/serialization.h"
+#include "game/BlobStore.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/MeshRegistry.h"
 #include "gl/GLEntity.h"
 
+using asteroids::BlobStore;
+using asteroids::CounterRng;
+using asteroids::EntityHandle;
 using asteroids::GLEntity;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::MeshGeometry;
+using asteroids::MeshId;
+using asteroids::MeshRegistry;
+using asteroids::RenderSnapshot;
 using asteroids::Rock;
+using asteroids::RockArchetype;
+using asteroids::RockRow;
 using asteroids::State;
+using asteroids::WorldBounds;
 using boost::property_tree::ptree;
-using database_adapters::IPersistableResource;
-using database_adapters::ResourceLoader;
-using database_adapters::ResourcePersister;
 using database_adapters::Sqlite;
-using filesystem_adapters::ISerializableResource;
-using filesystem_adapters::ResourceDeserializer;
-using filesystem_adapters::ResourceSerializer;
 
 using ResourceGLubyte = ContainerResource<GLubyte>;
 using Resource2DGLfloat = ContainerResource2D<GLfloat>;
 
 namespace
 {
-const double PI = std::numbers::pi;
-const std::string &INDEX_KEY = "index";
 const std::string &SPIN_KEY = "spin";
 const std::string &SPIN_EPSILON_KEY = "spin_epsilon";
 const std::string &SPIN_DIRECTION_KEY = "spin_direction";
@@ -51,42 +54,14 @@ const std::string &ROCK_VERTICES_KEY = "rock_vertices";
 const std::string &ROCK_INDICES_KEY = "rock_indices";
 const std::string TRUE_VAL = "true";
 
-GLfloat PROJECTION_BUFFER[16];
-
-const Resource2DGLfloat rockVerticesL({{-1.5f, -1.5f, 0.5f},
-										{1.5f, -1.5f, 0.5f},
-										{1.5f, 1.5f, 0.5f},
-										{-1.5f, 1.5f, 0.5f},
-										{-1.0f, -1.0f, 1.0f},
-										{1.0f, -1.0f, 1.0f},
-										{1.0f, 1.0f, 1.0f},
-										{-1.0f, 1.0f, 1.0f}});
-const Resource2DGLfloat rockVerticesM({{-1.0f, -1.0f, 0.5f},
-										{1.0f, -1.0f, 0.5f},
-										{1.0f, 1.0f, 0.5f},
-										{-1.0f, 1.0f, 0.5f},
-										{-0.75f, -0.75f, 1.0f},
-										{0.75f, -0.75f, 1.0f},
-										{0.75f, 0.75f, 1.0f},
-										{-0.75f, 0.75f, 1.0f}});
-const Resource2DGLfloat rockVerticesS({{-0.5f, -0.5f, 0.5f},
-										{0.5f, -0.5f, 0.5f},
-										{0.5f, 0.5f, 0.5f},
-										{-0.5f, 0.5f, 0.5f},
-										{-0.25f, -0.25f, 1.0f},
-										{0.25f, -0.25f, 1.0f},
-										{0.25f, 0.25f, 1.0f},
-										{-0.25f, 0.25f, 1.0f}});
-ResourceGLubyte rockIndices({0, 3, 2, 1, 2, 3, 7, 6, 0, 4, 7, 3, 1, 2, 6, 5, 4, 5, 6, 7, 0, 1, 5, 4});
-
-auto RES_GLUBYTE_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES_GLUBYTE_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
+GLfloat WrapEpsilon(const State state)
+{
+	if (state == State::LARGE)
+		return 0.7f;
+	else if (state == State::MEDIUM)
+		return 0.5f;
+	return 0.2f;
+}
 } // end namespace
 
 std::string Rock::RockPrefix()
@@ -94,61 +69,43 @@ std::string Rock::RockPrefix()
 	return "Rock";
 }
 
-Rock::Rock() = default;
-
-void Rock::RegisterSerializationResources(const std::string_view resourceKey)
+std::string Rock::RockKey(const EntityHandle handle)
 {
-	GLEntity::RegisterSerializationResources(resourceKey);
-
-	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
-	if (!deserializer->HasSerializationKey(ROCK_VERTICES_KEY))
-		deserializer->RegisterResource<GLfloat>(ROCK_VERTICES_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(ROCK_INDICES_KEY))
-		deserializer->RegisterResource<GLubyte>(ROCK_INDICES_KEY, RES_GLUBYTE_CONSTRUCTOR_S);
+	return handle.ToKey(RockPrefix());
 }
 
-void Rock::RegisterPersistenceResources(const std::string_view resourceKey)
-{
-	GLEntity::RegisterPersistenceResources(resourceKey);
-
-	const std::string key{resourceKey};
-	ResourceLoader * const persister = ResourceLoader::GetInstance();
-	if (!persister->HasPersistenceKey(FormatKey(key + ROCK_VERTICES_KEY)))
-		persister->RegisterResource<GLfloat>(FormatKey(key + ROCK_VERTICES_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!persister->HasPersistenceKey(FormatKey(key + ROCK_INDICES_KEY)))
-		persister->RegisterResource<GLubyte>(FormatKey(key + ROCK_INDICES_KEY), RES_GLUBYTE_CONSTRUCTOR_T);
-}
+Rock::Rock() = default;
 
 Rock::Rock(
 	const State _state,
 	const GLfloat _x,
-	const GLfloat _y) : GLEntity(Resource2DGLfloat({{_x, 0.0f, 0.0f, 0.0f},
-													{_y, 0.0f, 0.0f, 0.0f},
-													{0.0f, 0.0f, 0.0f, 0.0f},
-													{1.0f, 0.0f, 0.0f, 0.0f}}),
-								 Resource2DGLfloat({{1.0f, 0.0f, 0.0f, 0.0f},
-													{0.0f, 0.0f, 0.0f, 0.0f},
-													{0.0f, 0.0f, 0.0f, 0.0f},
-													{1.0f, 0.0f, 0.0f, 0.0f}})),
-						rockIndices_(
-							ResourceGLubyte({0, 3, 2, 1, 2, 3, 7, 6, 0, 4, 7, 3, 1, 2, 6, 5, 4, 5, 6, 7, 0, 1, 5, 4}))
+	const GLfloat _y) : GLEntity(Mat4::ColumnVector(_x, _y, 0.0f, 1.0f),
+								 Mat4::ColumnVector(1.0f, 0.0f, 0.0f, 1.0f))
 {
 	state_ = _state;
 
-	GLint randy = rand();
-	randy = randy % 2;
-	spinDirection_ = pow(-1, randy);
+	// a rock made outside the store has no handle, so its spin is keyed by where it spawns
+	CounterRng rng(CounterRng::DEFAULT_SEED, std::bit_cast<std::uint32_t>(_x), std::bit_cast<std::uint32_t>(_y));
+	spinDirection_ = rng.Sign();
 
 	SetVelocityAngle(0.0f);
 	SetSpeed(0.02f);
 	SetMass(5.0f);
+}
 
-	if (state_ == State::LARGE)
-		rockVertices_ = rockVerticesL;
-	else if (state_ == State::MEDIUM)
-		rockVertices_ = rockVerticesM;
-	else
-		rockVertices_ = rockVerticesS;
+Rock::Rock(const RockRow &row) : GLEntity(Mat4::ColumnVector(row.x, row.y, 0.0f, 1.0f),
+										  Mat4::ColumnVector(row.ux, row.uy, 0.0f, 1.0f)),
+								 spin_(row.spin),
+								 spinEpsilon_(row.spinEpsilon),
+								 spinDirection_(row.spinDirection),
+								 state_(row.state),
+								 rockInitialized_(row.initialized)
+{
+	SetKey(RockKey(row.handle));
+	SetVelocityAngle(row.velocityAngle);
+	SetSpeed(row.speed);
+	SetMass(row.mass);
+	SetMotionMatrices();
 }
 
 Rock::~Rock() noexcept= default;
@@ -157,115 +114,90 @@ Rock::Rock(Rock &&) noexcept= default;
 Rock &Rock::operator=(const Rock &) = default;
 Rock &Rock::operator=(Rock &&) noexcept = default;
 
-void Rock::InitializeRock(const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin)
+RockRow Rock::NewRow(const State _state, const GLfloat _x, const GLfloat _y, CounterRng &rng)
 {
-	if (rockInitialized_ == true)
+	RockRow rock;
+	rock.state = _state;
+	rock.x = _x;
+	rock.y = _y;
+	rock.spinDirection = rng.Sign();
+	rock.velocityAngle = 0.0f;
+	rock.speed = 0.02f;
+	rock.mass = 5.0f;
+	return rock;
+}
+
+void Rock::Initialize(RockRow &rock, const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin)
+{
+	if (rock.initialized == true)
 		return;
 
-	SetSpeed(GetSpeed() + _speed);
-	SetVelocityAngle(_velocityAngle);
+	rock.speed += _speed;
+	rock.velocityAngle = _velocityAngle;
 	/*==================== COMPUTE ROCK VELOCITY =========================*/
-	Resource2DGLfloat& unitVel = GetUnitVelocity();
-	unitVel.GetData(0, 0) = cos(_velocityAngle);
-	unitVel.GetData(1, 0) = sin(_velocityAngle);
-
-	spinEpsilon_ += _spin;
-	spinEpsilon_ *= spinDirection_;
+	rock.ux = cos(_velocityAngle);
+	rock.uy = sin(_velocityAngle);
 
-	rockInitialized_ = true;
-}
-
-void Rock::UpdateSpin()
-{
-	spin_ += spinEpsilon_;
-	if (spin_ > 360.0f)
-		spin_ -= 360.0f;
-	else if (spin_ < -360.0f)
-		spin_ += 360.0f;
-}
+	rock.spinEpsilon += _spin;
+	rock.spinEpsilon *= rock.spinDirection;
 
-void Rock::MoveRock()
-{
-	/*======================= p = av + frame =============================*/
-	glLoadMatrixf(static_cast<GLfloat *>(GetUnitVelocity().Data()));
-	glMultMatrixf(static_cast<GLfloat *>(S_.Data()));
-	glMultMatrixf(static_cast<GLfloat *>(T_.Data()));
-	glGetFloatv(GL_MODELVIEW_MATRIX, static_cast<GLfloat *>(GetFrame().Data()));
+	rock.initialized = true;
 }
 
-void Rock::WrapAroundMoveRock()
+void Rock::UpdateRocks(RockArchetype &rocks, const size_t begin, const size_t end, const WorldBounds &bounds)
 {
-	glGetFloatv(GL_PROJECTION_MATRIX, PROJECTION_BUFFER);
-
-	const GLfloat right = (1 / fabs(PROJECTION_BUFFER[0]));
-	const GLfloat left = -1 * right;
-	const GLfloat top = (1 / fabs(PROJECTION_BUFFER[5]));
-	const GLfloat bottom = -1 * top;
-
-	Resource2DGLfloat &frame = GetFrame();
-	if (frame.GetData(0, 0) <= left - epsilon_)
-	{
-		SetFrame(0, 0, right + epsilon_);
-		SetFrame(1, 0, frame.GetData(1, 0) * -1);
-	}
-	else if (frame.GetData(0, 0) >= right + epsilon_)
-	{
-		SetFrame(0, 0, left - epsilon_);
-		SetFrame(1, 0, frame.GetData(1, 0) * -1);
-	}
-	else if (frame.GetData(1, 0) >= top + epsilon_)
-	{
-		SetFrame(1, 0, bottom - epsilon_);
-		SetFrame(0, 0, frame.GetData(0, 0) * -1);
-	}
-	else if (frame.GetData(1, 0) <= bottom - epsilon_)
+	for (size_t row = begin; row < end; ++row)
 	{
-		SetFrame(1, 0, top + epsilon_);
-		SetFrame(0, 0, frame.GetData(0, 0) * -1);
+		GLfloat &spin = rocks.spin[row];
+		spin += rocks.spinEpsilon[row];
+		if (spin > 360.0f)
+			spin -= 360.0f;
+		else if (spin < -360.0f)
+			spin += 360.0f;
+
+		/*======================= p = av + frame =============================*/
+		rocks.x[row] += rocks.speed[row] * rocks.ux[row];
+		rocks.y[row] += rocks.speed[row] * rocks.uy[row];
+
+		WrapAround(rocks.x[row], rocks.y[row], bounds, WrapEpsilon(rocks.state[row]));
 	}
 }
 
-void Rock::Draw()
+void Rock::DrawRocks(const RenderSnapshot &snapshot)
 {
-	glPushMatrix();
-
-	MoveRock();
-	WrapAroundMoveRock();
-
-	glVertexPointer(3, GL_FLOAT, 0, rockVertices_.Data());
 	glColor3f(1.0f, 1.0f, 1.0f);
-	glLoadIdentity();
-	Resource2DGLfloat& frame = GetFrame();
-	glTranslatef(frame.GetData(0, 0), frame.GetData(1, 0), frame.GetData(2, 0));
-	glRotatef(spin_ * (180.0f / PI), 0.0f, 0.0f, 1.0f);
-	glDrawElements(GL_LINE_LOOP, 24, GL_UNSIGNED_BYTE, rockIndices_.Data());
+	for (size_t rock = 0; rock < snapshot.rockX.size(); ++rock)
+	{
+		glPushMatrix();
 
-	glPopMatrix();
+		const MeshGeometry &mesh = MeshRegistry::Get(MeshRegistry::RockMesh(snapshot.rockState[rock]));
+		glVertexPointer(3, GL_FLOAT, 0, mesh.vertices.data());
+		glLoadMatrixf(Mat4::Transform(snapshot.rockX[rock], snapshot.rockY[rock], 0.0f, snapshot.rockSpin[rock]).Data());
+		glDrawElements(mesh.mode, MeshGeometry::INDEX_COUNT, GL_UNSIGNED_BYTE, mesh.indices.data());
+
+		glPopMatrix();
+	}
 }
 
-void Rock::Update(const GLfloat _velocityAngle, const GLfloat _speed, const GLfloat _spin)
+RockRow Rock::ToRow()
 {
-	InitializeRock(_velocityAngle, _speed, _spin);
-	UpdateSpin();
-
-	const GLfloat speed = GetSpeed();
-	S_ = Resource2DGLfloat({{speed, 0.0f, 0.0f, 0.0f},
-							{0.0f, speed, 0.0f, 0.0f},
-							{0.0f, 0.0f, speed, 0.0f},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
-
-	Resource2DGLfloat &frame = GetFrame();
-	T_ = Resource2DGLfloat({{1.0f, 0.0f, 0.0f, frame.GetData(0, 0)},
-							{0.0f, 1.0f, 0.0f, frame.GetData(1, 0)},
-							{0.0f, 0.0f, 1.0f, frame.GetData(2, 0)},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
-
-	if (state_ == State::LARGE)
-		epsilon_ = 0.7f;
-	else if (state_ == State::MEDIUM)
-		epsilon_ = 0.5f;
-	else
-		epsilon_ = 0.2f;
+	RockRow rock;
+	rock.handle = EntityHandle::FromKey(GetKey(), RockPrefix()).value_or(EntityHandle{});
+	rock.state = state_;
+	Mat4Resource &frame = GetFrame();
+	rock.x = frame.GetData(0, 0);
+	rock.y = frame.GetData(1, 0);
+	Mat4Resource &unitVel = GetUnitVelocity();
+	rock.ux = unitVel.GetData(0, 0);
+	rock.uy = unitVel.GetData(1, 0);
+	rock.speed = GetSpeed();
+	rock.velocityAngle = GetVelocityAngle();
+	rock.mass = GetMass();
+	rock.spin = spin_;
+	rock.spinEpsilon = spinEpsilon_;
+	rock.spinDirection = spinDirection_;
+	rock.initialized = rockInitialized_;
+	return rock;
 }
 
 GLfloat Rock::GetSpin() const
@@ -314,10 +246,11 @@ void Rock::Save(boost::property_tree::ptree &tree, const std::string &path) cons
 	if (!fs::exists(path))
 		fs::create_directories(path);
 
-	ResourceSerializer * const serializer = ResourceSerializer::GetInstance();
+	BlobStore * const blobs = BlobStore::GetInstance();
 
-	serializer->Serialize(rockVertices_.Lock(), ROCK_VERTICES_KEY, path);
-	serializer->Serialize(rockIndices_.Lock(), ROCK_INDICES_KEY, path);
+	const MeshId mesh = MeshRegistry::RockMesh(state_);
+	tree.put(ROCK_VERTICES_KEY, blobs->Serialize(MeshRegistry::VerticesResource(mesh)));
+	tree.put(ROCK_INDICES_KEY, blobs->Serialize(MeshRegistry::IndicesResource(mesh)));
 
 	GLEntity::Save(tree, path);
 }
@@ -331,13 +264,6 @@ void Rock::Load(boost::property_tree::ptree &tree, const std::string &path)
 	spinDirection_ = std::stoi(tree.get_child(SPIN_DIRECTION_KEY).data());
 	state_ = static_cast<State>(std::stoi(tree.get_child(STATE_KEY).data()));
 	rockInitialized_ = tree.get_child(ROCK_INITIALIZED_KEY).data() == TRUE_VAL ? true : false;
-
-	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
-
-	std::unique_ptr<ISerializableResource> deserializedVertices = deserializer->Deserialize(ROCK_VERTICES_KEY, path);
-	rockVertices_ = *static_cast<Resource2DGLfloat *>(deserializedVertices.get());
-	std::unique_ptr<ISerializableResource> deserializedIndices = deserializer->Deserialize(ROCK_INDICES_KEY, path);
-	rockIndices_ = *static_cast<ResourceGLubyte *>(deserializedIndices.get());
 }
 
 void Rock::Save(boost::property_tree::ptree &tree, Sqlite &database) const
@@ -348,10 +274,11 @@ void Rock::Save(boost::property_tree::ptree &tree, Sqlite &database) const
 	tree.put(STATE_KEY, static_cast<int>(state_));
 	tree.put(ROCK_INITIALIZED_KEY, rockInitialized_);
 
-	ResourcePersister * const persister = ResourcePersister::GetInstance();
+	BlobStore * const blobs = BlobStore::GetInstance();
 
-	persister->Persist(rockVertices_, FormatKey(GetKey() + ROCK_VERTICES_KEY));
-	persister->Persist(rockIndices_, FormatKey(GetKey() + ROCK_INDICES_KEY));
+	const MeshId mesh = MeshRegistry::RockMesh(state_);
+	tree.put(ROCK_VERTICES_KEY, blobs->Persist(MeshRegistry::VerticesResource(mesh)));
+	tree.put(ROCK_INDICES_KEY, blobs->Persist(MeshRegistry::IndicesResource(mesh)));
 
 	GLEntity::Save(tree, database);
 }
@@ -365,11 +292,4 @@ void Rock::Load(boost::property_tree::ptree &tree, Sqlite &database)
 	spinDirection_ = std::stoi(tree.get_child(SPIN_DIRECTION_KEY).data());
 	state_ = static_cast<State>(std::stoi(tree.get_child(STATE_KEY).data()));
 	rockInitialized_ = tree.get_child(ROCK_INITIALIZED_KEY).data() == TRUE_VAL ? true : false;
-
-	ResourceLoader * const loader = ResourceLoader::GetInstance();
-
-	std::unique_ptr<IPersistableResource> loadedVertices = loader->Load(FormatKey(GetKey() + ROCK_VERTICES_KEY));
-	rockVertices_ = *static_cast<Resource2DGLfloat *>(loadedVertices.get());
-	std::unique_ptr<IPersistableResource> loadedIndices = loader->Load(FormatKey(GetKey() + ROCK_INDICES_KEY));
-	rockIndices_ = *static_cast<ResourceGLubyte *>(loadedIndices.get());
 }
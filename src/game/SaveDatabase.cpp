@@ -0,0 +1,232 @@
+#include "game/SaveDatabase.h"
+
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "DatabaseAdapters/IPersistableResource.h"
+#include "DatabaseAdapters/ResourceLoader.h"
+
+#include "game/ResourceSchema.h"
+#include "gl/GLEntity.h"
+#include "gl/Mat4.h"
+#include "gl/Mat4Resource.h"
+
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::Resource2DGLfloat;
+using asteroids::ResourceSchema;
+using asteroids::SaveDatabase;
+using database_adapters::IPersistableResource;
+using database_adapters::ResourceLoader;
+
+namespace
+{
+const char *const CREATE_SQL = "CREATE TABLE IF NOT EXISTS matrices (key TEXT PRIMARY KEY NOT NULL, data BLOB NOT NULL) WITHOUT ROWID";
+const char *const PERSIST_SQL = "INSERT OR REPLACE INTO matrices (key, data) VALUES (?1, ?2)";
+const char *const LOAD_SQL = "SELECT data FROM matrices WHERE key = ?1";
+const char *const UNPERSIST_SQL = "DELETE FROM matrices WHERE key = ?1";
+const char *const ANY_SQL = "SELECT 1 FROM matrices LIMIT 1";
+const char *const LOAD_ALL_SQL = "SELECT key, data FROM matrices";
+
+// a committed save survives a crash of the game; only a power loss may roll back the last one
+const char *const WAL_SQL = "PRAGMA journal_mode = WAL";
+const char *const SYNCHRONOUS_SQL = "PRAGMA synchronous = NORMAL";
+
+const int BUSY_TIMEOUT_MS = 2000;
+const size_t MATRIX_BYTES = sizeof(Mat4::m);
+} // end namespace
+
+SaveDatabase *SaveDatabase::GetInstance()
+{
+	static SaveDatabase instance;
+	return &instance;
+}
+
+SaveDatabase::~SaveDatabase() noexcept
+{
+	Close();
+}
+
+bool SaveDatabase::Open(const std::filesystem::path &path)
+{
+	if (connection_ && path_ == path)
+		return true;
+	Close();
+
+	if (sqlite3_open(path.string().c_str(), &connection_) != SQLITE_OK)
+	{
+		Close();
+		return false;
+	}
+	// the entity persister writes to the same file on its own connection
+	sqlite3_busy_timeout(connection_, BUSY_TIMEOUT_MS);
+
+	const bool prepared =
+		Execute(WAL_SQL) &&
+		Execute(SYNCHRONOUS_SQL) &&
+		Execute(CREATE_SQL) &&
+		sqlite3_prepare_v3(connection_, PERSIST_SQL, -1, SQLITE_PREPARE_PERSISTENT, &persist_, nullptr) == SQLITE_OK &&
+		sqlite3_prepare_v3(connection_, LOAD_SQL, -1, SQLITE_PREPARE_PERSISTENT, &load_, nullptr) == SQLITE_OK &&
+		sqlite3_prepare_v3(connection_, UNPERSIST_SQL, -1, SQLITE_PREPARE_PERSISTENT, &unpersist_, nullptr) == SQLITE_OK &&
+		sqlite3_prepare_v3(connection_, ANY_SQL, -1, SQLITE_PREPARE_PERSISTENT, &any_, nullptr) == SQLITE_OK &&
+		sqlite3_prepare_v3(connection_, LOAD_ALL_SQL, -1, SQLITE_PREPARE_PERSISTENT, &loadAll_, nullptr) == SQLITE_OK;
+	if (!prepared)
+	{
+		Close();
+		return false;
+	}
+
+	path_ = path;
+	return true;
+}
+
+void SaveDatabase::Close()
+{
+	Finalize();
+	if (connection_)
+		sqlite3_close(connection_);
+	connection_ = nullptr;
+	path_.clear();
+}
+
+bool SaveDatabase::IsOpen() const
+{
+	return connection_ != nullptr;
+}
+
+void SaveDatabase::Begin()
+{
+	batch_.clear();
+}
+
+bool SaveDatabase::Commit()
+{
+	bool committed = connection_ && Execute("BEGIN IMMEDIATE");
+	if (committed)
+	{
+		for (const Write &write : batch_)
+		{
+			if (!Apply(write))
+			{
+				committed = false;
+				break;
+			}
+		}
+
+		committed = committed && Execute("COMMIT");
+		if (!committed)
+			Execute("ROLLBACK");
+	}
+
+	batch_.clear();
+	return committed;
+}
+
+void SaveDatabase::Persist(const std::string &key, const Mat4Resource &resource)
+{
+	batch_.push_back(Write{key, resource.Get(), false});
+}
+
+bool SaveDatabase::Load(const std::string &key, Mat4Resource &resource)
+{
+	if (load_)
+	{
+		sqlite3_bind_text(load_, 1, key.data(), static_cast<int>(key.size()), SQLITE_STATIC);
+		const bool found = sqlite3_step(load_) == SQLITE_ROW && sqlite3_column_bytes(load_, 0) == static_cast<int>(MATRIX_BYTES);
+		if (found)
+		{
+			Mat4 matrix;
+			std::memcpy(matrix.m.data(), sqlite3_column_blob(load_, 0), MATRIX_BYTES);
+			resource.Assign(matrix);
+		}
+		sqlite3_reset(load_);
+		sqlite3_clear_bindings(load_);
+		if (found)
+			return true;
+	}
+
+	// every save since the table was added committed its matrices before its hierarchy
+	if (HasMatrices())
+		return false;
+
+	// saves which predate the matrix table persisted each matrix as a resource
+	ResourceSchema::RegisterPersisted(key);
+	std::unique_ptr<IPersistableResource> loaded = ResourceLoader::GetInstance()->Load(key);
+	if (!loaded)
+		return false;
+	resource.Assign(*static_cast<Resource2DGLfloat *>(loaded.get()));
+	return true;
+}
+
+std::unordered_map<std::string, Mat4> SaveDatabase::LoadAll()
+{
+	std::unordered_map<std::string, Mat4> matrices;
+	if (!loadAll_)
+		return matrices;
+
+	while (sqlite3_step(loadAll_) == SQLITE_ROW)
+	{
+		if (sqlite3_column_bytes(loadAll_, 1) != static_cast<int>(MATRIX_BYTES))
+			continue;
+
+		const char *const key = reinterpret_cast<const char *>(sqlite3_column_text(loadAll_, 0));
+		Mat4 &matrix = matrices[std::string(key, static_cast<size_t>(sqlite3_column_bytes(loadAll_, 0)))];
+		std::memcpy(matrix.m.data(), sqlite3_column_blob(loadAll_, 1), MATRIX_BYTES);
+	}
+	sqlite3_reset(loadAll_);
+	return matrices;
+}
+
+void SaveDatabase::Unpersist(const std::string &key)
+{
+	batch_.push_back(Write{key, Mat4{}, true});
+}
+
+bool SaveDatabase::Apply(const Write &write)
+{
+	sqlite3_stmt *const statement = write.erase ? unpersist_ : persist_;
+
+	sqlite3_bind_text(statement, 1, write.key.data(), static_cast<int>(write.key.size()), SQLITE_STATIC);
+	if (!write.erase)
+		sqlite3_bind_blob(statement, 2, write.matrix.Data(), static_cast<int>(MATRIX_BYTES), SQLITE_STATIC);
+	const bool applied = sqlite3_step(statement) == SQLITE_DONE;
+	sqlite3_reset(statement);
+	sqlite3_clear_bindings(statement);
+
+	return applied;
+}
+
+bool SaveDatabase::HasMatrices()
+{
+	if (!any_)
+		return false;
+
+	const bool any = sqlite3_step(any_) == SQLITE_ROW;
+	sqlite3_reset(any_);
+	return any;
+}
+
+bool SaveDatabase::Execute(const char *sql)
+{
+	return sqlite3_exec(connection_, sql, nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+void SaveDatabase::Finalize()
+{
+	sqlite3_finalize(persist_);
+	sqlite3_finalize(load_);
+	sqlite3_finalize(unpersist_);
+	sqlite3_finalize(any_);
+	sqlite3_finalize(loadAll_);
+	persist_ = nullptr;
+	load_ = nullptr;
+	unpersist_ = nullptr;
+	any_ = nullptr;
+	loadAll_ = nullptr;
+}
@@ -0,0 +1,79 @@
+#include "game/SaveJournal.h"
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "game/BlobStore.h"
+
+using asteroids::BlobStore;
+using asteroids::SaveJournal;
+
+SaveJournal *SaveJournal::GetInstance()
+{
+	static SaveJournal instance;
+	return &instance;
+}
+
+bool SaveJournal::Changed(const std::string_view entityKey, const std::string_view resourceKey, const BlobStore::Digest digest)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto entity = entities_.find(entityKey);
+	if (entity == entities_.end())
+		entity = entities_.emplace(std::string(entityKey), Digests{}).first;
+
+	Digests &digests = entity->second;
+	auto resource = digests.find(resourceKey);
+	if (resource == digests.end())
+	{
+		digests.emplace(std::string(resourceKey), digest);
+		return true;
+	}
+	if (resource->second == digest)
+		return false;
+
+	resource->second = digest;
+	return true;
+}
+
+void SaveJournal::Record(const std::string_view entityKey, const std::string_view resourceKey, const BlobStore::Digest digest)
+{
+	Changed(entityKey, resourceKey, digest);
+}
+
+void SaveJournal::Forget(const std::string_view entityKey)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (auto entity = entities_.find(entityKey); entity != entities_.end())
+		entities_.erase(entity);
+	if (saving_ > 0)
+		forgotten_.emplace(entityKey);
+}
+
+void SaveJournal::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entities_.clear();
+}
+
+void SaveJournal::BeginSave()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	++saving_;
+}
+
+void SaveJournal::EndSave()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (--saving_ > 0)
+		return;
+
+	for (const std::string &entityKey : forgotten_)
+	{
+		if (auto entity = entities_.find(entityKey); entity != entities_.end())
+			entities_.erase(entity);
+	}
+	forgotten_.clear();
+}
@@ -0,0 +1,75 @@
+#include "game/SaveWriter.h"
+
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+using asteroids::SaveWriter;
+
+SaveWriter::SaveWriter() : thread_(&SaveWriter::Loop, this)
+{
+}
+
+SaveWriter::~SaveWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	ready_.notify_one();
+	thread_.join();
+}
+
+bool SaveWriter::TrySubmit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (job_)
+			return false;
+		job_ = std::move(job);
+	}
+	ready_.notify_one();
+	return true;
+}
+
+bool SaveWriter::Busy()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return static_cast<bool>(job_);
+}
+
+void SaveWriter::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	idle_.wait(lock, [this]()
+			   { return !job_; });
+}
+
+std::optional<bool> SaveWriter::TakeResult()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return std::exchange(result_, std::nullopt);
+}
+
+void SaveWriter::Loop()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (true)
+	{
+		ready_.wait(lock, [this]()
+					{ return stopping_ || job_; });
+		// an accepted save still completes when the writer stops
+		if (!job_)
+			return;
+
+		// the job stays set while it runs, so it reads as busy until it has finished
+		lock.unlock();
+		const bool written = job_();
+		lock.lock();
+
+		job_ = nullptr;
+		result_ = written;
+		idle_.notify_all();
+	}
+}
@@ -0,0 +1,149 @@
+#include "game/Scenario.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "configuration/config.h"
+#include "game/CounterRng.h"
+#include "game/EntityStore.h"
+#include "game/Rock.h"
+#include "gl/GLEntity.h"
+
+using asteroids::CounterRng;
+using asteroids::Rock;
+using asteroids::RockRow;
+using asteroids::Scenario;
+using asteroids::State;
+using asteroids::WorldBounds;
+
+namespace
+{
+const char SETTING_SEPARATOR = ',';
+const char VALUE_SEPARATOR = '=';
+const char RANGE_SEPARATOR = ':';
+const char WAVE_SEPARATOR = '/';
+
+const GLfloat TWO_PI = 2.0f * std::numbers::pi_v<GLfloat>;
+
+/**
+ * @brief Parse a whole number, or a finite real number.
+ */
+template <typename T>
+bool ParseNumber(const std::string_view text, T &value)
+{
+	const char *const end = text.data() + text.size();
+	const auto [last, error] = std::from_chars(text.data(), end, value);
+	if (error != std::errc() || last != end)
+		return false;
+	if constexpr (std::is_floating_point_v<T>)
+		return std::isfinite(value);
+	return true;
+}
+
+/**
+ * @brief Parse two numbers around a separator.
+ */
+template <typename T, typename U>
+bool ParsePair(const std::string_view text, const char separator, T &first, U &second)
+{
+	const size_t split = text.find(separator);
+	return split != std::string_view::npos &&
+		   ParseNumber(text.substr(0, split), first) &&
+		   ParseNumber(text.substr(split + 1), second);
+}
+
+/**
+ * @brief Parse a range of non-negative numbers.
+ */
+bool ParseRange(const std::string_view text, GLfloat &low, GLfloat &high)
+{
+	return ParsePair(text, RANGE_SEPARATOR, low, high) && low >= 0.0f && low <= high;
+}
+
+bool ParseSizes(const std::string_view text, std::array<GLfloat, 3> &weights)
+{
+	const size_t split = text.find(RANGE_SEPARATOR);
+	if (split == std::string_view::npos || !ParseNumber(text.substr(0, split), weights[0]) ||
+		!ParsePair(text.substr(split + 1), RANGE_SEPARATOR, weights[1], weights[2]))
+		return false;
+
+	const bool positive = std::all_of(weights.begin(), weights.end(), [](const GLfloat weight)
+									  { return weight >= 0.0f; });
+	return positive && weights[0] + weights[1] + weights[2] > 0.0f;
+}
+
+bool ParseSetting(const std::string_view key, const std::string_view value, Scenario &scenario)
+{
+	if (key == "rocks")
+		return ParseNumber(value, scenario.rocks) && scenario.rocks > 0;
+	if (key == "sizes")
+		return ParseSizes(value, scenario.sizeWeights);
+	if (key == "speed")
+		return ParseRange(value, scenario.minSpeed, scenario.maxSpeed);
+	if (key == "spin")
+		return ParseRange(value, scenario.minSpin, scenario.maxSpin);
+	if (key == "radius")
+		return ParseNumber(value, scenario.radius) && scenario.radius >= 0.0f;
+	if (key == "clearance")
+		return ParseNumber(value, scenario.clearance) && scenario.clearance >= 0.0f;
+	if (key == "wave")
+		return ParsePair(value, WAVE_SEPARATOR, scenario.waveRocks, scenario.waveSeconds) && scenario.waveSeconds > 0.0f;
+	if (key == "fire")
+		return ParseNumber(value, scenario.fireRate) && scenario.fireRate >= 0.0f;
+	if (key == "bullets")
+		return ParseNumber(value, scenario.maxBullets);
+	return false;
+}
+} // end namespace
+
+std::optional<Scenario> Scenario::Parse(std::string_view spec)
+{
+	Scenario scenario;
+	while (!spec.empty())
+	{
+		const size_t end = std::min(spec.find(SETTING_SEPARATOR), spec.size());
+		const std::string_view setting = spec.substr(0, end);
+		spec.remove_prefix(std::min(end + 1, spec.size()));
+
+		const size_t split = setting.find(VALUE_SEPARATOR);
+		if (split == std::string_view::npos || !ParseSetting(setting.substr(0, split), setting.substr(split + 1), scenario))
+			return std::nullopt;
+	}
+	return scenario;
+}
+
+RockRow Scenario::MakeRock(CounterRng &rng, const WorldBounds &bounds) const
+{
+	auto Draw = [&rng](const GLfloat low, const GLfloat high)
+	{ return low + static_cast<GLfloat>(rng.Unit()) * (high - low); };
+
+	// rocks spawn in a square around the ship, outside a cross along its axes; the cross is
+	// dropped where it would leave no room
+	auto Coordinate = [this, &rng, &Draw](const GLfloat extent)
+	{
+		const GLfloat span = radius > 0.0f ? std::min(radius, extent) : extent;
+		const GLfloat low = clearance < span ? clearance : 0.0f;
+		return static_cast<GLfloat>(rng.Sign()) * Draw(low, span);
+	};
+
+	const GLfloat size = Draw(0.0f, sizeWeights[0] + sizeWeights[1] + sizeWeights[2]);
+	State state = State::SMALL;
+	if (size < sizeWeights[0])
+		state = State::LARGE;
+	else if (size < sizeWeights[0] + sizeWeights[1])
+		state = State::MEDIUM;
+
+	const GLfloat x = Coordinate(bounds.right);
+	const GLfloat y = Coordinate(bounds.top);
+	RockRow rock = Rock::NewRow(state, x, y, rng);
+	Rock::Initialize(rock, Draw(0.0f, TWO_PI), Draw(minSpeed, maxSpeed), Draw(minSpin, maxSpin));
+	return rock;
+}
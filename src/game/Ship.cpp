@@ -1,7 +1,6 @@
 #include "game/Ship.h"
 
 #include <cmath>
-#include <future>
 #include <map>
 #include <memory>
 #include <numbers>
@@ -9,43 +8,46 @@
 #include <string_view>
 #include <vector>
 
-#include <boost/asio/post.hpp>
-#include <boost/lexical_cast.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_generators.hpp>
-#include <boost/uuid/uuid_io.hpp>
-
-#include "DatabaseAdapters/EntityLoader.h"
-#include "DatabaseAdapters/IPersistableResource.h"
-#include "DatabaseAdapters/ResourceLoader.h"
-#include "DatabaseAdapters/ResourcePersister.h"
+
 #include "DatabaseAdapters/Sqlite.h"
-#include "FilesystemAdapters/EntityDeserializer.h"
-#include "FilesystemAdapters/ISerializableResource.h"
-#include "FilesystemAdapters/ResourceDeserializer.h"
 #include "FilesystemAdapters/ResourceSerializer.h"
 #include "test_filesystem_adapters/ContainerResource.h"
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/filesystem.hpp"
 #include "configuration/serialization.h"
+#include "game/BlobStore.h"
 #include "game/Bullet.h"
-#include "gl/GLEntityTask.h"
-
+#include "game/EntityStore.h"
+#include "game/MeshRegistry.h"
+#include "game/RestoreQueue.h"
+#include "game/SaveDatabase.h"
+#include "game/SaveJournal.h"
+#include "game/ParallelFor.h"
+#include "game/TaskScheduler.h"
+
+using asteroids::BlobStore;
 using asteroids::Bullet;
+using asteroids::BulletArchetype;
+using asteroids::EntityHandle;
 using asteroids::GLEntity;
-using asteroids::GLEntityTask;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::MeshGeometry;
+using asteroids::MeshId;
+using asteroids::MeshRegistry;
+using asteroids::ParallelFor;
+using asteroids::RenderSnapshot;
+using asteroids::RestoreQueue;
+using asteroids::SaveDatabase;
+using asteroids::SaveJournal;
 using asteroids::Ship;
+using asteroids::ShipRow;
+using asteroids::TaskScheduler;
+using asteroids::WorldBounds;
 using boost::property_tree::ptree;
-using database_adapters::EntityLoader;
-using database_adapters::IPersistableResource;
-using database_adapters::ResourceLoader;
-using database_adapters::ResourcePersister;
 using database_adapters::Sqlite;
-using filesystem_adapters::EntityDeserializer;
-using filesystem_adapters::ISerializableResource;
-using filesystem_adapters::ResourceDeserializer;
 using filesystem_adapters::ResourceSerializer;
 
 using ResourceGLubyte = ContainerResource<GLubyte>;
@@ -61,20 +63,9 @@ const std::string ORIENTATION_ANGLE_KEY = "orientation_angle";
 const std::string BULLET_FIRED_KEY = "bullet_fired";
 const std::string TRUE_VAL = "true";
 
-GLfloat PROJECTION_BUFFER[16];
-const GLint BULLET_COUNT = 5;
+const size_t BULLET_UPDATE_GRAIN = 2048;
 
-EntityDeserializer *const Deserializer = EntityDeserializer::GetInstance();
-EntityLoader *const Loader = EntityLoader::GetInstance();
 
-auto RES_GLUBYTE_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES_GLUBYTE_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<ResourceGLubyte>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
 } // end namespace
 
 std::string Ship::ShipKey()
@@ -82,66 +73,30 @@ std::string Ship::ShipKey()
 	return "Ship";
 }
 
-Ship::Ship() : GLEntity(Resource2DGLfloat({{0.0f, 0.0f, 0.0f, 0.0f},
-										   {0.0f, 0.0f, 0.0f, 0.0f},
-										   {0.0f, 0.0f, 0.0f, 0.0f},
-										   {0.0f, 0.0f, 0.0f, 0.0f}}),
-						Resource2DGLfloat({{0.0f, 0.0f, 0.0f, 0.0f},
-										   {1.0f, 0.0f, 0.0f, 0.0f},
-										   {0.0f, 0.0f, 0.0f, 0.0f},
-										   {1.0f, 0.0f, 0.0f, 0.0f}})),
-			   shipVertices_(Resource2DGLfloat({{-0.5f, -0.5f, 0.5f},
-												{0.5f, -0.0f, 0.5f},
-												{0.5f, 0.0f, 0.5f},
-												{-0.5f, 0.5f, 0.5f},
-												{-0.5f, -0.5f, 1.0f},
-												{0.1f, -0.0f, 1.0f},
-												{0.1f, 0.0f, 1.0f},
-												{-0.5f, 0.5f, 1.0f}})),
-			   shipIndices_(ResourceGLubyte({0, 3, 2, 1, 2, 3, 7, 6, 0, 4, 7, 3, 1, 2, 6, 5, 4, 5, 6, 7, 0, 1, 5, 4})),
-			   unitOrientation_(Resource2DGLfloat({{0.0f, 0.0f, 0.0f, 0.0f},
-												   {1.0f, 0.0f, 0.0f, 0.0f},
-												   {0.0f, 0.0f, 0.0f, 0.0f},
-												   {1.0f, 0.0f, 0.0f, 0.0f}}))
+Ship::Ship() : GLEntity(Mat4::ColumnVector(0.0f, 0.0f, 0.0f, 0.0f),
+						Mat4::ColumnVector(0.0f, 1.0f, 0.0f, 1.0f)),
+			   unitOrientation_(Mat4::ColumnVector(0.0f, 1.0f, 0.0f, 1.0f))
 {
 	SetVelocityAngle(PI / 2);
 }
 
-void Ship::RegisterSerializationResources(const std::string_view resourceKey)
-{
-	GLEntity::RegisterSerializationResources(resourceKey);
-
-	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
-	if (!deserializer->HasSerializationKey(SHIP_VERTICES_KEY))
-		deserializer->RegisterResource<GLfloat>(SHIP_VERTICES_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(SHIP_INDICES_KEY))
-		deserializer->RegisterResource<GLubyte>(SHIP_INDICES_KEY, RES_GLUBYTE_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(UNIT_ORIENTATION_KEY))
-		deserializer->RegisterResource<GLfloat>(UNIT_ORIENTATION_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-}
-
-void Ship::RegisterPersistenceResources(const std::string_view resourceKey)
+Ship::Ship(const std::string_view key) : Ship()
 {
-	GLEntity::RegisterPersistenceResources(resourceKey);
-
-	const std::string key{resourceKey};
-	ResourceLoader * const loader = ResourceLoader::GetInstance();
-	if (!loader->HasPersistenceKey(FormatKey(key + SHIP_VERTICES_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + SHIP_VERTICES_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + SHIP_INDICES_KEY)))
-		loader->RegisterResource<GLubyte>(FormatKey(key + SHIP_INDICES_KEY), RES_GLUBYTE_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + UNIT_ORIENTATION_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + UNIT_ORIENTATION_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
+	SetKey(std::string(key));
 }
 
-Ship::Ship(const std::string_view key) : Ship()
+Ship::Ship(const ShipRow &row) : GLEntity(row.frame, row.unitVelocity),
+							   bulletFired_(row.bulletFired),
+							   orientationAngle_(row.orientationAngle),
+							   unitOrientation_(row.unitOrientation)
 {
-	SetKey(std::string(key));
-#ifndef SAVE_TO_DB
-	Ship::RegisterSerializationResources(GetKey());
-#else
-	Ship::RegisterPersistenceResources(GetKey());
-#endif
+	SetKey(ShipKey());
+	SetVelocityAngle(row.velocityAngle);
+	SetSpeed(row.speed);
+	SetMass(row.mass);
+	S_.Set(row.S);
+	T_.Set(row.T);
+	R_.Set(row.R);
 }
 
 Ship::~Ship() noexcept = default;
@@ -150,12 +105,6 @@ Ship::Ship(Ship &&) noexcept = default;
 Ship &Ship::operator=(const Ship &) = default;
 Ship &Ship::operator=(Ship &&) noexcept = default;
 
-std::string Ship::GenerateUUID() const
-{
-	const boost::uuids::uuid tag = boost::uuids::random_generator()();
-	return boost::lexical_cast<std::string>(tag);
-}
-
 Ship::SharedEntity &Ship::GetBullet(const std::string_view key) const
 {
 	return ISerializableEntity::GetAggregatedMember(std::string(key));
@@ -166,16 +115,6 @@ std::vector<Ship::Key> Ship::GetBulletKeys() const
 	return GetAggregatedMemberKeys();
 }
 
-const std::set<Ship::Key, std::less<>> &Ship::GetOutOfScopeBulletKeys() const
-{
-	return outOfScopeBulletKeys_;
-}
-
-void Ship::ClearOutOfScopeBulletKeys()
-{
-	outOfScopeBulletKeys_.clear();
-}
-
 void Ship::RecomputeShipVelocity(const GLfloat _thrust)
 {
 	/*====================== RECOMPUTE SHIP VELOCITY =========================*/
@@ -184,7 +123,7 @@ void Ship::RecomputeShipVelocity(const GLfloat _thrust)
 	if (fabs(_thrust - 0.0f) <= 0.00001f)
 		return;
 
-	Resource2DGLfloat& unitVel = GetUnitVelocity();
+	Mat4Resource& unitVel = GetUnitVelocity();
 	const GLfloat mass = GetMass();
 	GLfloat speed = GetSpeed();
 	GLfloat velAngle = GetVelocityAngle();
@@ -217,9 +156,7 @@ void Ship::RecomputeShipVelocity(const GLfloat _thrust)
 
 void Ship::ChangeShipOrientation()
 {
-	glLoadMatrixf(static_cast<GLfloat *>(unitOrientation_.Data()));
-	glMultMatrixf(static_cast<GLfloat *>(R_.Data()));
-	glGetFloatv(GL_MODELVIEW_MATRIX, static_cast<GLfloat *>(unitOrientation_.Data()));
+	unitOrientation_.Set(R_.Get() * unitOrientation_.Get());
 
 	orientationAngle_ = static_cast<GLfloat>(atan(unitOrientation_.GetData(1, 0) /
 									   unitOrientation_.GetData(0, 0)));
@@ -231,197 +168,128 @@ void Ship::ChangeShipOrientation()
 
 void Ship::MoveShip()
 {
-	/*======================= p = av + frame =============================*/
-	glLoadMatrixf(static_cast<GLfloat *>(GetUnitVelocity().Data()));
-	glMultMatrixf(static_cast<GLfloat *>(S_.Data()));
-	glMultMatrixf(static_cast<GLfloat *>(T_.Data()));
-	glGetFloatv(GL_MODELVIEW_MATRIX, static_cast<GLfloat *>(GetFrame().Data()));
+	Move();
 }
 
-void Ship::WrapAroundMoveShip()
+void Ship::WrapAroundMoveShip(const WorldBounds &bounds)
 {
-	glGetFloatv(GL_PROJECTION_MATRIX, PROJECTION_BUFFER);
-
 	const GLfloat epsilon = 0.5f;
-
-	const GLfloat right = (1 / fabs(PROJECTION_BUFFER[0]));
-	const GLfloat left = -1 * right;
-	const GLfloat top = (1 / fabs(PROJECTION_BUFFER[5]));
-	const GLfloat bottom = -1 * top;
-
-	Resource2DGLfloat& frame = GetFrame();
-	if (frame.GetData(0, 0) <= left - epsilon)
-	{
-		SetFrame(0, 0, right + epsilon);
-		SetFrame(1, 0, frame.GetData(1, 0) * -1);
-	}
-	else if (frame.GetData(0, 0) >= right + epsilon)
-	{
-		SetFrame(0, 0, left - epsilon);
-		SetFrame(1, 0, frame.GetData(1, 0) * -1);
-	}
-	else if (frame.GetData(1, 0) >= top + epsilon)
-	{
-		SetFrame(1, 0, bottom - epsilon);
-		SetFrame(0, 0, frame.GetData(0, 0) * -1);
-	}
-	else if (frame.GetData(1, 0) <= bottom - epsilon)
-	{
-		SetFrame(1, 0, top + epsilon);
-		SetFrame(0, 0, frame.GetData(0, 0) * -1);
-	}
+	WrapAround(bounds, epsilon);
 }
 
-void Ship::UpdateBulletTask(std::shared_ptr<Bullet> bullet)
-{
-	bullet->Update(orientationAngle_, GetSpeed());
-}
-
-void Ship::UpdateBullets(
-	const std::set<std::string, std::less<>> &serializedKeys,
-	boost::asio::thread_pool &threadPool,
-	std::vector<std::future<std::shared_ptr<GLEntity>>> &futures)
+void Ship::UpdateBullets(BulletArchetype &bullets, const WorldBounds &bounds, TaskScheduler &scheduler)
 {
 	if (bulletFired_ == false)
 		return;
 
-	bulletFired_ = false;
-
-	std::map<Key, SharedEntity> &bullets = GetAggregatedMembers();
+	bulletFired_ = bullets.Size() > 0;
 
-	std::vector<std::string> bulletsToRemove;
-	for (auto iter = bullets.begin(); iter != bullets.end(); ++iter)
-	{
-		auto& [entityKey, sharedEntity] = *iter;
-		auto const bullet = dynamic_pointer_cast<Bullet>(sharedEntity);
-		if (bullet && bullet->IsOutOfBounds())
-		{
-			bulletsToRemove.push_back(bullet->GetKey());
-		}
-		else if (bullet)
-		{
-			GLEntityTask task([this, bullet]()
-							  { UpdateBulletTask(bullet); return bullet; });
-			futures.push_back(task.GetFuture());
-			boost::asio::post(threadPool, task);
-
-			bulletFired_ = true;
-		}
-	}
-
-	for (const std::string &bulletKey : bulletsToRemove)
-		RemoveBullet(bulletKey, serializedKeys);
+	const GLfloat speed = GetSpeed();
+	ParallelFor(scheduler, bullets.Size(), BULLET_UPDATE_GRAIN, [this, &bullets, &bounds, speed](const size_t begin, const size_t end)
+				{ Bullet::UpdateBullets(bullets, begin, end, orientationAngle_, speed, bounds); });
 }
 
 void Ship::Draw()
 {
 	glPushMatrix();
 
-	if (doRotate_)
-		ChangeShipOrientation();
-	doRotate_ = false;
+	const MeshGeometry &mesh = MeshRegistry::Get(MeshId::SHIP);
+	glVertexPointer(3, GL_FLOAT, 0, mesh.vertices.data());
+	glColor3f(0.0f, 1.0f, 0.0f);
+	Mat4Resource& frame = GetFrame();
+	glLoadMatrixf(Mat4::Transform(frame.GetData(0, 0), frame.GetData(1, 0), frame.GetData(2, 0), orientationAngle_).Data());
+	glDrawElements(mesh.mode, MeshGeometry::INDEX_COUNT, GL_UNSIGNED_BYTE, mesh.indices.data());
 
-	MoveShip();
-	WrapAroundMoveShip();
+	glPopMatrix();
+}
 
-	glVertexPointer(3, GL_FLOAT, 0, shipVertices_.Data());
+void Ship::DrawShip(const RenderSnapshot &snapshot)
+{
+	glPushMatrix();
+
+	const MeshGeometry &mesh = MeshRegistry::Get(MeshId::SHIP);
+	glVertexPointer(3, GL_FLOAT, 0, mesh.vertices.data());
 	glColor3f(0.0f, 1.0f, 0.0f);
-	glLoadIdentity();
-	Resource2DGLfloat& frame = GetFrame();
-	glTranslatef(frame.GetData(0, 0), frame.GetData(1, 0), frame.GetData(2, 0));
-	glRotatef(orientationAngle_ * (180.0f / PI), 0.0f, 0.0f, 1.0f);
-	glDrawElements(GL_LINE_LOOP, 24, GL_UNSIGNED_BYTE, shipIndices_.Data());
+	glLoadMatrixf(Mat4::Transform(snapshot.shipX, snapshot.shipY, snapshot.shipZ, snapshot.shipOrientation).Data());
+	glDrawElements(mesh.mode, MeshGeometry::INDEX_COUNT, GL_UNSIGNED_BYTE, mesh.indices.data());
 
 	glPopMatrix();
 }
 
+void Ship::Snapshot(RenderSnapshot &snapshot)
+{
+	Mat4Resource &frame = GetFrame();
+	snapshot.hasShip = true;
+	snapshot.shipX = frame.GetData(0, 0);
+	snapshot.shipY = frame.GetData(1, 0);
+	snapshot.shipZ = frame.GetData(2, 0);
+	snapshot.shipOrientation = orientationAngle_;
+}
+
 void Ship::Update(
 	const GLfloat _orientationAngle,
 	const GLfloat _thrust,
-	const std::set<std::string, std::less<>> &serializedKeys,
-	boost::asio::thread_pool &threadPool,
-	std::vector<std::future<std::shared_ptr<GLEntity>>> &futures)
+	const WorldBounds &bounds,
+	BulletArchetype &bullets,
+	TaskScheduler &scheduler)
 {
 	RecomputeShipVelocity(_thrust);
-
-	const GLfloat speed = GetSpeed();
-	S_ = Resource2DGLfloat({{speed, 0.0f, 0.0f, 0.0f},
-							{0.0f, speed, 0.0f, 0.0f},
-							{0.0f, 0.0f, speed, 0.0f},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
-
-	Resource2DGLfloat& frame = GetFrame();
-	T_ = Resource2DGLfloat({{1.0f, 0.0f, 0.0f, frame.GetData(0, 0)},
-							{0.0f, 1.0f, 0.0f, frame.GetData(1, 0)},
-							{0.0f, 0.0f, 1.0f, frame.GetData(2, 0)},
-							{0.0f, 0.0f, 0.0f, 1.0f}});
+	SetMotionMatrices();
 
 	if (!(fabs(_orientationAngle - 0.0f) <= 0.00001f))
 	{
-		R_ = Resource2DGLfloat({{cos(_orientationAngle), -sin(_orientationAngle), 0.0f, 0.0f},
-								{sin(_orientationAngle), cos(_orientationAngle), 0.0f, 0.0f},
-								{0.0f, 0.0f, 1.0f, 0.0f},
-								{0.0f, 0.0f, 0.0f, 1.0f}});
+		R_.Set(Mat4::RotationZ(_orientationAngle));
 
-		doRotate_ = true;
+		ChangeShipOrientation();
 	}
 
-	UpdateBullets(serializedKeys, threadPool, futures);
+	MoveShip();
+	WrapAroundMoveShip(bounds);
+
+	UpdateBullets(bullets, bounds, scheduler);
 }
 
-void Ship::RemoveBullet(const std::string_view key, const std::set<std::string, std::less<>> &serializedKeys)
+void Ship::RemoveBullet(const std::string_view key)
 {
-	if (serializedKeys.find(key) != serializedKeys.cend())
-		outOfScopeBulletKeys_.insert(std::string(key));
 	RemoveMember(std::string(key));
 }
 
 void Ship::AddBullet(const SharedEntity &bullet)
 {
 	AggregateMember(bullet);
-	Deserializer->GetRegistry().RegisterEntity<Bullet>(bullet->GetKey());
-	Loader->GetRegistry().RegisterEntity<Bullet>(bullet->GetKey());
-}
-
-GLint Ship::BulletNumber()
-{
-	return BULLET_COUNT;
 }
 
-void Ship::Fire()
+void Ship::Fire(BulletArchetype &bullets, const size_t maxBullets)
 {
-	if (std::map<Key, SharedEntity> &bullets = GetAggregatedMembers(); bullets.size() > BulletNumber())
+	if (bullets.Size() >= maxBullets)
 		return;
 
-	const std::string key = Bullet::BulletPrefix() + GenerateUUID();
-
-	Resource2DGLfloat& frame = GetFrame();
-	SharedEntity bullet = std::make_shared<Bullet>(frame.GetData(0, 0), frame.GetData(1, 0));
-	bullet->SetKey(key);
-#ifndef SAVE_TO_DB
-	Bullet::RegisterSerializationResources(bullet->GetKey());
-#else
-	Bullet::RegisterPersistenceResources(bullet->GetKey());
-#endif
+	Mat4Resource& frame = GetFrame();
+	bullets.Add(Bullet::NewRow(frame.GetData(0, 0), frame.GetData(1, 0)));
 
 	bulletFired_ = true;
-
-	AddBullet(bullet);
 }
 
-const Resource2DGLfloat &Ship::GetUnitOrientation() const
+const Mat4Resource &Ship::GetUnitOrientation() const
 {
 	return unitOrientation_;
 }
 
-const Resource2DGLfloat &Ship::GetShipVertices() const
+ShipRow Ship::ToRow()
 {
-	return shipVertices_;
-}
-
-const ResourceGLubyte &Ship::GetShipIndices() const
-{
-	return shipIndices_;
+	ShipRow ship;
+	ship.frame = GetFrame().Get();
+	ship.unitVelocity = GetUnitVelocity().Get();
+	ship.S = S_.Get();
+	ship.T = T_.Get();
+	ship.R = R_.Get();
+	ship.unitOrientation = unitOrientation_.Get();
+	ship.velocityAngle = GetVelocityAngle();
+	ship.speed = GetSpeed();
+	ship.mass = GetMass();
+	ship.orientationAngle = orientationAngle_;
+	ship.bulletFired = bulletFired_;
+	return ship;
 }
 
 void Ship::Save(ptree &tree, const std::string &path) const
@@ -432,11 +300,16 @@ void Ship::Save(ptree &tree, const std::string &path) const
 	if (!fs::exists(path))
 		fs::create_directories(path);
 
-	ResourceSerializer * const serializer = ResourceSerializer::GetInstance();
+	BlobStore * const blobs = BlobStore::GetInstance();
+	tree.put(SHIP_VERTICES_KEY, blobs->Serialize(MeshRegistry::VerticesResource(MeshId::SHIP)));
+	tree.put(SHIP_INDICES_KEY, blobs->Serialize(MeshRegistry::IndicesResource(MeshId::SHIP)));
 
-	serializer->Serialize(shipVertices_.Lock(), SHIP_VERTICES_KEY, path);
-	serializer->Serialize(shipIndices_.Lock(), SHIP_INDICES_KEY, path);
-	serializer->Serialize(unitOrientation_.Lock(), UNIT_ORIENTATION_KEY, path);
+	SaveJournal * const journal = SaveJournal::GetInstance();
+	if (journal->Changed(GetKey(), UNIT_ORIENTATION_KEY, BlobStore::Hash(unitOrientation_)))
+	{
+		ResourceSerializer * const serializer = ResourceSerializer::GetInstance();
+		serializer->Serialize(unitOrientation_.ToResource().Lock(), UNIT_ORIENTATION_KEY, path);
+	}
 
 	GLEntity::Save(tree, path);
 }
@@ -448,14 +321,7 @@ void Ship::Load(ptree &tree, const std::string &path)
 	bulletFired_ = tree.get_child(BULLET_FIRED_KEY).data() == TRUE_VAL ? true : false;
 	orientationAngle_ = std::stof(tree.get_child(ORIENTATION_ANGLE_KEY).data());
 
-	ResourceDeserializer * const deserializer = ResourceDeserializer::GetInstance();
-
-	std::unique_ptr<ISerializableResource> deserializedVertices = deserializer->Deserialize(SHIP_VERTICES_KEY, path);
-	shipVertices_ = *static_cast<Resource2DGLfloat *>(deserializedVertices.get());
-	std::unique_ptr<ISerializableResource> deserializedIndices = deserializer->Deserialize(SHIP_INDICES_KEY, path);
-	shipIndices_ = *static_cast<ResourceGLubyte *>(deserializedIndices.get());
-	std::unique_ptr<ISerializableResource> deserializedOrientation = deserializer->Deserialize(UNIT_ORIENTATION_KEY, path);
-	unitOrientation_ = *static_cast<Resource2DGLfloat *>(deserializedOrientation.get());
+	RestoreQueue::GetInstance()->Defer(unitOrientation_, GetKey(), UNIT_ORIENTATION_KEY, path);
 }
 
 void Ship::Save(boost::property_tree::ptree &tree, Sqlite &database) const
@@ -463,15 +329,24 @@ void Ship::Save(boost::property_tree::ptree &tree, Sqlite &database) const
 	tree.put(BULLET_FIRED_KEY, bulletFired_);
 	tree.put(ORIENTATION_ANGLE_KEY, orientationAngle_);
 
-	ResourcePersister *persister = ResourcePersister::GetInstance();
-
-	persister->Persist(shipVertices_, FormatKey(GetKey() + SHIP_VERTICES_KEY));
-	persister->Persist(shipIndices_, FormatKey(GetKey() + SHIP_INDICES_KEY));
-	persister->Persist(unitOrientation_, FormatKey(GetKey() + UNIT_ORIENTATION_KEY));
+	BlobStore * const blobs = BlobStore::GetInstance();
+	tree.put(SHIP_VERTICES_KEY, blobs->Persist(MeshRegistry::VerticesResource(MeshId::SHIP)));
+	tree.put(SHIP_INDICES_KEY, blobs->Persist(MeshRegistry::IndicesResource(MeshId::SHIP)));
 
 	GLEntity::Save(tree, database);
 }
 
+void Ship::PersistMatrices() const
+{
+	SaveJournal * const journal = SaveJournal::GetInstance();
+	if (journal->Changed(GetKey(), UNIT_ORIENTATION_KEY, BlobStore::Hash(unitOrientation_)))
+	{
+		SaveDatabase::GetInstance()->Persist(FormatKey(GetKey() + UNIT_ORIENTATION_KEY), unitOrientation_);
+	}
+
+	GLEntity::PersistMatrices();
+}
+
 void Ship::Load(boost::property_tree::ptree &tree, Sqlite &database)
 {
 	GLEntity::Load(tree, database);
@@ -479,12 +354,5 @@ void Ship::Load(boost::property_tree::ptree &tree, Sqlite &database)
 	bulletFired_ = tree.get_child(BULLET_FIRED_KEY).data() == TRUE_VAL ? true : false;
 	orientationAngle_ = std::stof(tree.get_child(ORIENTATION_ANGLE_KEY).data());
 
-	ResourceLoader * const loader = ResourceLoader::GetInstance();
-
-	std::unique_ptr<IPersistableResource> deserializedVertices = loader->Load(FormatKey(GetKey() + SHIP_VERTICES_KEY));
-	shipVertices_ = *static_cast<Resource2DGLfloat *>(deserializedVertices.get());
-	std::unique_ptr<IPersistableResource> deserializedIndices = loader->Load(FormatKey(GetKey() + SHIP_INDICES_KEY));
-	shipIndices_ = *static_cast<ResourceGLubyte *>(deserializedIndices.get());
-	std::unique_ptr<IPersistableResource> deserializedOrientation = loader->Load(FormatKey(GetKey() + UNIT_ORIENTATION_KEY));
-	unitOrientation_ = *static_cast<Resource2DGLfloat *>(deserializedOrientation.get());
+	RestoreQueue::GetInstance()->Defer(unitOrientation_, GetKey(), UNIT_ORIENTATION_KEY, std::string());
 }
@@ -0,0 +1,201 @@
+#include "game/Simulation.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "configuration/config.h"
+#include "game/Asteroids.h"
+#include "game/FrameTimings.h"
+#include "game/IRenderer.h"
+#include "game/InputRecording.h"
+#include "game/RenderSnapshot.h"
+#include "gl/GLEntity.h"
+
+using asteroids::Asteroids;
+using asteroids::Command;
+using asteroids::IRenderer;
+using asteroids::InputRecorder;
+using asteroids::RenderSnapshot;
+using asteroids::ScopedTimer;
+using asteroids::Simulation;
+using asteroids::TimedStage;
+using asteroids::WorldBounds;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// a simulation which falls further behind than this skips ahead instead of catching up
+const int MAX_TICKS_BEHIND = 5;
+} // end namespace
+
+Simulation::Simulation(std::shared_ptr<Asteroids> game, IRenderer &renderer) : game_(std::move(game)), renderer_(renderer)
+{
+}
+
+Simulation::~Simulation()
+{
+	Stop();
+}
+
+void Simulation::Start()
+{
+	if (running_.exchange(true))
+		return;
+	thread_ = std::thread(&Simulation::Loop, this);
+}
+
+bool Simulation::Record(const std::filesystem::path &path, const std::string_view scenario)
+{
+	std::random_device device;
+	const std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+
+	auto recorder = std::make_unique<InputRecorder>();
+	if (running_ || !recorder->Open(path, seed, scenario))
+		return false;
+	recorder_ = std::move(recorder);
+	return true;
+}
+
+void Simulation::NewGame()
+{
+	newGame_ = true;
+}
+
+void Simulation::Stop()
+{
+	running_ = false;
+	if (thread_.joinable())
+		thread_.join();
+	if (recorder_)
+		recorder_->Close(frame_);
+}
+
+void Simulation::Post(const Command command)
+{
+	std::lock_guard<std::mutex> lock(commandMutex_);
+	commands_.push_back(command);
+}
+
+void Simulation::Resize(const WorldBounds &bounds)
+{
+	drawnBounds_ = bounds;
+	std::lock_guard<std::mutex> lock(commandMutex_);
+	bounds_ = bounds;
+}
+
+void Simulation::Draw()
+{
+	// the bounds only change on resize, so they are only queued when they differ
+	const WorldBounds bounds = renderer_.GetBounds();
+	if (!drawnBounds_ || drawnBounds_->right != bounds.right || drawnBounds_->top != bounds.top)
+		Resize(bounds);
+
+	renderer_.Draw(snapshots_.Acquire());
+}
+
+void Simulation::ApplyCommands()
+{
+	std::optional<WorldBounds> bounds;
+	{
+		std::lock_guard<std::mutex> lock(commandMutex_);
+		std::swap(commands_, executing_);
+		std::swap(bounds_, bounds);
+	}
+
+	// a replay depends on nothing but its recording, so neither it nor the recorded session touches the save
+	if (recorder_ || !running_)
+		std::erase_if(executing_, [](const Command command)
+					  { return command == Command::SERIALIZE || command == Command::DESERIALIZE; });
+
+	if (recorder_)
+	{
+		if (bounds)
+			recorder_->Resize(frame_, *bounds);
+		for (const Command command : executing_)
+			recorder_->Record(frame_, command);
+	}
+
+	if (bounds)
+		game_->SetBounds(*bounds);
+	for (const Command command : executing_)
+		Execute(command);
+	executing_.clear();
+}
+
+void Simulation::Advance()
+{
+	ApplyCommands();
+	game_->Step(Asteroids::TickSeconds());
+
+	ScopedTimer timer(TimedStage::SNAPSHOT);
+	game_->Snapshot(snapshots_.Back());
+	snapshots_.Publish();
+	++frame_;
+}
+
+void Simulation::Execute(const Command command)
+{
+	switch (command)
+	{
+	case Command::ROTATE_LEFT:
+		game_->RotateLeft();
+		break;
+	case Command::ROTATE_RIGHT:
+		game_->RotateRight();
+		break;
+	case Command::THRUST:
+		game_->Thrust();
+		break;
+	case Command::FIRE:
+		game_->Fire();
+		break;
+	case Command::RESET:
+		game_->ResetGame();
+		break;
+	case Command::SERIALIZE:
+		game_->Serialize();
+		break;
+	case Command::DESERIALIZE:
+		game_->Deserialize();
+		break;
+	default:
+		break;
+	}
+}
+
+void Simulation::Loop()
+{
+	// a replay starts from a new game under the recorded seed, so a recorded session must too
+	if (recorder_)
+	{
+		game_->SetSeed(recorder_->GetSeed());
+		game_->ResetGame();
+	}
+	else if (newGame_)
+		game_->ResetGame();
+	else
+		game_->Run();
+
+	const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<GLfloat>(Asteroids::TickSeconds()));
+	Clock::time_point next = Clock::now();
+	while (running_)
+	{
+		Advance();
+
+		next += tick;
+		const Clock::time_point now = Clock::now();
+		if (now - next > MAX_TICKS_BEHIND * tick)
+			next = now;
+		std::this_thread::sleep_until(next);
+	}
+}
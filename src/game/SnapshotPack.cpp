@@ -0,0 +1,449 @@
+#include "game/SnapshotPack.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "configuration/filesystem.hpp"
+#include "game/EntityHandle.h"
+#include "game/EntityStore.h"
+#include "game/Ship.h"
+#include "gl/Mat4.h"
+
+using asteroids::BulletArchetype;
+using asteroids::BulletRow;
+using asteroids::GameRow;
+using asteroids::Mat4;
+using asteroids::RockArchetype;
+using asteroids::RockRow;
+using asteroids::ShipRow;
+using asteroids::SnapshotPack;
+using asteroids::State;
+
+namespace
+{
+const std::array<unsigned char, 4> MAGIC = {'A', 'S', 'T', 'P'};
+const std::string PARTIAL_SUFFIX = ".partial";
+const std::uint32_t SHIP_FLAG = 1u;
+
+// header: magic, version, header size, flags, score, orientation angle, thrust, reserved,
+// rock count, bullet count, rock table offset, bullet table offset, ship offset, file size
+const size_t HEADER_BYTES = 80;
+// handle, state, nine floats, spin direction, initialized
+const size_t ROCK_BYTES = 56;
+// handle, seven floats, initialized and out of bounds bytes, padding
+const size_t BULLET_BYTES = 40;
+// six matrices, four floats, bullet fired
+const size_t SHIP_BYTES = 6 * 16 * 4 + 4 * 4 + 4;
+
+// rows are streamed to the file in chunks of about this many bytes
+const size_t CHUNK_BYTES = 1 << 16;
+
+/**
+ * @brief Appends little-endian fields to a buffer which is flushed to a stream in chunks.
+ */
+class PackWriter
+{
+public:
+	explicit PackWriter(std::ofstream &stream) : stream_(stream)
+	{
+		buffer_.reserve(CHUNK_BYTES + SHIP_BYTES);
+	}
+
+	void U8(const std::uint8_t value)
+	{
+		buffer_.push_back(value);
+	}
+
+	void U32(const std::uint32_t value)
+	{
+		for (int byte = 0; byte < 4; ++byte)
+			buffer_.push_back(static_cast<unsigned char>(value >> (8 * byte)));
+	}
+
+	void U64(const std::uint64_t value)
+	{
+		for (int byte = 0; byte < 8; ++byte)
+			buffer_.push_back(static_cast<unsigned char>(value >> (8 * byte)));
+	}
+
+	void F32(const GLfloat value)
+	{
+		U32(std::bit_cast<std::uint32_t>(value));
+	}
+
+	void Matrix(const Mat4 &matrix)
+	{
+		for (const GLfloat value : matrix.m)
+			F32(value);
+	}
+
+	void FlushIfFull()
+	{
+		if (buffer_.size() >= CHUNK_BYTES)
+			Flush();
+	}
+
+	void Flush()
+	{
+		stream_.write(reinterpret_cast<const char *>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+		buffer_.clear();
+	}
+
+private:
+	std::ofstream &stream_;
+	std::vector<unsigned char> buffer_;
+};
+
+/**
+ * @brief Reads little-endian fields from mapped bytes.
+ */
+class PackReader
+{
+public:
+	explicit PackReader(const unsigned char *data) : data_(data)
+	{
+	}
+
+	std::uint8_t U8()
+	{
+		return *data_++;
+	}
+
+	std::uint32_t U32()
+	{
+		std::uint32_t value = 0;
+		for (int byte = 0; byte < 4; ++byte)
+			value |= static_cast<std::uint32_t>(*data_++) << (8 * byte);
+		return value;
+	}
+
+	std::uint64_t U64()
+	{
+		std::uint64_t value = 0;
+		for (int byte = 0; byte < 8; ++byte)
+			value |= static_cast<std::uint64_t>(*data_++) << (8 * byte);
+		return value;
+	}
+
+	GLfloat F32()
+	{
+		return std::bit_cast<GLfloat>(U32());
+	}
+
+	Mat4 Matrix()
+	{
+		Mat4 matrix;
+		for (GLfloat &value : matrix.m)
+			value = F32();
+		return matrix;
+	}
+
+	void Skip(const size_t bytes)
+	{
+		data_ += bytes;
+	}
+
+private:
+	const unsigned char *data_;
+};
+} // end namespace
+
+bool SnapshotPack::Write(
+	const std::string &path,
+	const GameRow &game,
+	const RockArchetype &rocks,
+	const BulletArchetype &bullets,
+	const ShipRow *ship)
+{
+	const size_t rocksOffset = HEADER_BYTES;
+	const size_t bulletsOffset = rocksOffset + rocks.Size() * ROCK_BYTES;
+	const size_t shipOffset = ship ? bulletsOffset + bullets.Size() * BULLET_BYTES : 0;
+	const size_t fileBytes = bulletsOffset + bullets.Size() * BULLET_BYTES + (ship ? SHIP_BYTES : 0);
+
+	const fs::path folder = fs::path(path).parent_path();
+	if (!folder.empty() && !fs::exists(folder))
+		fs::create_directories(folder);
+
+	// written beside the pack and renamed over it, so a failed save leaves the previous pack intact
+	const std::string partialPath = path + PARTIAL_SUFFIX;
+	std::ofstream stream(partialPath, std::ios::binary | std::ios::trunc);
+	if (!stream)
+		return false;
+
+	PackWriter writer(stream);
+
+	for (const unsigned char byte : MAGIC)
+		writer.U8(byte);
+	writer.U32(VERSION);
+	writer.U32(static_cast<std::uint32_t>(HEADER_BYTES));
+	writer.U32(ship ? SHIP_FLAG : 0u);
+	writer.U32(static_cast<std::uint32_t>(game.score));
+	writer.F32(game.orientationAngle);
+	writer.F32(game.thrust);
+	writer.U32(0u);
+	writer.U64(rocks.Size());
+	writer.U64(bullets.Size());
+	writer.U64(rocksOffset);
+	writer.U64(bulletsOffset);
+	writer.U64(shipOffset);
+	writer.U64(fileBytes);
+
+	for (size_t row = 0; row < rocks.Size(); ++row)
+	{
+		writer.U32(rocks.handles[row].slot);
+		writer.U32(rocks.handles[row].generation);
+		writer.U32(static_cast<std::uint32_t>(rocks.state[row]));
+		writer.F32(rocks.x[row]);
+		writer.F32(rocks.y[row]);
+		writer.F32(rocks.ux[row]);
+		writer.F32(rocks.uy[row]);
+		writer.F32(rocks.speed[row]);
+		writer.F32(rocks.velocityAngle[row]);
+		writer.F32(rocks.mass[row]);
+		writer.F32(rocks.spin[row]);
+		writer.F32(rocks.spinEpsilon[row]);
+		writer.U32(static_cast<std::uint32_t>(rocks.spinDirection[row]));
+		// rows only enter the store once their velocity is initialized
+		writer.U32(1u);
+		writer.FlushIfFull();
+	}
+
+	for (size_t row = 0; row < bullets.Size(); ++row)
+	{
+		writer.U32(bullets.handles[row].slot);
+		writer.U32(bullets.handles[row].generation);
+		writer.F32(bullets.x[row]);
+		writer.F32(bullets.y[row]);
+		writer.F32(bullets.ux[row]);
+		writer.F32(bullets.uy[row]);
+		writer.F32(bullets.speed[row]);
+		writer.F32(bullets.velocityAngle[row]);
+		writer.F32(bullets.mass[row]);
+		writer.U8(bullets.initialized[row]);
+		writer.U8(bullets.outOfBounds[row]);
+		writer.U8(0);
+		writer.U8(0);
+		writer.FlushIfFull();
+	}
+
+	if (ship)
+	{
+		writer.Matrix(ship->frame);
+		writer.Matrix(ship->unitVelocity);
+		writer.Matrix(ship->S);
+		writer.Matrix(ship->T);
+		writer.Matrix(ship->R);
+		writer.Matrix(ship->unitOrientation);
+		writer.F32(ship->velocityAngle);
+		writer.F32(ship->speed);
+		writer.F32(ship->mass);
+		writer.F32(ship->orientationAngle);
+		writer.U32(ship->bulletFired ? 1u : 0u);
+	}
+
+	writer.Flush();
+	stream.close();
+	if (!stream)
+		return false;
+
+	fs::rename(partialPath, path);
+	return true;
+}
+
+SnapshotPack::SnapshotPack() = default;
+
+SnapshotPack::~SnapshotPack() noexcept
+{
+	Close();
+}
+
+bool SnapshotPack::Open(const std::string &path)
+{
+	Close();
+
+#ifndef _WIN32
+	const int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status;
+	if (::fstat(file, &status) != 0 || status.st_size < static_cast<off_t>(HEADER_BYTES))
+	{
+		::close(file);
+		return false;
+	}
+
+	void *mapping = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	::close(file);
+	if (mapping == MAP_FAILED)
+		return false;
+
+	data_ = static_cast<const unsigned char *>(mapping);
+	bytes_ = static_cast<size_t>(status.st_size);
+#else
+	std::ifstream stream(path, std::ios::binary | std::ios::ate);
+	if (!stream)
+		return false;
+
+	buffer_.resize(static_cast<size_t>(stream.tellg()));
+	stream.seekg(0);
+	if (buffer_.size() < HEADER_BYTES || !stream.read(reinterpret_cast<char *>(buffer_.data()), static_cast<std::streamsize>(buffer_.size())))
+	{
+		buffer_.clear();
+		return false;
+	}
+
+	data_ = buffer_.data();
+	bytes_ = buffer_.size();
+#endif
+
+	PackReader reader(data_);
+	bool valid = std::equal(MAGIC.begin(), MAGIC.end(), data_);
+	reader.Skip(MAGIC.size());
+	valid = reader.U32() == VERSION && valid;
+	valid = reader.U32() == HEADER_BYTES && valid;
+	const bool hasShip = (reader.U32() & SHIP_FLAG) != 0;
+	reader.Skip(4 * 4);
+
+	const std::uint64_t rockCount = reader.U64();
+	const std::uint64_t bulletCount = reader.U64();
+	const std::uint64_t rocksOffset = reader.U64();
+	const std::uint64_t bulletsOffset = reader.U64();
+	const std::uint64_t shipOffset = reader.U64();
+	const std::uint64_t fileBytes = reader.U64();
+
+	// the tables must lie back to back within the file, which also bounds the counts
+	valid = valid && fileBytes == bytes_ && rocksOffset == HEADER_BYTES;
+	valid = valid && rockCount <= (bytes_ - rocksOffset) / ROCK_BYTES && bulletsOffset == rocksOffset + rockCount * ROCK_BYTES;
+	valid = valid && bulletCount <= (bytes_ - bulletsOffset) / BULLET_BYTES;
+	const std::uint64_t tablesEnd = bulletsOffset + bulletCount * BULLET_BYTES;
+	valid = valid && (hasShip ? shipOffset == tablesEnd && tablesEnd + SHIP_BYTES == bytes_ : shipOffset == 0 && tablesEnd == bytes_);
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+
+	rockCount_ = static_cast<size_t>(rockCount);
+	bulletCount_ = static_cast<size_t>(bulletCount);
+	rocksOffset_ = static_cast<size_t>(rocksOffset);
+	bulletsOffset_ = static_cast<size_t>(bulletsOffset);
+	shipOffset_ = static_cast<size_t>(shipOffset);
+	return true;
+}
+
+void SnapshotPack::Close()
+{
+#ifndef _WIN32
+	if (data_)
+		::munmap(const_cast<unsigned char *>(data_), bytes_);
+#else
+	buffer_.clear();
+#endif
+	data_ = nullptr;
+	bytes_ = 0;
+	rockCount_ = 0;
+	bulletCount_ = 0;
+	rocksOffset_ = 0;
+	bulletsOffset_ = 0;
+	shipOffset_ = 0;
+}
+
+GameRow SnapshotPack::GetGame() const
+{
+	PackReader reader(data_ + 16);
+
+	GameRow game;
+	game.score = static_cast<GLint>(reader.U32());
+	game.orientationAngle = reader.F32();
+	game.thrust = reader.F32();
+	return game;
+}
+
+size_t SnapshotPack::GetRockCount() const
+{
+	return rockCount_;
+}
+
+RockRow SnapshotPack::GetRock(const size_t row) const
+{
+	PackReader reader(data_ + rocksOffset_ + row * ROCK_BYTES);
+
+	RockRow rock;
+	rock.handle.slot = reader.U32();
+	rock.handle.generation = reader.U32();
+	rock.state = static_cast<State>(reader.U32());
+	rock.x = reader.F32();
+	rock.y = reader.F32();
+	rock.ux = reader.F32();
+	rock.uy = reader.F32();
+	rock.speed = reader.F32();
+	rock.velocityAngle = reader.F32();
+	rock.mass = reader.F32();
+	rock.spin = reader.F32();
+	rock.spinEpsilon = reader.F32();
+	rock.spinDirection = static_cast<GLint>(reader.U32());
+	rock.initialized = reader.U32() != 0;
+	return rock;
+}
+
+size_t SnapshotPack::GetBulletCount() const
+{
+	return bulletCount_;
+}
+
+BulletRow SnapshotPack::GetBullet(const size_t row) const
+{
+	PackReader reader(data_ + bulletsOffset_ + row * BULLET_BYTES);
+
+	BulletRow bullet;
+	bullet.handle.slot = reader.U32();
+	bullet.handle.generation = reader.U32();
+	bullet.x = reader.F32();
+	bullet.y = reader.F32();
+	bullet.ux = reader.F32();
+	bullet.uy = reader.F32();
+	bullet.speed = reader.F32();
+	bullet.velocityAngle = reader.F32();
+	bullet.mass = reader.F32();
+	bullet.initialized = reader.U8() != 0;
+	bullet.outOfBounds = reader.U8() != 0;
+	return bullet;
+}
+
+bool SnapshotPack::HasShip() const
+{
+	return shipOffset_ != 0;
+}
+
+ShipRow SnapshotPack::GetShip() const
+{
+	PackReader reader(data_ + shipOffset_);
+
+	ShipRow ship;
+	ship.frame = reader.Matrix();
+	ship.unitVelocity = reader.Matrix();
+	ship.S = reader.Matrix();
+	ship.T = reader.Matrix();
+	ship.R = reader.Matrix();
+	ship.unitOrientation = reader.Matrix();
+	ship.velocityAngle = reader.F32();
+	ship.speed = reader.F32();
+	ship.mass = reader.F32();
+	ship.orientationAngle = reader.F32();
+	ship.bulletFired = reader.U32() != 0;
+	return ship;
+}
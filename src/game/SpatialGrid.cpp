@@ -0,0 +1,112 @@
+#include "game/SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "game/EntityStore.h"
+#include "game/ParallelFor.h"
+#include "game/TaskScheduler.h"
+#include "gl/GLEntity.h"
+
+using asteroids::ParallelForChunks;
+using asteroids::RockArchetype;
+using asteroids::SpatialGrid;
+using asteroids::TaskScheduler;
+using asteroids::WorldBounds;
+
+namespace
+{
+const size_t MIN_CHUNK_ROCKS = 4096;
+
+size_t CellIndex(const GLfloat coordinate, const GLfloat min, const GLfloat cellSize, const size_t cellCount)
+{
+	const GLfloat cell = std::floor((coordinate - min) / cellSize);
+	if (!(cell > 0.0f))
+		return 0;
+	return std::min(static_cast<size_t>(cell), cellCount - 1);
+}
+} // end namespace
+
+SpatialGrid::SpatialGrid(const GLfloat cellSize) : cellSize_(cellSize)
+{
+}
+
+size_t SpatialGrid::CellColumn(const GLfloat x) const
+{
+	return CellIndex(x, minX_, cellSize_, cellColumns_);
+}
+
+size_t SpatialGrid::CellRow(const GLfloat y) const
+{
+	return CellIndex(y, minY_, cellSize_, cellRows_);
+}
+
+void SpatialGrid::CountChunk(const RockArchetype &rocks, const size_t chunk, const size_t begin, const size_t end)
+{
+	size_t *counts = chunkCounts_.data() + chunk * cellColumns_ * cellRows_;
+	for (size_t rock = begin; rock < end; ++rock)
+	{
+		const size_t cell = CellRow(rocks.y[rock]) * cellColumns_ + CellColumn(rocks.x[rock]);
+		cellOfRock_[rock] = cell;
+		++counts[cell];
+	}
+}
+
+void SpatialGrid::ScatterChunk(const RockArchetype &rocks, const size_t chunk, const size_t begin, const size_t end)
+{
+	size_t *offsets = chunkCounts_.data() + chunk * cellColumns_ * cellRows_;
+	for (size_t rock = begin; rock < end; ++rock)
+	{
+		const size_t entry = offsets[cellOfRock_[rock]]++;
+		entries_[entry] = rock;
+		entryX_[entry] = rocks.x[rock];
+		entryY_[entry] = rocks.y[rock];
+		entryState_[entry] = rocks.state[rock];
+	}
+}
+
+void SpatialGrid::Build(const RockArchetype &rocks, const WorldBounds &bounds, TaskScheduler &scheduler)
+{
+	// rocks wrap around a little past the bounds, so the grid reaches one cell beyond them
+	const GLfloat halfWidth = bounds.right + cellSize_;
+	const GLfloat halfHeight = bounds.top + cellSize_;
+	minX_ = -halfWidth;
+	minY_ = -halfHeight;
+	cellColumns_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(2 * halfWidth / cellSize_)));
+	cellRows_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(2 * halfHeight / cellSize_)));
+
+	const size_t cells = cellColumns_ * cellRows_;
+	const size_t rockCount = rocks.Size();
+
+	chunks_ = asteroids::ChunkCount(rockCount, MIN_CHUNK_ROCKS);
+
+	cellOfRock_.resize(rockCount);
+	entries_.resize(rockCount);
+	entryX_.resize(rockCount);
+	entryY_.resize(rockCount);
+	entryState_.resize(rockCount);
+	chunkCounts_.assign(chunks_ * cells, 0);
+	cellStart_.assign(cells + 1, 0);
+
+	ParallelForChunks(scheduler, rockCount, chunks_, [this, &rocks](const size_t chunk, const size_t begin, const size_t end)
+					  { CountChunk(rocks, chunk, begin, end); });
+
+	// turn the per chunk counts into the offset each chunk starts writing each cell at
+	size_t offset = 0;
+	for (size_t cell = 0; cell < cells; ++cell)
+	{
+		cellStart_[cell] = offset;
+		for (size_t chunk = 0; chunk < chunks_; ++chunk)
+		{
+			size_t &count = chunkCounts_[chunk * cells + cell];
+			const size_t chunkCount = count;
+			count = offset;
+			offset += chunkCount;
+		}
+	}
+	cellStart_[cells] = offset;
+
+	ParallelForChunks(scheduler, rockCount, chunks_, [this, &rocks](const size_t chunk, const size_t begin, const size_t end)
+					  { ScatterChunk(rocks, chunk, begin, end); });
+}
@@ -0,0 +1,205 @@
+#include "game/TaskScheduler.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using asteroids::TaskGraph;
+using asteroids::TaskGroup;
+using asteroids::TaskScheduler;
+
+namespace
+{
+// the scheduler the calling thread works for and the index of its queue
+thread_local const TaskScheduler *currentScheduler = nullptr;
+thread_local size_t currentQueue = 0;
+} // end namespace
+
+bool TaskGroup::Done() const
+{
+	return pending_.load(std::memory_order_acquire) == 0;
+}
+
+void TaskGroup::Fail(std::exception_ptr error)
+{
+	std::lock_guard<std::mutex> lock(errorMutex_);
+	if (!error_)
+		error_ = std::move(error);
+}
+
+TaskScheduler::TaskScheduler(const size_t workers)
+{
+	for (size_t queue = 0; queue <= workers; ++queue)
+		queues_.push_back(std::make_unique<Queue>());
+
+	for (size_t worker = 0; worker < workers; ++worker)
+		workers_.emplace_back([this, worker]()
+							  { WorkerLoop(worker); });
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+
+	for (std::thread &worker : workers_)
+		worker.join();
+}
+
+size_t TaskScheduler::WorkerCount() const
+{
+	return workers_.size();
+}
+
+size_t TaskScheduler::HomeQueue() const
+{
+	return currentScheduler == this ? currentQueue : workers_.size();
+}
+
+void TaskScheduler::Submit(TaskGroup &group, Task task)
+{
+	group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+	Queue &queue = *queues_[HomeQueue()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(Entry{std::move(task), &group});
+	}
+	queued_.fetch_add(1);
+
+	// a worker counts itself as sleeping before it checks the queued count, so one of the two sees the other
+	if (sleeping_.load() == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+	}
+	wake_.notify_one();
+}
+
+bool TaskScheduler::RunOne(const size_t home)
+{
+	Entry entry;
+	bool found = false;
+	for (size_t offset = 0; offset < queues_.size() && !found; ++offset)
+	{
+		Queue &queue = *queues_[(home + offset) % queues_.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			continue;
+
+		// the owner takes its newest task, thieves take the oldest
+		if (offset == 0)
+		{
+			entry = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			entry = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		found = true;
+	}
+	if (!found)
+		return false;
+
+	queued_.fetch_sub(1, std::memory_order_relaxed);
+
+	// a throwing task must not take down a worker nor leave its group pending forever
+	try
+	{
+		entry.task();
+	}
+	catch (...)
+	{
+		entry.group->Fail(std::current_exception());
+	}
+	entry.group->pending_.fetch_sub(1, std::memory_order_acq_rel);
+	return true;
+}
+
+void TaskScheduler::Wait(TaskGroup &group)
+{
+	const size_t home = HomeQueue();
+	while (!group.Done())
+	{
+		if (!RunOne(home))
+			std::this_thread::yield();
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(group.errorMutex_);
+		error = std::exchange(group.error_, nullptr);
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+void TaskScheduler::WorkerLoop(const size_t index)
+{
+	currentScheduler = this;
+	currentQueue = index;
+
+	while (!stop_)
+	{
+		if (RunOne(index))
+			continue;
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleeping_.fetch_add(1);
+		wake_.wait(lock, [this]()
+				   { return stop_ || queued_.load() > 0; });
+		sleeping_.fetch_sub(1);
+	}
+}
+
+TaskGraph::StageId TaskGraph::AddStage(TaskScheduler::Task work, std::initializer_list<StageId> dependencies)
+{
+	const StageId id = stages_.size();
+	Stage &stage = stages_.emplace_back();
+	stage.work = std::move(work);
+	stage.dependencyCount = dependencies.size();
+	for (const StageId dependency : dependencies)
+		stages_[dependency].dependents.push_back(id);
+	return id;
+}
+
+void TaskGraph::Schedule(TaskScheduler &scheduler, TaskGroup &group, const StageId id)
+{
+	auto RunStage = [this, &scheduler, &group, id]()
+	{
+		Stage &stage = stages_[id];
+		stage.work();
+
+		// the last dependency to finish releases a dependent
+		for (const StageId dependent : stage.dependents)
+		{
+			if (stages_[dependent].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(scheduler, group, dependent);
+		}
+	};
+	scheduler.Submit(group, RunStage);
+}
+
+void TaskGraph::Run(TaskScheduler &scheduler)
+{
+	for (Stage &stage : stages_)
+		stage.remaining.store(stage.dependencyCount, std::memory_order_relaxed);
+
+	TaskGroup group;
+	for (StageId id = 0; id < stages_.size(); ++id)
+	{
+		if (stages_[id].dependencyCount == 0)
+			Schedule(scheduler, group, id);
+	}
+	scheduler.Wait(group);
+}
@@ -2,9 +2,27 @@
 #include "gl/GLBackend.h"
 
 #include <algorithm>
+#include <memory>
 
+#include "game/Asteroids.h"
+#include "game/RenderSnapshot.h"
+#include "gl/GLEntity.h"
+#include "gl/InstancedRenderer.h"
+#include "gl/Mat4.h"
+
+using asteroids::Asteroids;
 using asteroids::GL;
 using asteroids::GLBackend;
+using asteroids::InstancedRenderer;
+using asteroids::Mat4;
+using asteroids::RenderSnapshot;
+using asteroids::WorldBounds;
+
+namespace
+{
+const GLfloat ORTHO_NEAR = 10.0f;
+const GLfloat ORTHO_FAR = -10.0f;
+} // end namespace
 
 std::unique_ptr<GL> GL::instance_ = nullptr;
 
@@ -21,13 +39,48 @@ GL::~GL() noexcept = default;
 
 GL::GL() = default;
 
-void GL::InitOpenGLFunctions()
+bool GL::InitOpenGLFunctions(const bool coreProfile)
 {
 	// Qt Initialize OpenGL Functions
 	initializeOpenGLFunctions();
 
+	auto renderer = std::make_unique<InstancedRenderer>();
+	if (renderer->Initialize())
+		instancedRenderer_ = std::move(renderer);
+	else if (coreProfile)
+		// a core profile has no fixed function pipeline to fall back to
+		return false;
+
+	InitServer();
+	if (!instancedRenderer_)
+		InitClient();
+	return true;
+}
+
+void GL::RestoreState()
+{
+	// the paint engine leaves its own capabilities enabled
+	glDisable(GL_BLEND);
 	InitServer();
-	InitClient();
+}
+
+WorldBounds GL::GetBounds() const
+{
+	return bounds_;
+}
+
+GLint GL::GetScore() const
+{
+	return score_;
+}
+
+void GL::Draw(const RenderSnapshot &snapshot)
+{
+	score_ = snapshot.score;
+	if (instancedRenderer_)
+		instancedRenderer_->Draw(snapshot);
+	else
+		Asteroids::DrawSnapshot(snapshot);
 }
 
 void GL::DisplayClear()
@@ -43,15 +96,19 @@ void GL::DisplayFlush()
 void GL::InitServer()
 {
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-	glShadeModel(GL_SMOOTH);
 	glEnable(GL_SCISSOR_TEST);
 	glEnable(GL_DEPTH_TEST);
 	glDepthRange(0, 1);
-	glEnable(GL_AUTO_NORMAL);
-	glEnable(GL_NORMALIZE);
 	glFrontFace(GL_CCW);
 	glEnable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
+
+	// fixed function state does not exist in a core profile
+	if (instancedRenderer_)
+		return;
+	glShadeModel(GL_SMOOTH);
+	glEnable(GL_AUTO_NORMAL);
+	glEnable(GL_NORMALIZE);
 }
 
 void GL::InitClient() const
@@ -67,15 +124,17 @@ void GL::Reshape(const int _w, const int _h)
 	// define pixel clipping zone
 	glScissor(0, 0, _w, _h);
 	/*========================= ORTHO PROJECTION =============================*/
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
+	bounds_ = WorldBounds::FromViewport(_w, _h);
+	const Mat4 projection = Mat4::Ortho(-bounds_.right, bounds_.right, -bounds_.top, bounds_.top, ORTHO_NEAR, ORTHO_FAR);
 
-	if (_w <= _h)
-		glOrtho(-10.0, 10.0, -10.0 * (static_cast<GLfloat>(_h) / static_cast<GLfloat>(_w)),
-				10.0 * (static_cast<GLfloat>(_h) / static_cast<GLfloat>(_w)), 10, -10);
-	else
-		glOrtho(-10.0 * (static_cast<GLfloat>(_w) / static_cast<GLfloat>(_h)),
-				10.0 * (static_cast<GLfloat>(_w) / static_cast<GLfloat>(_h)), -10.0, 10.0, 10, -10);
+	if (instancedRenderer_)
+	{
+		instancedRenderer_->SetProjection(projection);
+		return;
+	}
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadMatrixf(projection.Data());
 
 	/*========================= REDISPLAY ====================================*/
 	glMatrixMode(GL_MODELVIEW);
@@ -1,28 +1,51 @@
 #include "gl/GLBackend.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 
+#include <QColor>
+#include <QCoreApplication>
+#include <QFontDatabase>
 #include <QKeyEvent>
+#include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QOpenGLWidget>
+#include <QPainter>
+#include <QRect>
+#include <QString>
+#include <QSurfaceFormat>
 #include <QTimer>
 
+#include "game/FrameTimings.h"
 #include "gl/GL.h"
 #include "gl/GLBackendEmitters.h"
 
+using asteroids::FrameTimings;
 using asteroids::GL;
 using asteroids::GLBackend;
 using asteroids::GLBackendEmitters;
+using asteroids::ScopedTimer;
+using asteroids::StageTiming;
+using asteroids::TimedStage;
 using events::EventEmitter;
 
 namespace
 {
-static constexpr int FRAME_MS = 20;
 const int NUMBER_KEYS = 256;
 const std::string ASTEROIDS_TITLE = "Asteroids";
+
+const char TIMINGS_KEY = 'p';
+const int INFO_MARGIN = 10;
+const QColor INFO_COLOR = QColor::fromRgbF(0.0f, 1.0f, 1.0f);
+const std::string RESET = "Press X to RESET";
+const std::string SCORE = "SCORE: ";
+
+FrameTimings *const Timings = FrameTimings::GetInstance();
 } // end namespace
 
 GLBackend::~GLBackend() noexcept = default;
@@ -41,6 +64,12 @@ GLBackend::GLBackend() : QOpenGLWidget(),
 	// connect QTimer to repaint
 	connect(frameTimer_.get(), &QTimer::timeout, this, &GLBackend::onFrame);
 
+	// request a core profile for the instanced renderer; GL only falls back to the fixed function pipeline when the platform hands out a non-core context
+	QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+	format.setVersion(3, 3);
+	format.setProfile(QSurfaceFormat::CoreProfile);
+	setFormat(format);
+
 	// initialize the window
 	setWindowTitle(QString::fromStdString(ASTEROIDS_TITLE));
 	setGeometry(INIT_WIN_X, INIT_WIN_Y, WIN_WIDTH, WIN_HEIGHT);
@@ -59,7 +88,15 @@ GLBackendEmitters &GLBackend::GetEmitters()
 
 void GLBackend::initializeGL()
 {
-	GL::Get().InitOpenGLFunctions();
+	const bool coreProfile = context()->format().profile() == QSurfaceFormat::CoreProfile;
+	if (!GL::Get().InitOpenGLFunctions(coreProfile))
+	{
+		// nothing can be drawn, so quit rather than show a blank window
+		std::cerr << "The instanced renderer failed to initialize in an OpenGL core profile context" << std::endl;
+		rendererFailed_ = true;
+		QCoreApplication::exit(EXIT_FAILURE);
+		return;
+	}
 
 	// make sure we can actually receive key events:
 	setFocusPolicy(Qt::StrongFocus);
@@ -77,18 +114,57 @@ void GLBackend::onFrame()
 
 void GLBackend::paintGL()
 {
+	if (rendererFailed_)
+		return;
+
+	ScopedTimer frameTimer(TimedStage::FRAME);
 	KeyboardUpdateState();
 
 	GL &gl = GL::Get();
-	gl.DisplayClear();
+	{
+		ScopedTimer drawTimer(TimedStage::DRAW);
+		gl.DisplayClear();
+
+		emitters_.GetDrawEmitter()->Signal()();
 
-	emitters_.GetDrawEmitter()->Signal()();
+		gl.DisplayFlush();
+	}
 
-	gl.DisplayFlush();
+	DrawGameInfo();
+}
+
+void GLBackend::DrawGameInfo()
+{
+	QPainter painter(this);
+	painter.setPen(INFO_COLOR);
+	painter.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+	const QRect area = rect().adjusted(INFO_MARGIN, INFO_MARGIN, -INFO_MARGIN, -INFO_MARGIN);
+	painter.drawText(area, Qt::AlignLeft | Qt::AlignTop, QString::fromStdString(SCORE + std::to_string(GL::Get().GetScore())));
+	painter.drawText(area, Qt::AlignRight | Qt::AlignBottom, QString::fromStdString(RESET));
+
+	if (timingsVisible_)
+	{
+		QString timings = QString::asprintf("%-12s %8s %8s %8s %8s\n", "ms", "p50", "p95", "p99", "max");
+		for (size_t stage = 0; stage < static_cast<size_t>(TimedStage::COUNT); ++stage)
+		{
+			const std::string_view name = FrameTimings::Name(static_cast<TimedStage>(stage));
+			const StageTiming timing = Timings->Summarize(static_cast<TimedStage>(stage));
+			timings += QString::asprintf("%-12.*s %8.2f %8.2f %8.2f %8.2f\n", static_cast<int>(name.size()), name.data(), timing.p50, timing.p95, timing.p99, timing.max);
+		}
+		// below the score
+		painter.drawText(area.adjusted(0, 2 * painter.fontMetrics().lineSpacing(), 0, 0), Qt::AlignLeft | Qt::AlignTop, timings);
+	}
+
+	painter.end();
+	GL::Get().RestoreState();
 }
 
 void GLBackend::resizeGL(const int _w, const int _h)
 {
+	if (rendererFailed_)
+		return;
+
 	// Qt’s backing FBO is actually (w * DPR) × (h * DPR)
 	const qreal dpr = devicePixelRatioF(); // typically 2.0 on Retina
 
@@ -104,6 +180,10 @@ void GLBackend::keyPressEvent(QKeyEvent *event)
 	{
 		unsigned char c = txt.at(0).toLatin1();
 		keysPressed_[c] = true;
+
+		// the overlay toggles once per press rather than every frame the key is held
+		if (c == TIMINGS_KEY && !event->isAutoRepeat())
+			timingsVisible_ = !timingsVisible_;
 	}
 }
 
@@ -8,27 +8,28 @@
 
 #include <boost/property_tree/ptree.hpp>
 
-#include "DatabaseAdapters/IPersistableResource.h"
-#include "DatabaseAdapters/ResourceLoader.h"
-#include "DatabaseAdapters/ResourcePersister.h"
 #include "FilesystemAdapters/EntityDeserializer.h"
-#include "FilesystemAdapters/ISerializableResource.h"
-#include "FilesystemAdapters/ResourceDeserializer.h"
 #include "FilesystemAdapters/ResourceSerializer.h"
 #include "test_filesystem_adapters/ContainerResource2D.h"
 
 #include "configuration/filesystem.hpp"
 #include "configuration/serialization.h"
+#include "game/BlobStore.h"
+#include "game/RestoreQueue.h"
+#include "game/SaveDatabase.h"
+#include "game/SaveJournal.h"
 
+using asteroids::BlobStore;
 using asteroids::GLEntity;
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+using asteroids::RestoreQueue;
+using asteroids::SaveDatabase;
+using asteroids::SaveJournal;
+using asteroids::WorldBounds;
 using boost::property_tree::ptree;
-using database_adapters::IPersistableResource;
-using database_adapters::ResourceLoader;
-using database_adapters::ResourcePersister;
 using entity::Entity;
 using filesystem_adapters::EntityDeserializer;
-using filesystem_adapters::ISerializableResource;
-using filesystem_adapters::ResourceDeserializer;
 using filesystem_adapters::ResourceSerializer;
 
 using Resource2DGLfloat = ContainerResource2D<GLfloat>;
@@ -43,68 +44,21 @@ const std::string R_KEY = "R";
 const std::string VELOCITY_ANGLE_KEY = "velocity_angle";
 const std::string SPEED_KEY = "speed";
 const std::string MASS_KEY = "mass";
+const GLfloat ORTHO_HALF_EXTENT = 10.0f;
 
-auto RES2D_GLFLOAT_CONSTRUCTOR_S = []() -> std::unique_ptr<ISerializableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
-auto RES2D_GLFLOAT_CONSTRUCTOR_T = []() -> std::unique_ptr<IPersistableResource>
-{ return std::make_unique<Resource2DGLfloat>(); };
 } // end namespace
 
-GLEntity::GLEntity() : frame_(Resource2DGLfloat({{0.0, 0.0, 0.0, 0.0}, // NOTE: make sure frame_ appears first in the class
-												 {0.0, 0.0, 0.0, 0.0},
-												 {0.0, 0.0, 0.0, 0.0},
-												 {0.0, 0.0, 0.0, 0.0}})),
-					   unitVelocity_(frame_),
-					   S_(frame_),
-					   R_(frame_),
-					   T_(frame_)
-
+WorldBounds WorldBounds::FromViewport(const int _w, const int _h)
 {
+	if (_w <= _h)
+		return WorldBounds{ORTHO_HALF_EXTENT, ORTHO_HALF_EXTENT * (static_cast<GLfloat>(_h) / static_cast<GLfloat>(_w))};
+	return WorldBounds{ORTHO_HALF_EXTENT * (static_cast<GLfloat>(_w) / static_cast<GLfloat>(_h)), ORTHO_HALF_EXTENT};
 }
 
-GLEntity::GLEntity(
-	Resource2DGLfloat frame,
-	Resource2DGLfloat unitVelocity) : frame_(std::move(frame)),
-									  unitVelocity_(std::move(unitVelocity)),
-									  S_(Resource2DGLfloat({{0.0, 0.0, 0.0, 0.0}, // NOTE: make sure S_ appears first in the class
-															{0.0, 0.0, 0.0, 0.0},
-															{0.0, 0.0, 0.0, 0.0},
-															{0.0, 0.0, 0.0, 0.0}})),
-									  T_(S_), R_(S_)
-{
-}
+GLEntity::GLEntity() = default;
 
-void GLEntity::RegisterSerializationResources(const std::string_view key)
+GLEntity::GLEntity(const Mat4 &frame, const Mat4 &unitVelocity) : frame_(frame), unitVelocity_(unitVelocity)
 {
-	ResourceDeserializer *deserializer = ResourceDeserializer::GetInstance();
-
-	if (!deserializer->HasSerializationKey(UNIT_VELOCITY_KEY))
-		deserializer->RegisterResource<GLfloat>(UNIT_VELOCITY_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(FRAME_KEY))
-		deserializer->RegisterResource<GLfloat>(FRAME_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(S_KEY))
-		deserializer->RegisterResource<GLfloat>(S_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(R_KEY))
-		deserializer->RegisterResource<GLfloat>(R_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-	if (!deserializer->HasSerializationKey(T_KEY))
-		deserializer->RegisterResource<GLfloat>(T_KEY, RES2D_GLFLOAT_CONSTRUCTOR_S);
-}
-
-void GLEntity::RegisterPersistenceResources(const std::string_view resourceKey)
-{
-	ResourceLoader *loader = ResourceLoader::GetInstance();
-
-	const std::string key(resourceKey);
-	if (!loader->HasPersistenceKey(FormatKey(key + UNIT_VELOCITY_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + UNIT_VELOCITY_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + FRAME_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + FRAME_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + S_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + S_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + R_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + R_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
-	if (!loader->HasPersistenceKey(FormatKey(key + T_KEY)))
-		loader->RegisterResource<GLfloat>(FormatKey(key + T_KEY), RES2D_GLFLOAT_CONSTRUCTOR_T);
 }
 
 GLEntity::~GLEntity() noexcept = default;
@@ -117,12 +71,12 @@ void GLEntity::Draw()
 {
 }
 
-Resource2DGLfloat &GLEntity::GetFrame()
+Mat4Resource &GLEntity::GetFrame()
 {
 	return frame_;
 }
 
-Resource2DGLfloat &GLEntity::GetUnitVelocity()
+Mat4Resource &GLEntity::GetUnitVelocity()
 {
 	return unitVelocity_;
 }
@@ -142,17 +96,17 @@ GLfloat GLEntity::GetVelocityAngle() const
 	return velocityAngle_;
 }
 
-const Resource2DGLfloat &GLEntity::SMatrix() const
+const Mat4Resource &GLEntity::SMatrix() const
 {
 	return S_;
 }
 
-const Resource2DGLfloat &GLEntity::TMatrix() const
+const Mat4Resource &GLEntity::TMatrix() const
 {
 	return T_;
 }
 
-const Resource2DGLfloat &GLEntity::RMatrix() const
+const Mat4Resource &GLEntity::RMatrix() const
 {
 	return R_;
 }
@@ -162,9 +116,9 @@ void GLEntity::SetFrame(const int i, const int j, const GLfloat val)
 	frame_.GetData(i, j) = val;
 }
 
-void GLEntity::SetFrame(const Resource2DGLfloat &frame)
+void GLEntity::SetFrame(const Mat4 &frame)
 {
-	frame_ = frame;
+	frame_.Set(frame);
 }
 
 void GLEntity::SetUnitVelocity(const int i, const int j, const GLfloat val)
@@ -172,9 +126,9 @@ void GLEntity::SetUnitVelocity(const int i, const int j, const GLfloat val)
 	unitVelocity_.GetData(i, j) = val;
 }
 
-void GLEntity::SetUnitVelocity(const Resource2DGLfloat &unitVelocity)
+void GLEntity::SetUnitVelocity(const Mat4 &unitVelocity)
 {
-	unitVelocity_ = unitVelocity;
+	unitVelocity_.Set(unitVelocity);
 }
 
 void GLEntity::SetSpeed(const GLfloat speed)
@@ -192,6 +146,64 @@ void GLEntity::SetVelocityAngle(const GLfloat velocityAngle)
 	velocityAngle_ = velocityAngle;
 }
 
+void GLEntity::SetMotionMatrices()
+{
+	S_.Set(Mat4::Scale(speed_));
+	T_.Set(Mat4::Translation(frame_.GetData(0, 0), frame_.GetData(1, 0), frame_.GetData(2, 0)));
+}
+
+void GLEntity::Move()
+{
+	/*======================= p = av + frame =============================*/
+	// The same product the GL matrix stack used to compute, minus the glGetFloatv readback.
+	frame_.Set(T_.Get() * (S_.Get() * unitVelocity_.Get()));
+}
+
+void GLEntity::WrapAround(const WorldBounds &bounds, const GLfloat epsilon)
+{
+	GLfloat x = frame_.GetData(0, 0);
+	GLfloat y = frame_.GetData(1, 0);
+	if (WrapAround(x, y, bounds, epsilon))
+	{
+		SetFrame(0, 0, x);
+		SetFrame(1, 0, y);
+	}
+}
+
+bool GLEntity::WrapAround(GLfloat &x, GLfloat &y, const WorldBounds &bounds, const GLfloat epsilon)
+{
+	const GLfloat right = bounds.right;
+	const GLfloat left = -1 * right;
+	const GLfloat top = bounds.top;
+	const GLfloat bottom = -1 * top;
+
+	if (x <= left - epsilon)
+	{
+		x = right + epsilon;
+		y *= -1;
+	}
+	else if (x >= right + epsilon)
+	{
+		x = left - epsilon;
+		y *= -1;
+	}
+	else if (y >= top + epsilon)
+	{
+		y = bottom - epsilon;
+		x *= -1;
+	}
+	else if (y <= bottom - epsilon)
+	{
+		y = top + epsilon;
+		x *= -1;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
 Entity::SharedEntity &GLEntity::GetAggregatedMember(const Entity::Key &key) const
 {
 	return Entity::GetAggregatedMember(key);
@@ -204,12 +216,20 @@ void GLEntity::Save(ptree &tree, const std::string &path) const
 	tree.put(MASS_KEY, mass_);
 
 	ResourceSerializer *serializer = ResourceSerializer::GetInstance();
-
-	serializer->Serialize(unitVelocity_.Lock(), UNIT_VELOCITY_KEY, path);
-	serializer->Serialize(frame_.Lock(), FRAME_KEY, path);
-	serializer->Serialize(S_.Lock(), S_KEY, path);
-	serializer->Serialize(R_.Lock(), R_KEY, path);
-	serializer->Serialize(T_.Lock(), T_KEY, path);
+	SaveJournal *journal = SaveJournal::GetInstance();
+
+	// resources left unchanged since the last save or load are already on disk
+	auto SerializeChanged = [&](const Mat4Resource &resource, const std::string &resourceKey)
+	{
+		if (journal->Changed(GetKey(), resourceKey, BlobStore::Hash(resource)))
+			serializer->Serialize(resource.ToResource().Lock(), resourceKey, path);
+	};
+
+	SerializeChanged(unitVelocity_, UNIT_VELOCITY_KEY);
+	SerializeChanged(frame_, FRAME_KEY);
+	SerializeChanged(S_, S_KEY);
+	SerializeChanged(R_, R_KEY);
+	SerializeChanged(T_, T_KEY);
 }
 
 void GLEntity::Load(ptree &tree, const std::string &path)
@@ -218,18 +238,7 @@ void GLEntity::Load(ptree &tree, const std::string &path)
 	speed_ = std::stof(tree.get_child(SPEED_KEY).data());
 	mass_ = std::stof(tree.get_child(MASS_KEY).data());
 
-	ResourceDeserializer *deserializer = ResourceDeserializer::GetInstance();
-
-	std::unique_ptr<ISerializableResource> deserializedUnitVelocity = deserializer->Deserialize(UNIT_VELOCITY_KEY, path);
-	unitVelocity_ = *static_cast<Resource2DGLfloat *>(deserializedUnitVelocity.get());
-	std::unique_ptr<ISerializableResource> deserializedFrame = deserializer->Deserialize(FRAME_KEY, path);
-	frame_ = *static_cast<Resource2DGLfloat *>(deserializedFrame.get());
-	std::unique_ptr<ISerializableResource> deserializedS = deserializer->Deserialize(S_KEY, path);
-	S_ = *static_cast<Resource2DGLfloat *>(deserializedS.get());
-	std::unique_ptr<ISerializableResource> deserializedR = deserializer->Deserialize(R_KEY, path);
-	R_ = *static_cast<Resource2DGLfloat *>(deserializedR.get());
-	std::unique_ptr<ISerializableResource> deserializedT = deserializer->Deserialize(T_KEY, path);
-	T_ = *static_cast<Resource2DGLfloat *>(deserializedT.get());
+	DeferMatrices(path);
 }
 
 void GLEntity::Save(boost::property_tree::ptree &tree, database_adapters::Sqlite &database) const
@@ -237,14 +246,6 @@ void GLEntity::Save(boost::property_tree::ptree &tree, database_adapters::Sqlite
 	tree.put(VELOCITY_ANGLE_KEY, velocityAngle_);
 	tree.put(SPEED_KEY, speed_);
 	tree.put(MASS_KEY, mass_);
-
-	ResourcePersister *persister = ResourcePersister::GetInstance();
-
-	persister->Persist(unitVelocity_, FormatKey(GetKey() + UNIT_VELOCITY_KEY));
-	persister->Persist(frame_, FormatKey(GetKey() + FRAME_KEY));
-	persister->Persist(S_, FormatKey(GetKey() + S_KEY));
-	persister->Persist(R_, FormatKey(GetKey() + R_KEY));
-	persister->Persist(T_, FormatKey(GetKey() + T_KEY));
 }
 
 void GLEntity::Load(boost::property_tree::ptree &tree, database_adapters::Sqlite &database)
@@ -253,16 +254,35 @@ void GLEntity::Load(boost::property_tree::ptree &tree, database_adapters::Sqlite
 	speed_ = std::stof(tree.get_child(SPEED_KEY).data());
 	mass_ = std::stof(tree.get_child(MASS_KEY).data());
 
-	ResourceLoader *loader = ResourceLoader::GetInstance();
-
-	std::unique_ptr<IPersistableResource> deserializedUnitVelocity = loader->Load(FormatKey(GetKey() + UNIT_VELOCITY_KEY));
-	unitVelocity_ = *static_cast<Resource2DGLfloat *>(deserializedUnitVelocity.get());
-	std::unique_ptr<IPersistableResource> deserializedFrame = loader->Load(FormatKey(GetKey() + FRAME_KEY));
-	frame_ = *static_cast<Resource2DGLfloat *>(deserializedFrame.get());
-	std::unique_ptr<IPersistableResource> deserializedS = loader->Load(FormatKey(GetKey() + S_KEY));
-	S_ = *static_cast<Resource2DGLfloat *>(deserializedS.get());
-	std::unique_ptr<IPersistableResource> deserializedR = loader->Load(FormatKey(GetKey() + R_KEY));
-	R_ = *static_cast<Resource2DGLfloat *>(deserializedR.get());
-	std::unique_ptr<IPersistableResource> deserializedT = loader->Load(FormatKey(GetKey() + T_KEY));
-	T_ = *static_cast<Resource2DGLfloat *>(deserializedT.get());
+	DeferMatrices(std::string());
+}
+
+void GLEntity::PersistMatrices() const
+{
+	SaveDatabase *store = SaveDatabase::GetInstance();
+	SaveJournal *journal = SaveJournal::GetInstance();
+
+	// resources left unchanged since the last save or load are already in the database
+	auto PersistChanged = [&](const Mat4Resource &resource, const std::string &resourceKey)
+	{
+		if (journal->Changed(GetKey(), resourceKey, BlobStore::Hash(resource)))
+			store->Persist(FormatKey(GetKey() + resourceKey), resource);
+	};
+
+	PersistChanged(unitVelocity_, UNIT_VELOCITY_KEY);
+	PersistChanged(frame_, FRAME_KEY);
+	PersistChanged(S_, S_KEY);
+	PersistChanged(R_, R_KEY);
+	PersistChanged(T_, T_KEY);
+}
+
+void GLEntity::DeferMatrices(const std::string &path)
+{
+	RestoreQueue *restore = RestoreQueue::GetInstance();
+
+	restore->Defer(unitVelocity_, GetKey(), UNIT_VELOCITY_KEY, path);
+	restore->Defer(frame_, GetKey(), FRAME_KEY, path);
+	restore->Defer(S_, GetKey(), S_KEY, path);
+	restore->Defer(R_, GetKey(), R_KEY, path);
+	restore->Defer(T_, GetKey(), T_KEY, path);
 }
@@ -0,0 +1,249 @@
+#include "gl/InstancedRenderer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QSurfaceFormat>
+
+#include "game/EntityStore.h"
+#include "game/MeshRegistry.h"
+#include "game/RenderSnapshot.h"
+#include "gl/Mat4.h"
+
+using asteroids::InstancedRenderer;
+using asteroids::Mat4;
+using asteroids::MeshGeometry;
+using asteroids::MeshId;
+using asteroids::MeshRegistry;
+using asteroids::RenderSnapshot;
+using asteroids::State;
+
+namespace
+{
+const GLuint POSITION_ATTRIBUTE = 0;
+const GLuint TRANSFORM_ATTRIBUTE = 1;
+const GLuint COLOR_ATTRIBUTE = 2;
+const size_t MIN_INSTANCE_CAPACITY = 1024;
+
+const char *VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 transform;
+layout(location = 2) in vec3 color;
+uniform mat4 projection;
+out vec3 vertexColor;
+void main()
+{
+	float c = cos(transform.w);
+	float s = sin(transform.w);
+	vec2 rotated = vec2(c * position.x - s * position.y, s * position.x + c * position.y);
+	gl_Position = projection * vec4(rotated + transform.xy, position.z + transform.z, 1.0);
+	vertexColor = color;
+}
+)";
+
+const char *FRAGMENT_SHADER = R"(#version 330 core
+in vec3 vertexColor;
+out vec4 fragmentColor;
+void main()
+{
+	fragmentColor = vec4(vertexColor, 1.0);
+}
+)";
+
+// quad meshes are drawn by the core profile as two triangles per quad
+std::vector<GLubyte> QuadsToTriangles(const MeshGeometry &mesh)
+{
+	std::vector<GLubyte> triangles;
+	triangles.reserve(MeshGeometry::INDEX_COUNT / 4 * 6);
+	for (size_t quad = 0; quad + 3 < MeshGeometry::INDEX_COUNT; quad += 4)
+	{
+		const GLubyte *corners = mesh.indices.data() + quad;
+		triangles.insert(triangles.end(), {corners[0], corners[1], corners[2]});
+		triangles.insert(triangles.end(), {corners[0], corners[2], corners[3]});
+	}
+	return triangles;
+}
+
+size_t Index(const MeshId id)
+{
+	return static_cast<size_t>(id);
+}
+} // end namespace
+
+InstancedRenderer::InstancedRenderer() = default;
+
+InstancedRenderer::~InstancedRenderer() noexcept = default;
+
+bool InstancedRenderer::Initialize()
+{
+	const QOpenGLContext *context = QOpenGLContext::currentContext();
+	if (!context || context->isOpenGLES() || context->format().version() < qMakePair(3, 3))
+		return false;
+
+	initializeOpenGLFunctions();
+
+	const GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+	const GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+	if (!vertexShader || !fragmentShader)
+	{
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return false;
+	}
+
+	program_ = glCreateProgram();
+	glAttachShader(program_, vertexShader);
+	glAttachShader(program_, fragmentShader);
+	glLinkProgram(program_);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program_, GL_LINK_STATUS, &linked);
+	if (linked != GL_TRUE)
+	{
+		glDeleteProgram(program_);
+		program_ = 0;
+		return false;
+	}
+	projectionLocation_ = glGetUniformLocation(program_, "projection");
+
+	instances_.Initialize(GL_ARRAY_BUFFER, MIN_INSTANCE_CAPACITY * sizeof(Instance));
+
+	for (size_t mesh = 0; mesh < MeshRegistry::MESH_COUNT; ++mesh)
+		UploadMesh(static_cast<MeshId>(mesh));
+
+	glBindVertexArray(0);
+	return true;
+}
+
+void InstancedRenderer::SetProjection(const Mat4 &projection)
+{
+	projection_ = projection;
+}
+
+GLuint InstancedRenderer::CompileShader(const GLenum type, const char *source)
+{
+	const GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, nullptr);
+	glCompileShader(shader);
+
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled != GL_TRUE)
+	{
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+void InstancedRenderer::UploadMesh(const MeshId id)
+{
+	const MeshGeometry &geometry = MeshRegistry::Get(id);
+	const bool quads = geometry.mode == GL_QUADS;
+	const std::vector<GLubyte> indices = quads ? QuadsToTriangles(geometry)
+											   : std::vector<GLubyte>(geometry.indices.begin(), geometry.indices.end());
+
+	Mesh &mesh = meshes_[Index(id)];
+	mesh.mode = quads ? GL_TRIANGLES : geometry.mode;
+	mesh.indexCount = static_cast<GLsizei>(indices.size());
+
+	glGenVertexArrays(1, &mesh.vertexArray);
+	glBindVertexArray(mesh.vertexArray);
+
+	glGenBuffers(1, &mesh.vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(geometry.vertices), geometry.vertices.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), nullptr);
+	glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+
+	glGenBuffers(1, &mesh.indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLubyte), indices.data(), GL_STATIC_DRAW);
+
+	// the instance attributes advance once per instance; DrawMesh points them at the mesh's instances
+	glEnableVertexAttribArray(TRANSFORM_ATTRIBUTE);
+	glVertexAttribDivisor(TRANSFORM_ATTRIBUTE, 1);
+	glEnableVertexAttribArray(COLOR_ATTRIBUTE);
+	glVertexAttribDivisor(COLOR_ATTRIBUTE, 1);
+}
+
+void InstancedRenderer::CountInstances(const RenderSnapshot &snapshot)
+{
+	offsets_.fill(0);
+	for (const State state : snapshot.rockState)
+		++offsets_[Index(MeshRegistry::RockMesh(state)) + 1];
+	if (snapshot.hasShip)
+	{
+		offsets_[Index(MeshId::SHIP) + 1] = 1;
+		offsets_[Index(MeshId::BULLET) + 1] = snapshot.bulletX.size();
+	}
+
+	for (size_t mesh = 1; mesh <= MeshRegistry::MESH_COUNT; ++mesh)
+		offsets_[mesh] += offsets_[mesh - 1];
+}
+
+void InstancedRenderer::WriteInstances(const RenderSnapshot &snapshot, Instance *instances) const
+{
+	// rocks are scattered to their mesh's range in a single pass over the snapshot
+	std::array<size_t, MeshRegistry::MESH_COUNT> next;
+	std::copy(offsets_.begin(), offsets_.end() - 1, next.begin());
+	for (size_t rock = 0; rock < snapshot.rockX.size(); ++rock)
+		instances[next[Index(MeshRegistry::RockMesh(snapshot.rockState[rock]))]++] = {snapshot.rockX[rock], snapshot.rockY[rock], 0.0f, snapshot.rockSpin[rock], 1.0f, 1.0f, 1.0f};
+
+	if (!snapshot.hasShip)
+		return;
+
+	instances[offsets_[Index(MeshId::SHIP)]] = {snapshot.shipX, snapshot.shipY, snapshot.shipZ, snapshot.shipOrientation, 0.0f, 1.0f, 0.0f};
+
+	Instance *bullets = instances + offsets_[Index(MeshId::BULLET)];
+	for (size_t bullet = 0; bullet < snapshot.bulletX.size(); ++bullet)
+		bullets[bullet] = {snapshot.bulletX[bullet], snapshot.bulletY[bullet], 0.0f, snapshot.bulletAngle[bullet], 0.0f, 1.0f, 1.0f};
+}
+
+void InstancedRenderer::Draw(const RenderSnapshot &snapshot)
+{
+	CountInstances(snapshot);
+	const size_t count = offsets_[MeshRegistry::MESH_COUNT];
+	if (count == 0)
+		return;
+
+	WriteInstances(snapshot, static_cast<Instance *>(instances_.Begin(count * sizeof(Instance))));
+	const size_t base = instances_.End();
+
+	glUseProgram(program_);
+	glUniformMatrix4fv(projectionLocation_, 1, GL_FALSE, projection_.Data());
+
+	for (size_t mesh = 0; mesh < MeshRegistry::MESH_COUNT; ++mesh)
+		DrawMesh(static_cast<MeshId>(mesh), base);
+
+	instances_.Fence();
+
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+void InstancedRenderer::DrawMesh(const MeshId id, const size_t base)
+{
+	const size_t first = offsets_[Index(id)];
+	const size_t count = offsets_[Index(id) + 1] - first;
+	if (count == 0)
+		return;
+
+	const Mesh &mesh = meshes_[Index(id)];
+	glBindVertexArray(mesh.vertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, instances_.Buffer());
+
+	const size_t offset = base + first * sizeof(Instance);
+	glVertexAttribPointer(TRANSFORM_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+						  reinterpret_cast<const void *>(offset + offsetof(Instance, x)));
+	glVertexAttribPointer(COLOR_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(Instance),
+						  reinterpret_cast<const void *>(offset + offsetof(Instance, r)));
+
+	glDrawElementsInstanced(mesh.mode, mesh.indexCount, GL_UNSIGNED_BYTE, nullptr, static_cast<GLsizei>(count));
+}
@@ -0,0 +1,64 @@
+#include "gl/Mat4Resource.h"
+
+#include <vector>
+
+#include "test_filesystem_adapters/ContainerResource2D.h"
+
+#include "gl/Mat4.h"
+
+using asteroids::Mat4;
+using asteroids::Mat4Resource;
+
+using Resource2DGLfloat = ContainerResource2D<GLfloat>;
+
+Mat4Resource::Mat4Resource(const Mat4 &matrix) : matrix_(matrix)
+{
+}
+
+GLfloat &Mat4Resource::GetData(const int i, const int j)
+{
+	dirty_ = true;
+	return matrix_(i, j);
+}
+
+GLfloat Mat4Resource::GetData(const int i, const int j) const
+{
+	return matrix_(i, j);
+}
+
+const Mat4 &Mat4Resource::Get() const
+{
+	return matrix_;
+}
+
+void Mat4Resource::Set(const Mat4 &matrix)
+{
+	matrix_ = matrix;
+	dirty_ = true;
+}
+
+bool Mat4Resource::GetDirty() const
+{
+	return dirty_;
+}
+
+Resource2DGLfloat Mat4Resource::ToResource() const
+{
+	std::vector<std::vector<GLfloat>> rows(4, std::vector<GLfloat>(4));
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j)
+			rows[i][j] = matrix_(i, j);
+	return Resource2DGLfloat(rows);
+}
+
+void Mat4Resource::Assign(const Resource2DGLfloat &resource)
+{
+	matrix_ = Mat4::FromRows(static_cast<const GLfloat *>(resource.Data()));
+	dirty_ = false;
+}
+
+void Mat4Resource::Assign(const Mat4 &matrix)
+{
+	matrix_ = matrix;
+	dirty_ = false;
+}
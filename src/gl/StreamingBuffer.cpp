@@ -0,0 +1,135 @@
+#include "gl/StreamingBuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QSurfaceFormat>
+
+using asteroids::StreamingBuffer;
+
+namespace
+{
+// ARB_buffer_storage flags, which the OpenGL ES 3 headers behind QOpenGLExtraFunctions lack
+const GLbitfield MAP_PERSISTENT_BIT = 0x0040;
+const GLbitfield MAP_COHERENT_BIT = 0x0080;
+const GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | MAP_PERSISTENT_BIT | MAP_COHERENT_BIT;
+
+const size_t REGION_ALIGNMENT = 256;
+const GLuint64 WAIT_TIMEOUT_NS = 1000000;
+} // end namespace
+
+StreamingBuffer::StreamingBuffer() = default;
+
+StreamingBuffer::~StreamingBuffer() noexcept = default;
+
+void StreamingBuffer::Initialize(const GLenum target, const size_t regionBytes)
+{
+	initializeOpenGLFunctions();
+	target_ = target;
+
+	const QOpenGLContext *context = QOpenGLContext::currentContext();
+	if (context && (context->format().version() >= qMakePair(4, 4) || context->hasExtension("GL_ARB_buffer_storage")))
+		bufferStorage_ = reinterpret_cast<BufferStorage>(context->getProcAddress("glBufferStorage"));
+
+	Allocate(regionBytes);
+}
+
+bool StreamingBuffer::IsPersistent() const
+{
+	return mapped_ != nullptr;
+}
+
+GLuint StreamingBuffer::Buffer() const
+{
+	return buffer_;
+}
+
+void *StreamingBuffer::Begin(const size_t bytes)
+{
+	if (bytes > regionBytes_)
+		Allocate(std::max(bytes, regionBytes_ * 2));
+	pendingBytes_ = bytes;
+
+	if (!mapped_)
+		return staging_.data();
+
+	Wait(region_);
+	return mapped_ + region_ * regionBytes_;
+}
+
+size_t StreamingBuffer::End()
+{
+	glBindBuffer(target_, buffer_);
+	if (mapped_)
+		return region_ * regionBytes_;
+
+	// orphan the storage which earlier frames may still draw from
+	glBufferData(target_, regionBytes_, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(target_, 0, pendingBytes_, staging_.data());
+	return 0;
+}
+
+void StreamingBuffer::Fence()
+{
+	if (!mapped_)
+		return;
+
+	fences_[region_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	region_ = (region_ + 1) % REGION_COUNT;
+}
+
+void StreamingBuffer::Allocate(const size_t regionBytes)
+{
+	for (size_t region = 0; region < REGION_COUNT; ++region)
+		Wait(region);
+
+	if (buffer_)
+	{
+		glBindBuffer(target_, buffer_);
+		if (mapped_)
+			glUnmapBuffer(target_);
+		glDeleteBuffers(1, &buffer_);
+		mapped_ = nullptr;
+	}
+
+	regionBytes_ = (regionBytes + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+	region_ = 0;
+
+	glGenBuffers(1, &buffer_);
+	glBindBuffer(target_, buffer_);
+
+	if (bufferStorage_)
+	{
+		// immutable storage is mapped once and stays mapped while the GPU reads from it
+		const GLsizeiptr size = static_cast<GLsizeiptr>(REGION_COUNT * regionBytes_);
+		bufferStorage_(target_, size, nullptr, PERSISTENT_FLAGS);
+		mapped_ = static_cast<char *>(glMapBufferRange(target_, 0, size, PERSISTENT_FLAGS));
+		if (mapped_)
+			return;
+
+		glDeleteBuffers(1, &buffer_);
+		glGenBuffers(1, &buffer_);
+		glBindBuffer(target_, buffer_);
+		bufferStorage_ = nullptr;
+	}
+
+	glBufferData(target_, regionBytes_, nullptr, GL_STREAM_DRAW);
+	staging_.resize(regionBytes_);
+}
+
+void StreamingBuffer::Wait(const size_t region)
+{
+	GLsync &fence = fences_[region];
+	if (!fence)
+		return;
+
+	GLenum status = GL_TIMEOUT_EXPIRED;
+	do
+		status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+	while (status == GL_TIMEOUT_EXPIRED);
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}